@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "BlockCoordsTest"
+  "BlockCoordsTest.pdb"
+  "CMakeFiles/BlockCoordsTest.dir/test/blockcoordstest.cpp.o"
+  "CMakeFiles/BlockCoordsTest.dir/test/blockcoordstest.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/BlockCoordsTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/LocalAlignmentTest.dir/localalignment.cpp.o"
+  "CMakeFiles/LocalAlignmentTest.dir/localalignment.cpp.o.d"
+  "CMakeFiles/LocalAlignmentTest.dir/test/localalignmenttest.cpp.o"
+  "CMakeFiles/LocalAlignmentTest.dir/test/localalignmenttest.cpp.o.d"
+  "LocalAlignmentTest"
+  "LocalAlignmentTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/LocalAlignmentTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
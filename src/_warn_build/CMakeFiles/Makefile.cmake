@@ -0,0 +1,91 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/src/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/root/repo/src/libdivsufsort-2.0.1/CMakeLists.txt"
+  "/root/repo/src/libdivsufsort-2.0.1/CMakeModules/AppendCompilerFlags.cmake"
+  "/root/repo/src/libdivsufsort-2.0.1/CMakeModules/CheckFunctionKeywords.cmake"
+  "/root/repo/src/libdivsufsort-2.0.1/CMakeModules/CheckLFS.cmake"
+  "/root/repo/src/libdivsufsort-2.0.1/CMakeModules/ProjectCPack.cmake"
+  "/root/repo/src/libdivsufsort-2.0.1/include/CMakeLists.txt"
+  "/root/repo/src/libdivsufsort-2.0.1/include/config.h.cmake"
+  "/root/repo/src/libdivsufsort-2.0.1/include/divsufsort.h.cmake"
+  "/root/repo/src/libdivsufsort-2.0.1/lib/CMakeLists.txt"
+  "/root/repo/src/libdivsufsort-2.0.1/pkgconfig/CMakeLists.txt"
+  "/root/repo/src/libdivsufsort-2.0.1/pkgconfig/libdivsufsort.pc.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeParseImplicitLinkInfo.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CPack.cmake"
+  "/usr/share/cmake-3.25/Modules/CPackComponent.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCXXSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFile.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFileCXX.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckSymbolExists.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckTypeSize.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindOpenMP.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindZLIB.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  "/usr/share/cmake-3.25/Modules/SelectLibraryConfigurations.cmake"
+  "/usr/share/cmake-3.25/Templates/CPackConfig.cmake.in"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "CPackConfig.cmake"
+  "CPackSourceConfig.cmake"
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  "CPackConfig.cmake"
+  "CPackSourceConfig.cmake"
+  "libdivsufsort-2.0.1/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "libdivsufsort-2.0.1/pkgconfig/libdivsufsort.pc"
+  "libdivsufsort-2.0.1/pkgconfig/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "libdivsufsort-2.0.1/include/config.h"
+  "libdivsufsort-2.0.1/include/divsufsort.h"
+  "libdivsufsort-2.0.1/include/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "libdivsufsort-2.0.1/lib/CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "CMakeFiles/Sibelia.dir/DependInfo.cmake"
+  "CMakeFiles/LocalAlignmentTest.dir/DependInfo.cmake"
+  "CMakeFiles/PostprocessorTest.dir/DependInfo.cmake"
+  "CMakeFiles/BlockCoordsTest.dir/DependInfo.cmake"
+  "CMakeFiles/sibelia_bench.dir/DependInfo.cmake"
+  "libdivsufsort-2.0.1/lib/CMakeFiles/divsufsort.dir/DependInfo.cmake"
+  )
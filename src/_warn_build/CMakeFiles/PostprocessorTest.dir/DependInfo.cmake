@@ -0,0 +1,24 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/blockinstance.cpp" "CMakeFiles/PostprocessorTest.dir/blockinstance.cpp.o" "gcc" "CMakeFiles/PostprocessorTest.dir/blockinstance.cpp.o.d"
+  "/root/repo/src/dnasequence.cpp" "CMakeFiles/PostprocessorTest.dir/dnasequence.cpp.o" "gcc" "CMakeFiles/PostprocessorTest.dir/dnasequence.cpp.o.d"
+  "/root/repo/src/localalignment.cpp" "CMakeFiles/PostprocessorTest.dir/localalignment.cpp.o" "gcc" "CMakeFiles/PostprocessorTest.dir/localalignment.cpp.o.d"
+  "/root/repo/src/postprocessor.cpp" "CMakeFiles/PostprocessorTest.dir/postprocessor.cpp.o" "gcc" "CMakeFiles/PostprocessorTest.dir/postprocessor.cpp.o.d"
+  "/root/repo/src/stranditerator.cpp" "CMakeFiles/PostprocessorTest.dir/stranditerator.cpp.o" "gcc" "CMakeFiles/PostprocessorTest.dir/stranditerator.cpp.o.d"
+  "/root/repo/src/test/postprocessortest.cpp" "CMakeFiles/PostprocessorTest.dir/test/postprocessortest.cpp.o" "gcc" "CMakeFiles/PostprocessorTest.dir/test/postprocessortest.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,21 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/PostprocessorTest.dir/blockinstance.cpp.o"
+  "CMakeFiles/PostprocessorTest.dir/blockinstance.cpp.o.d"
+  "CMakeFiles/PostprocessorTest.dir/dnasequence.cpp.o"
+  "CMakeFiles/PostprocessorTest.dir/dnasequence.cpp.o.d"
+  "CMakeFiles/PostprocessorTest.dir/localalignment.cpp.o"
+  "CMakeFiles/PostprocessorTest.dir/localalignment.cpp.o.d"
+  "CMakeFiles/PostprocessorTest.dir/postprocessor.cpp.o"
+  "CMakeFiles/PostprocessorTest.dir/postprocessor.cpp.o.d"
+  "CMakeFiles/PostprocessorTest.dir/stranditerator.cpp.o"
+  "CMakeFiles/PostprocessorTest.dir/stranditerator.cpp.o.d"
+  "CMakeFiles/PostprocessorTest.dir/test/postprocessortest.cpp.o"
+  "CMakeFiles/PostprocessorTest.dir/test/postprocessortest.cpp.o.d"
+  "PostprocessorTest"
+  "PostprocessorTest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/PostprocessorTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
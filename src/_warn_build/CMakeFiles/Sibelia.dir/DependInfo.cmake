@@ -0,0 +1,51 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/alignmentcache.cpp" "CMakeFiles/Sibelia.dir/alignmentcache.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/alignmentcache.cpp.o.d"
+  "/root/repo/src/bifurcationstorage.cpp" "CMakeFiles/Sibelia.dir/bifurcationstorage.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/bifurcationstorage.cpp.o.d"
+  "/root/repo/src/blockaligner.cpp" "CMakeFiles/Sibelia.dir/blockaligner.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/blockaligner.cpp.o.d"
+  "/root/repo/src/blockfinder.cpp" "CMakeFiles/Sibelia.dir/blockfinder.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/blockfinder.cpp.o.d"
+  "/root/repo/src/blockinstance.cpp" "CMakeFiles/Sibelia.dir/blockinstance.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/blockinstance.cpp.o.d"
+  "/root/repo/src/bulgeremoval.cpp" "CMakeFiles/Sibelia.dir/bulgeremoval.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/bulgeremoval.cpp.o.d"
+  "/root/repo/src/checkpoint.cpp" "CMakeFiles/Sibelia.dir/checkpoint.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/checkpoint.cpp.o.d"
+  "/root/repo/src/coverage.cpp" "CMakeFiles/Sibelia.dir/coverage.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/coverage.cpp.o.d"
+  "/root/repo/src/dnasequence.cpp" "CMakeFiles/Sibelia.dir/dnasequence.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/dnasequence.cpp.o.d"
+  "/root/repo/src/edge.cpp" "CMakeFiles/Sibelia.dir/edge.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/edge.cpp.o.d"
+  "/root/repo/src/fasta.cpp" "CMakeFiles/Sibelia.dir/fasta.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/fasta.cpp.o.d"
+  "/root/repo/src/hierarchy.cpp" "CMakeFiles/Sibelia.dir/hierarchy.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/hierarchy.cpp.o.d"
+  "/root/repo/src/indexedsequence.cpp" "CMakeFiles/Sibelia.dir/indexedsequence.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/indexedsequence.cpp.o.d"
+  "/root/repo/src/lagan/src/libchaos.cpp" "CMakeFiles/Sibelia.dir/lagan/src/libchaos.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/lagan/src/libchaos.cpp.o.d"
+  "/root/repo/src/lagan/src/libmlagan.cpp" "CMakeFiles/Sibelia.dir/lagan/src/libmlagan.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/lagan/src/libmlagan.cpp.o.d"
+  "/root/repo/src/lagan/src/liborder.cpp" "CMakeFiles/Sibelia.dir/lagan/src/liborder.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/lagan/src/liborder.cpp.o.d"
+  "/root/repo/src/lagan/src/librechaos.cpp" "CMakeFiles/Sibelia.dir/lagan/src/librechaos.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/lagan/src/librechaos.cpp.o.d"
+  "/root/repo/src/localalignment.cpp" "CMakeFiles/Sibelia.dir/localalignment.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/localalignment.cpp.o.d"
+  "/root/repo/src/outputgenerator.cpp" "CMakeFiles/Sibelia.dir/outputgenerator.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/outputgenerator.cpp.o.d"
+  "/root/repo/src/platform.cpp" "CMakeFiles/Sibelia.dir/platform.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/platform.cpp.o.d"
+  "/root/repo/src/postprocessor.cpp" "CMakeFiles/Sibelia.dir/postprocessor.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/postprocessor.cpp.o.d"
+  "/root/repo/src/profiler.cpp" "CMakeFiles/Sibelia.dir/profiler.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/profiler.cpp.o.d"
+  "/root/repo/src/resource.cpp" "CMakeFiles/Sibelia.dir/resource.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/resource.cpp.o.d"
+  "/root/repo/src/sequencewriter.cpp" "CMakeFiles/Sibelia.dir/sequencewriter.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/sequencewriter.cpp.o.d"
+  "/root/repo/src/serialization.cpp" "CMakeFiles/Sibelia.dir/serialization.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/serialization.cpp.o.d"
+  "/root/repo/src/sibelia.cpp" "CMakeFiles/Sibelia.dir/sibelia.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/sibelia.cpp.o.d"
+  "/root/repo/src/stranditerator.cpp" "CMakeFiles/Sibelia.dir/stranditerator.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/stranditerator.cpp.o.d"
+  "/root/repo/src/synteny.cpp" "CMakeFiles/Sibelia.dir/synteny.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/synteny.cpp.o.d"
+  "/root/repo/src/test/unrolledlisttest.cpp" "CMakeFiles/Sibelia.dir/test/unrolledlisttest.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/test/unrolledlisttest.cpp.o.d"
+  "/root/repo/src/util.cpp" "CMakeFiles/Sibelia.dir/util.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/util.cpp.o.d"
+  "/root/repo/src/variantcaller.cpp" "CMakeFiles/Sibelia.dir/variantcaller.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/variantcaller.cpp.o.d"
+  "/root/repo/src/vertexenumeration.cpp" "CMakeFiles/Sibelia.dir/vertexenumeration.cpp.o" "gcc" "CMakeFiles/Sibelia.dir/vertexenumeration.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/src/_warn_build/libdivsufsort-2.0.1/lib/CMakeFiles/divsufsort.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
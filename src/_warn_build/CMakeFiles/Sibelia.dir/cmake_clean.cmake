@@ -0,0 +1,73 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/Sibelia.dir/alignmentcache.cpp.o"
+  "CMakeFiles/Sibelia.dir/alignmentcache.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/bifurcationstorage.cpp.o"
+  "CMakeFiles/Sibelia.dir/bifurcationstorage.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/blockaligner.cpp.o"
+  "CMakeFiles/Sibelia.dir/blockaligner.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/blockfinder.cpp.o"
+  "CMakeFiles/Sibelia.dir/blockfinder.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/blockinstance.cpp.o"
+  "CMakeFiles/Sibelia.dir/blockinstance.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/bulgeremoval.cpp.o"
+  "CMakeFiles/Sibelia.dir/bulgeremoval.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/checkpoint.cpp.o"
+  "CMakeFiles/Sibelia.dir/checkpoint.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/coverage.cpp.o"
+  "CMakeFiles/Sibelia.dir/coverage.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/dnasequence.cpp.o"
+  "CMakeFiles/Sibelia.dir/dnasequence.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/edge.cpp.o"
+  "CMakeFiles/Sibelia.dir/edge.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/fasta.cpp.o"
+  "CMakeFiles/Sibelia.dir/fasta.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/hierarchy.cpp.o"
+  "CMakeFiles/Sibelia.dir/hierarchy.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/indexedsequence.cpp.o"
+  "CMakeFiles/Sibelia.dir/indexedsequence.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/lagan/src/libchaos.cpp.o"
+  "CMakeFiles/Sibelia.dir/lagan/src/libchaos.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/lagan/src/libmlagan.cpp.o"
+  "CMakeFiles/Sibelia.dir/lagan/src/libmlagan.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/lagan/src/liborder.cpp.o"
+  "CMakeFiles/Sibelia.dir/lagan/src/liborder.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/lagan/src/librechaos.cpp.o"
+  "CMakeFiles/Sibelia.dir/lagan/src/librechaos.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/localalignment.cpp.o"
+  "CMakeFiles/Sibelia.dir/localalignment.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/outputgenerator.cpp.o"
+  "CMakeFiles/Sibelia.dir/outputgenerator.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/platform.cpp.o"
+  "CMakeFiles/Sibelia.dir/platform.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/postprocessor.cpp.o"
+  "CMakeFiles/Sibelia.dir/postprocessor.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/profiler.cpp.o"
+  "CMakeFiles/Sibelia.dir/profiler.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/resource.cpp.o"
+  "CMakeFiles/Sibelia.dir/resource.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/sequencewriter.cpp.o"
+  "CMakeFiles/Sibelia.dir/sequencewriter.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/serialization.cpp.o"
+  "CMakeFiles/Sibelia.dir/serialization.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/sibelia.cpp.o"
+  "CMakeFiles/Sibelia.dir/sibelia.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/stranditerator.cpp.o"
+  "CMakeFiles/Sibelia.dir/stranditerator.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/synteny.cpp.o"
+  "CMakeFiles/Sibelia.dir/synteny.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/test/unrolledlisttest.cpp.o"
+  "CMakeFiles/Sibelia.dir/test/unrolledlisttest.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/util.cpp.o"
+  "CMakeFiles/Sibelia.dir/util.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/variantcaller.cpp.o"
+  "CMakeFiles/Sibelia.dir/variantcaller.cpp.o.d"
+  "CMakeFiles/Sibelia.dir/vertexenumeration.cpp.o"
+  "CMakeFiles/Sibelia.dir/vertexenumeration.cpp.o.d"
+  "Sibelia"
+  "Sibelia.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/Sibelia.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,52 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/alignmentcache.cpp" "CMakeFiles/sibelia_bench.dir/alignmentcache.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/alignmentcache.cpp.o.d"
+  "/root/repo/src/bifurcationstorage.cpp" "CMakeFiles/sibelia_bench.dir/bifurcationstorage.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/bifurcationstorage.cpp.o.d"
+  "/root/repo/src/blockaligner.cpp" "CMakeFiles/sibelia_bench.dir/blockaligner.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/blockaligner.cpp.o.d"
+  "/root/repo/src/blockfinder.cpp" "CMakeFiles/sibelia_bench.dir/blockfinder.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/blockfinder.cpp.o.d"
+  "/root/repo/src/blockinstance.cpp" "CMakeFiles/sibelia_bench.dir/blockinstance.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/blockinstance.cpp.o.d"
+  "/root/repo/src/bulgeremoval.cpp" "CMakeFiles/sibelia_bench.dir/bulgeremoval.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/bulgeremoval.cpp.o.d"
+  "/root/repo/src/checkpoint.cpp" "CMakeFiles/sibelia_bench.dir/checkpoint.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/checkpoint.cpp.o.d"
+  "/root/repo/src/coverage.cpp" "CMakeFiles/sibelia_bench.dir/coverage.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/coverage.cpp.o.d"
+  "/root/repo/src/dnasequence.cpp" "CMakeFiles/sibelia_bench.dir/dnasequence.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/dnasequence.cpp.o.d"
+  "/root/repo/src/edge.cpp" "CMakeFiles/sibelia_bench.dir/edge.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/edge.cpp.o.d"
+  "/root/repo/src/fasta.cpp" "CMakeFiles/sibelia_bench.dir/fasta.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/fasta.cpp.o.d"
+  "/root/repo/src/hierarchy.cpp" "CMakeFiles/sibelia_bench.dir/hierarchy.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/hierarchy.cpp.o.d"
+  "/root/repo/src/indexedsequence.cpp" "CMakeFiles/sibelia_bench.dir/indexedsequence.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/indexedsequence.cpp.o.d"
+  "/root/repo/src/lagan/src/libchaos.cpp" "CMakeFiles/sibelia_bench.dir/lagan/src/libchaos.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/lagan/src/libchaos.cpp.o.d"
+  "/root/repo/src/lagan/src/libmlagan.cpp" "CMakeFiles/sibelia_bench.dir/lagan/src/libmlagan.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/lagan/src/libmlagan.cpp.o.d"
+  "/root/repo/src/lagan/src/liborder.cpp" "CMakeFiles/sibelia_bench.dir/lagan/src/liborder.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/lagan/src/liborder.cpp.o.d"
+  "/root/repo/src/lagan/src/librechaos.cpp" "CMakeFiles/sibelia_bench.dir/lagan/src/librechaos.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/lagan/src/librechaos.cpp.o.d"
+  "/root/repo/src/localalignment.cpp" "CMakeFiles/sibelia_bench.dir/localalignment.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/localalignment.cpp.o.d"
+  "/root/repo/src/outputgenerator.cpp" "CMakeFiles/sibelia_bench.dir/outputgenerator.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/outputgenerator.cpp.o.d"
+  "/root/repo/src/platform.cpp" "CMakeFiles/sibelia_bench.dir/platform.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/platform.cpp.o.d"
+  "/root/repo/src/postprocessor.cpp" "CMakeFiles/sibelia_bench.dir/postprocessor.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/postprocessor.cpp.o.d"
+  "/root/repo/src/profiler.cpp" "CMakeFiles/sibelia_bench.dir/profiler.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/profiler.cpp.o.d"
+  "/root/repo/src/resource.cpp" "CMakeFiles/sibelia_bench.dir/resource.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/resource.cpp.o.d"
+  "/root/repo/src/sequencewriter.cpp" "CMakeFiles/sibelia_bench.dir/sequencewriter.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/sequencewriter.cpp.o.d"
+  "/root/repo/src/serialization.cpp" "CMakeFiles/sibelia_bench.dir/serialization.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/serialization.cpp.o.d"
+  "/root/repo/src/stranditerator.cpp" "CMakeFiles/sibelia_bench.dir/stranditerator.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/stranditerator.cpp.o.d"
+  "/root/repo/src/synteny.cpp" "CMakeFiles/sibelia_bench.dir/synteny.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/synteny.cpp.o.d"
+  "/root/repo/src/test/benchmark.cpp" "CMakeFiles/sibelia_bench.dir/test/benchmark.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/test/benchmark.cpp.o.d"
+  "/root/repo/src/test/syntheticgenome.cpp" "CMakeFiles/sibelia_bench.dir/test/syntheticgenome.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/test/syntheticgenome.cpp.o.d"
+  "/root/repo/src/test/unrolledlisttest.cpp" "CMakeFiles/sibelia_bench.dir/test/unrolledlisttest.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/test/unrolledlisttest.cpp.o.d"
+  "/root/repo/src/util.cpp" "CMakeFiles/sibelia_bench.dir/util.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/util.cpp.o.d"
+  "/root/repo/src/variantcaller.cpp" "CMakeFiles/sibelia_bench.dir/variantcaller.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/variantcaller.cpp.o.d"
+  "/root/repo/src/vertexenumeration.cpp" "CMakeFiles/sibelia_bench.dir/vertexenumeration.cpp.o" "gcc" "CMakeFiles/sibelia_bench.dir/vertexenumeration.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/src/_warn_build/libdivsufsort-2.0.1/lib/CMakeFiles/divsufsort.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,75 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/sibelia_bench.dir/alignmentcache.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/alignmentcache.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/bifurcationstorage.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/bifurcationstorage.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/blockaligner.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/blockaligner.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/blockfinder.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/blockfinder.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/blockinstance.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/blockinstance.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/bulgeremoval.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/bulgeremoval.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/checkpoint.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/checkpoint.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/coverage.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/coverage.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/dnasequence.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/dnasequence.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/edge.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/edge.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/fasta.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/fasta.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/hierarchy.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/hierarchy.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/indexedsequence.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/indexedsequence.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/lagan/src/libchaos.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/lagan/src/libchaos.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/lagan/src/libmlagan.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/lagan/src/libmlagan.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/lagan/src/liborder.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/lagan/src/liborder.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/lagan/src/librechaos.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/lagan/src/librechaos.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/localalignment.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/localalignment.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/outputgenerator.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/outputgenerator.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/platform.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/platform.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/postprocessor.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/postprocessor.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/profiler.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/profiler.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/resource.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/resource.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/sequencewriter.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/sequencewriter.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/serialization.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/serialization.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/stranditerator.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/stranditerator.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/synteny.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/synteny.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/test/benchmark.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/test/benchmark.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/test/syntheticgenome.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/test/syntheticgenome.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/test/unrolledlisttest.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/test/unrolledlisttest.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/util.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/util.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/variantcaller.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/variantcaller.cpp.o.d"
+  "CMakeFiles/sibelia_bench.dir/vertexenumeration.cpp.o"
+  "CMakeFiles/sibelia_bench.dir/vertexenumeration.cpp.o.d"
+  "sibelia_bench"
+  "sibelia_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/sibelia_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,15 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/src
+# Build directory: /root/repo/src/_warn_build
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(LocalAlignmentTest "LocalAlignmentTest")
+set_tests_properties(LocalAlignmentTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/CMakeLists.txt;36;add_test;/root/repo/src/CMakeLists.txt;0;")
+add_test(PostprocessorTest "PostprocessorTest")
+set_tests_properties(PostprocessorTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/CMakeLists.txt;38;add_test;/root/repo/src/CMakeLists.txt;0;")
+add_test(BlockCoordsOutput "/root/repo/src/_warn_build/Sibelia" "-s" "loose" "-q" "--binarycoords" "-o" "/root/repo/src/_warn_build/blockcoordstest" "/root/repo/src/../examples/Sibelia/Helicobacter_pylori/Helicobacter_pylori.fasta")
+set_tests_properties(BlockCoordsOutput PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/CMakeLists.txt;40;add_test;/root/repo/src/CMakeLists.txt;0;")
+add_test(BlockCoordsTest "/root/repo/src/_warn_build/BlockCoordsTest" "/root/repo/src/_warn_build/blockcoordstest")
+set_tests_properties(BlockCoordsTest PROPERTIES  DEPENDS "BlockCoordsOutput" _BACKTRACE_TRIPLES "/root/repo/src/CMakeLists.txt;41;add_test;/root/repo/src/CMakeLists.txt;0;")
+subdirs("libdivsufsort-2.0.1")
@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/libdivsufsort-2.0.1/lib/divsufsort.c" "libdivsufsort-2.0.1/lib/CMakeFiles/divsufsort.dir/divsufsort.o" "gcc" "libdivsufsort-2.0.1/lib/CMakeFiles/divsufsort.dir/divsufsort.o.d"
+  "/root/repo/src/libdivsufsort-2.0.1/lib/sssort.c" "libdivsufsort-2.0.1/lib/CMakeFiles/divsufsort.dir/sssort.o" "gcc" "libdivsufsort-2.0.1/lib/CMakeFiles/divsufsort.dir/sssort.o.d"
+  "/root/repo/src/libdivsufsort-2.0.1/lib/trsort.c" "libdivsufsort-2.0.1/lib/CMakeFiles/divsufsort.dir/trsort.o" "gcc" "libdivsufsort-2.0.1/lib/CMakeFiles/divsufsort.dir/trsort.o.d"
+  "/root/repo/src/libdivsufsort-2.0.1/lib/utils.c" "libdivsufsort-2.0.1/lib/CMakeFiles/divsufsort.dir/utils.o" "gcc" "libdivsufsort-2.0.1/lib/CMakeFiles/divsufsort.dir/utils.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,17 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/divsufsort.dir/divsufsort.o"
+  "CMakeFiles/divsufsort.dir/divsufsort.o.d"
+  "CMakeFiles/divsufsort.dir/sssort.o"
+  "CMakeFiles/divsufsort.dir/sssort.o.d"
+  "CMakeFiles/divsufsort.dir/trsort.o"
+  "CMakeFiles/divsufsort.dir/trsort.o.d"
+  "CMakeFiles/divsufsort.dir/utils.o"
+  "CMakeFiles/divsufsort.dir/utils.o.d"
+  "libdivsufsort.a"
+  "libdivsufsort.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/divsufsort.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
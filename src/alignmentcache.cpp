@@ -0,0 +1,340 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#include "platform.h"
+#include "alignmentcache.h"
+
+#ifdef _OPENMP
+	#include <omp.h>
+#endif
+
+namespace SyntenyFinder
+{
+	namespace
+	{
+		//Layout of an entry (native byte order):
+		//	char[8]  magic
+		//	uint64_t number of rows N
+		//	N times:
+		//		uint64_t index of the instance of the row
+		//		uint64_t length of the row L
+		//		uint64_t number of gap runs R
+		//		R pairs of uint64_t: position of the run in the row, length of the run
+		//Rows that aren't their sequences with gaps inserted are not stored.
+		const char PAIRWISE_ALIGNER[] = "LAGAN 2.0 lagan.pl -mfa";
+		const char MULTIPLE_ALIGNER[] = "LAGAN 2.0 mlagan";
+		const size_t TREE_NAME_LENGTH = 256;
+		const char GAP = '-';
+
+		//Two independent 64-bit lanes, FNV-1a and a multiplicative one, so the
+		//key is 128 bits wide
+		class KeyHash
+		{
+		public:
+			KeyHash(): first_(14695981039346656037ULL), second_(0x243F6A8885A308D3ULL) {}
+			void Update(const char * ptr, size_t size)
+			{
+				for(size_t i = 0; i < size; i++)
+				{
+					uint64_t ch = static_cast<unsigned char>(ptr[i]);
+					first_ = (first_ ^ ch) * 1099511628211ULL;
+					second_ = (second_ + ch + 1) * 0xFF51AFD7ED558CCDULL;
+					second_ ^= second_ >> 29;
+				}
+			}
+
+			void Update(uint64_t value)
+			{
+				Update(reinterpret_cast<const char*>(&value), sizeof(value));
+			}
+
+			void Update(const std::string & str)
+			{
+				Update(str.size());
+				Update(str.data(), str.size());
+			}
+
+			std::string GetHex() const
+			{
+				std::stringstream ss;
+				ss << std::hex << std::setfill('0') << std::setw(16) << first_ << std::setw(16) << second_;
+				return ss.str();
+			}
+
+		private:
+			uint64_t first_;
+			uint64_t second_;
+		};
+
+		void CheckedWrite(const void * ptr, size_t size, size_t count, FILE * handle, bool & ok)
+		{
+			ok = ok && (count == 0 || fwrite(ptr, size, count, handle) == count);
+		}
+
+		bool ReadValue(FILE * handle, uint64_t & value)
+		{
+			return fread(&value, sizeof(value), 1, handle) == 1;
+		}
+
+		bool CompareByModified(const FileStatus & a, const FileStatus & b)
+		{
+			return a.modified < b.modified;
+		}
+
+		int ThreadNumber()
+		{
+		#ifdef _OPENMP
+			return omp_get_thread_num();
+		#else
+			return 0;
+		#endif
+		}
+	}
+
+	const char AlignmentCache::ENTRY_MAGIC[8] = {'S', 'I', 'B', 'A', 'L', 'N', '0', '1'};
+	const std::string AlignmentCache::ENTRY_SUFFIX = ".aln";
+
+	AlignmentCache::AlignmentCache(const std::string & directory, uint64_t maxSize): directory_(directory), maxSize_(maxSize), hits_(0), misses_(0)
+	{
+		CreateOutDirectory(directory_);
+	}
+
+	size_t AlignmentCache::GetHits() const
+	{
+		return hits_;
+	}
+
+	size_t AlignmentCache::GetMisses() const
+	{
+		return misses_;
+	}
+
+	bool AlignmentCache::NamesMatter(const std::vector<std::string> & name)
+	{
+		//mlagan writes the guide tree with the first words of the names, skips other
+		//characters before a word and looks the word up as a substring of the names.
+		//The names don't change the alignment unless a word is found in another name
+		for(size_t i = 0; i < name.size(); i++)
+		{
+			size_t start = 0;
+			for(; start < name[i].size() && !isalnum(static_cast<unsigned char>(name[i][start])); start++)
+			{
+				if(isspace(static_cast<unsigned char>(name[i][start])) || name[i][start] == '(' || name[i][start] == ')')
+				{
+					return true;
+				}
+			}
+
+			size_t end = start;
+			for(; end < name[i].size() && !isspace(static_cast<unsigned char>(name[i][end])); end++)
+			{
+				if(name[i][end] == '(' || name[i][end] == ')')
+				{
+					return true;
+				}
+			}
+
+			std::string word = name[i].substr(start, end - start);
+			if(word.empty() || word.size() >= TREE_NAME_LENGTH)
+			{
+				return true;
+			}
+
+			for(size_t j = 0; j < i; j++)
+			{
+				if(name[j].find(word) != std::string::npos)
+				{
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	std::string AlignmentCache::EntryPath(bool pairwise, const std::vector<std::string> & sequence, const std::vector<std::string> & name) const
+	{
+		KeyHash hash;
+		hash.Update(std::string(pairwise ? PAIRWISE_ALIGNER : MULTIPLE_ALIGNER));
+		hash.Update(sequence.size());
+		for(size_t i = 0; i < sequence.size(); i++)
+		{
+			hash.Update(sequence[i]);
+		}
+
+		bool names = !pairwise && NamesMatter(name);
+		hash.Update(static_cast<uint64_t>(names));
+		for(size_t i = 0; i < name.size() && names; i++)
+		{
+			hash.Update(name[i]);
+		}
+
+		return directory_ + "/" + hash.GetHex() + ENTRY_SUFFIX;
+	}
+
+	bool AlignmentCache::Find(bool pairwise, const std::vector<std::string> & sequence, const std::vector<std::string> & name, BlockAligner::Alignment & alignment) const
+	{
+		//A damaged or foreign entry is a miss, the block is aligned and the entry rewritten
+		std::string path = EntryPath(pairwise, sequence, name);
+		FILE * handle = fopen(path.c_str(), "rb");
+		bool ok = handle != 0;
+		if(ok)
+		{
+			char magic[sizeof(ENTRY_MAGIC)];
+			uint64_t rows = 0;
+			ok = fread(magic, 1, sizeof(magic), handle) == sizeof(magic) && std::equal(magic, magic + sizeof(magic), ENTRY_MAGIC) &&
+				ReadValue(handle, rows) && rows == sequence.size();
+			alignment.order.assign(sequence.size(), 0);
+			alignment.row.assign(sequence.size(), std::string());
+			std::vector<char> used(sequence.size(), false);
+			for(size_t i = 0; i < sequence.size() && ok; i++)
+			{
+				uint64_t index = 0;
+				uint64_t length = 0;
+				uint64_t runs = 0;
+				ok = ReadValue(handle, index) && index < sequence.size() && !used[index] && ReadValue(handle, length) && ReadValue(handle, runs) &&
+					length >= sequence[index].size() && runs <= length - sequence[index].size();
+				if(ok)
+				{
+					used[index] = true;
+					alignment.order[i] = static_cast<size_t>(index);
+					std::string & now = alignment.row[i];
+					const std::string & letter = sequence[index];
+					size_t done = 0;
+					now.reserve(static_cast<size_t>(length));
+					for(uint64_t run = 0; run < runs && ok; run++)
+					{
+						uint64_t position = 0;
+						uint64_t gap = 0;
+						ok = ReadValue(handle, position) && ReadValue(handle, gap) && gap > 0 && position >= now.size() &&
+							position - now.size() <= letter.size() - done && position + gap <= length;
+						if(ok)
+						{
+							size_t copy = static_cast<size_t>(position) - now.size();
+							now.append(letter, done, copy);
+							now.append(static_cast<size_t>(gap), GAP);
+							done += copy;
+						}
+					}
+
+					if(ok)
+					{
+						ok = now.size() + letter.size() - done == length;
+						now.append(letter, done, std::string::npos);
+					}
+				}
+			}
+
+			fclose(handle);
+		}
+
+		#pragma omp critical(AlignmentCache)
+		{
+			(ok ? hits_ : misses_)++;
+		}
+
+		if(ok)
+		{
+			TouchFile(path);
+		}
+
+		return ok;
+	}
+
+	void AlignmentCache::Store(bool pairwise, const std::vector<std::string> & sequence, const std::vector<std::string> & name, const BlockAligner::Alignment & alignment) const
+	{
+		std::vector<std::vector<uint64_t> > record(alignment.row.size());
+		for(size_t i = 0; i < alignment.row.size(); i++)
+		{
+			const std::string & now = alignment.row[i];
+			const std::string & letter = sequence[alignment.order[i]];
+			size_t done = 0;
+			record[i].push_back(alignment.order[i]);
+			record[i].push_back(now.size());
+			record[i].push_back(0);
+			for(size_t pos = 0; pos < now.size(); )
+			{
+				if(now[pos] == GAP)
+				{
+					size_t end = pos;
+					for(; end < now.size() && now[end] == GAP; ++end);
+					record[i].push_back(pos);
+					record[i].push_back(end - pos);
+					record[i][2]++;
+					pos = end;
+				}
+				else if(done < letter.size() && now[pos] == letter[done])
+				{
+					pos++;
+					done++;
+				}
+				else
+				{
+					return;
+				}
+			}
+
+			if(done != letter.size())
+			{
+				return;
+			}
+		}
+
+		//Entries are written aside and renamed, so a reader never sees a partial one.
+		//The temporary name is private to the process and the thread, runs sharing
+		//the directory never write to the same file
+		std::string path = EntryPath(pairwise, sequence, name);
+		std::stringstream temp;
+		temp << path << '.' << GetPid() << '.' << ThreadNumber() << ".tmp";
+		#pragma omp critical(AlignmentCache)
+		{
+			FILE * handle = fopen(temp.str().c_str(), "wb");
+			bool ok = handle != 0;
+			if(ok)
+			{
+				uint64_t rows = record.size();
+				CheckedWrite(ENTRY_MAGIC, 1, sizeof(ENTRY_MAGIC), handle, ok);
+				CheckedWrite(&rows, sizeof(rows), 1, handle, ok);
+				for(size_t i = 0; i < record.size(); i++)
+				{
+					CheckedWrite(&record[i][0], sizeof(record[i][0]), record[i].size(), handle, ok);
+				}
+
+				ok = fclose(handle) == 0 && ok;
+			#ifdef _WIN32
+				//Only POSIX rename replaces an existing file
+				remove(path.c_str());
+			#endif
+				ok = ok && rename(temp.str().c_str(), path.c_str()) == 0;
+			}
+
+			if(!ok)
+			{
+				remove(temp.str().c_str());
+			}
+		}
+	}
+
+	void AlignmentCache::Evict() const
+	{
+		std::vector<FileStatus> entry;
+		ListFiles(directory_, ENTRY_SUFFIX, entry);
+		uint64_t total = 0;
+		for(size_t i = 0; i < entry.size(); i++)
+		{
+			total += entry[i].size;
+		}
+
+		std::sort(entry.begin(), entry.end(), CompareByModified);
+		for(size_t i = 0; i < entry.size() && total > maxSize_; i++)
+		{
+			if(remove(entry[i].path.c_str()) == 0)
+			{
+				total -= entry[i].size;
+			}
+		}
+	}
+}
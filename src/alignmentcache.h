@@ -0,0 +1,41 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#ifndef _ALIGNMENT_CACHE_H_
+#define _ALIGNMENT_CACHE_H_
+
+#include "blockaligner.h"
+
+namespace SyntenyFinder
+{
+	//On-disk cache of block alignments shared by runs. An entry is keyed by a hash of the
+	//aligner, the instance sequences and, when LAGAN's guide tree depends on them, the
+	//instance names. Rows are stored as the gaps inserted into the sequences. Entries
+	//found are touched, so eviction by the modification time drops the least recently used
+	class AlignmentCache
+	{
+	public:
+		AlignmentCache(const std::string & directory, uint64_t maxSize);
+		bool Find(bool pairwise, const std::vector<std::string> & sequence, const std::vector<std::string> & name, BlockAligner::Alignment & alignment) const;
+		void Store(bool pairwise, const std::vector<std::string> & sequence, const std::vector<std::string> & name, const BlockAligner::Alignment & alignment) const;
+		//Removes the least recently used entries until the cache fits in the maximum size
+		void Evict() const;
+		size_t GetHits() const;
+		size_t GetMisses() const;
+	private:
+		DISALLOW_COPY_AND_ASSIGN(AlignmentCache);
+		static const char ENTRY_MAGIC[8];
+		static const std::string ENTRY_SUFFIX;
+		std::string directory_;
+		uint64_t maxSize_;
+		mutable size_t hits_;
+		mutable size_t misses_;
+		std::string EntryPath(bool pairwise, const std::vector<std::string> & sequence, const std::vector<std::string> & name) const;
+		static bool NamesMatter(const std::vector<std::string> & name);
+	};
+}
+
+#endif
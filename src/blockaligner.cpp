@@ -0,0 +1,128 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#include "blockaligner.h"
+#include "alignmentcache.h"
+#include "sequencewriter.h"
+#include "lagan/src/liblagan.h"
+
+namespace SyntenyFinder
+{
+	std::string BlockAligner::InstanceName(const BlockInstance & instance)
+	{
+		std::stringstream ss;
+		ss << instance.GetChrInstance().GetDescription() << instance.GetConventionalStart() << '_' << instance.GetConventionalEnd();
+		return ss.str();
+	}
+
+	std::string BlockAligner::InstanceSequence(const BlockInstance & instance)
+	{
+		const char * start = instance.GetChrInstance().GetSequence().data() + instance.GetStart();
+		std::string ret(start, start + instance.GetLength());
+		if(instance.GetDirection() == DNASequence::negative)
+		{
+			ReverseComplement(start, start + instance.GetLength(), &ret[0]);
+		}
+
+		return ret;
+	}
+
+	void BlockAligner::AlignBlock(const Block & block, Alignment & alignment, const AlignmentCache * cache)
+	{
+		std::vector<std::string> sequence;
+		std::vector<std::string> name;
+		for(size_t i = 0; i < block.instance.size(); i++)
+		{
+			sequence.push_back(InstanceSequence(block.instance[i]));
+			name.push_back(InstanceName(block.instance[i]));
+		}
+
+		if(cache != 0 && cache->Find(block.pairwise, sequence, name, alignment))
+		{
+			return;
+		}
+
+		if(block.pairwise)
+		{
+			if(block.instance.size() != 2)
+			{
+				throw std::runtime_error("A pairwise block must have exactly two instances");
+			}
+
+			alignment.row.assign(2, std::string());
+			alignment.order.assign(1, 0);
+			alignment.order.push_back(1);
+			Lagan::AlignPair(sequence[0], sequence[1], alignment.row[0], alignment.row[1]);
+		}
+		else
+		{
+			Lagan::AlignMultiple(sequence, name, alignment.row, alignment.order);
+		}
+
+		if(cache != 0)
+		{
+			cache->Store(block.pairwise, sequence, name, alignment);
+		}
+	}
+
+	void BlockAligner::AlignBlocks(const std::vector<Block> & block, Consumer consumer, const AlignmentCache * cache)
+	{
+		//Finished alignments wait here until the alignments of all preceding blocks
+		//are passed to the consumer
+		std::string error;
+		size_t next = 0;
+		std::vector<char> done(block.size(), false);
+		std::vector<Alignment> alignment(block.size());
+		#pragma omp parallel for schedule(dynamic)
+		for(int i = 0; i < static_cast<int>(block.size()); i++)
+		{
+			std::string failure;
+			try
+			{
+				AlignBlock(block[i], alignment[i], cache);
+			}
+			catch(std::exception & e)
+			{
+				failure = e.what();
+			}
+			catch(...)
+			{
+				failure = "unknown error while aligning a block";
+			}
+
+			#pragma omp critical(BlockAligner)
+			{
+				done[i] = true;
+				if(error.empty())
+				{
+					error = failure;
+				}
+
+				try
+				{
+					for(; error.empty() && next < block.size() && done[next]; next++)
+					{
+						consumer(block[next], alignment[next]);
+						std::vector<std::string>().swap(alignment[next].row);
+					}
+				}
+				catch(std::exception & e)
+				{
+					error = e.what();
+				}
+				catch(...)
+				{
+					error = "unknown error while writing an alignment";
+				}
+			}
+		}
+
+		if(!error.empty())
+		{
+			throw std::runtime_error(error.c_str());
+		}
+	}
+}
@@ -0,0 +1,47 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#ifndef _BLOCK_ALIGNER_H_
+#define _BLOCK_ALIGNER_H_
+
+#include "blockinstance.h"
+
+namespace SyntenyFinder
+{
+	class AlignmentCache;
+
+	//Aligns synteny blocks with the LAGAN programs compiled into Sibelia. A pairwise
+	//block is aligned like "lagan.pl seq1 seq2 -mfa", others like "mlagan seq1 ... seqn"
+	//where instances are named like in C-Sibelia
+	class BlockAligner
+	{
+	public:
+		struct Block
+		{
+			bool pairwise;
+			std::vector<BlockInstance> instance;
+			Block(): pairwise(false) {}
+		};
+
+		//Rows in the order LAGAN prints them, row[i] is the alignment of instance[order[i]]
+		struct Alignment
+		{
+			std::vector<size_t> order;
+			std::vector<std::string> row;
+		};
+
+		typedef boost::function<void(const Block&, const Alignment&)> Consumer;
+		//Aligns the blocks on the OpenMP threads, each alignment is passed to the
+		//consumer as soon as the ones of the preceding blocks are passed. Blocks found
+		//in the cache aren't aligned again, the new alignments are added to it
+		static void AlignBlocks(const std::vector<Block> & block, Consumer consumer, const AlignmentCache * cache = 0);
+		static void AlignBlock(const Block & block, Alignment & alignment, const AlignmentCache * cache = 0);
+		static std::string InstanceName(const BlockInstance & instance);
+		static std::string InstanceSequence(const BlockInstance & instance);
+	};
+}
+
+#endif
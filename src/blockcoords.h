@@ -0,0 +1,306 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#ifndef _BLOCK_COORDS_H_
+#define _BLOCK_COORDS_H_
+
+//Header-only reader of the binary coordinates file ("blocks_coords.bin"). The file
+//is mapped into memory as is, so opening it costs the same for any number of blocks.
+//
+//Layout (native byte order, every section starts at an offset computable from the header):
+//	char[8]  magic "SIBCOORD"
+//	uint64_t version, number of instances N, number of sequences C, number of stages,
+//	         size of the descriptions blob
+//	uint64_t length[C]        -- lengths of the sequences
+//	uint64_t chrIndex[C + 1]  -- instances on the sequence c are [chrIndex[c], chrIndex[c + 1])
+//	uint64_t nameIndex[C + 1] -- description of the sequence c is names[nameIndex[c] .. nameIndex[c + 1])
+//	uint64_t start[N], end[N] -- 0-based half-open coordinates on the positive strand
+//	uint64_t maxEnd[N]        -- running maximum of end within the sequence
+//	uint32_t blockId[N], chrId[N], stage[N]
+//	int8_t   strand[N]        -- +1 or -1
+//	char     names[]
+//Instances are sorted by the sequence, then by start, stage and block id.
+
+#include <string>
+#include <cstring>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <boost/cstdint.hpp>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+namespace SyntenyFinder
+{
+	namespace BlockCoords
+	{
+		const char MAGIC[8] = {'S', 'I', 'B', 'C', 'O', 'O', 'R', 'D'};
+		const boost::uint64_t VERSION = 1;
+		const size_t HEADER_FIELDS = 5;
+	}
+
+	class BlockCoordsFile
+	{
+	public:
+		struct Instance
+		{
+			boost::uint32_t blockId;
+			boost::uint32_t chrId;
+			boost::uint32_t stage;
+			int strand;
+			boost::uint64_t start;
+			boost::uint64_t end;
+		};
+
+		explicit BlockCoordsFile(const std::string & fileName): data_(0), size_(0)
+		{
+			Map(fileName);
+			const char * ptr = data_;
+			if(size_ < sizeof(BlockCoords::MAGIC) + BlockCoords::HEADER_FIELDS * sizeof(boost::uint64_t) ||
+				!std::equal(BlockCoords::MAGIC, BlockCoords::MAGIC + sizeof(BlockCoords::MAGIC), ptr))
+			{
+				Fail(fileName + " is not a binary coordinates file");
+			}
+
+			const boost::uint64_t * header = reinterpret_cast<const boost::uint64_t*>(ptr + sizeof(BlockCoords::MAGIC));
+			if(header[0] != BlockCoords::VERSION)
+			{
+				Fail("Unsupported version of " + fileName);
+			}
+
+			instanceCount_ = header[1];
+			chrCount_ = header[2];
+			stageCount_ = header[3];
+			//The counts come from the file, so they are checked against its size by division
+			//before any section pointer is computed from them
+			const size_t INSTANCE_BYTES = 3 * sizeof(boost::uint64_t) + 3 * sizeof(boost::uint32_t) + sizeof(boost::int8_t);
+			size_t rest = size_ - sizeof(BlockCoords::MAGIC) - BlockCoords::HEADER_FIELDS * sizeof(boost::uint64_t);
+			if(rest / sizeof(boost::uint64_t) < 2 || chrCount_ > (rest / sizeof(boost::uint64_t) - 2) / 3)
+			{
+				Fail(fileName + " is truncated");
+			}
+
+			rest -= static_cast<size_t>(3 * chrCount_ + 2) * sizeof(boost::uint64_t);
+			if(instanceCount_ > rest / INSTANCE_BYTES || rest - static_cast<size_t>(instanceCount_) * INSTANCE_BYTES != header[4])
+			{
+				Fail(fileName + " is truncated");
+			}
+
+			length_ = header + BlockCoords::HEADER_FIELDS;
+			chrIndex_ = length_ + chrCount_;
+			nameIndex_ = chrIndex_ + chrCount_ + 1;
+			start_ = nameIndex_ + chrCount_ + 1;
+			end_ = start_ + instanceCount_;
+			maxEnd_ = end_ + instanceCount_;
+			blockId_ = reinterpret_cast<const boost::uint32_t*>(maxEnd_ + instanceCount_);
+			chrId_ = blockId_ + instanceCount_;
+			stage_ = chrId_ + instanceCount_;
+			strand_ = reinterpret_cast<const boost::int8_t*>(stage_ + instanceCount_);
+			names_ = reinterpret_cast<const char*>(strand_ + instanceCount_);
+			if(!IsIndex(chrIndex_, instanceCount_) || !IsIndex(nameIndex_, header[4]))
+			{
+				Fail(fileName + " is corrupted");
+			}
+		}
+
+		~BlockCoordsFile()
+		{
+			Unmap();
+		}
+
+		size_t GetInstanceCount() const { return static_cast<size_t>(instanceCount_); }
+		size_t GetChrCount() const { return static_cast<size_t>(chrCount_); }
+		size_t GetStageCount() const { return static_cast<size_t>(stageCount_); }
+		boost::uint64_t GetChrLength(size_t chr) const { return length_[chr]; }
+		std::string GetChrDescription(size_t chr) const { return std::string(names_ + nameIndex_[chr], names_ + nameIndex_[chr + 1]); }
+
+		//Columns, each has GetInstanceCount() elements
+		const boost::uint64_t * GetStart() const { return start_; }
+		const boost::uint64_t * GetEnd() const { return end_; }
+		const boost::uint32_t * GetBlockId() const { return blockId_; }
+		const boost::uint32_t * GetChrId() const { return chrId_; }
+		const boost::uint32_t * GetStage() const { return stage_; }
+		const boost::int8_t * GetStrand() const { return strand_; }
+
+		Instance GetInstance(size_t index) const
+		{
+			Instance ret;
+			ret.blockId = blockId_[index];
+			ret.chrId = chrId_[index];
+			ret.stage = stage_[index];
+			ret.strand = strand_[index];
+			ret.start = start_[index];
+			ret.end = end_[index];
+			return ret;
+		}
+
+		//Range of indices of the instances located on the sequence
+		std::pair<size_t, size_t> GetChrRange(size_t chr) const
+		{
+			return std::make_pair(static_cast<size_t>(chrIndex_[chr]), static_cast<size_t>(chrIndex_[chr + 1]));
+		}
+
+		//Writes indices of the instances on the sequence that overlap [start, end)
+		template<class Iterator>
+			Iterator FindOverlapping(size_t chr, boost::uint64_t start, boost::uint64_t end, Iterator out) const
+			{
+				std::pair<size_t, size_t> range = GetChrRange(chr);
+				size_t now = std::upper_bound(maxEnd_ + range.first, maxEnd_ + range.second, start) - maxEnd_;
+				for(; now < range.second && start_[now] < end; ++now)
+				{
+					if(end_[now] > start)
+					{
+						*out++ = now;
+					}
+				}
+
+				return out;
+			}
+
+	private:
+		BlockCoordsFile(const BlockCoordsFile &);
+		void operator = (const BlockCoordsFile &);
+
+		const char * data_;
+		size_t size_;
+		boost::uint64_t instanceCount_;
+		boost::uint64_t chrCount_;
+		boost::uint64_t stageCount_;
+		const boost::uint64_t * length_;
+		const boost::uint64_t * chrIndex_;
+		const boost::uint64_t * nameIndex_;
+		const boost::uint64_t * start_;
+		const boost::uint64_t * end_;
+		const boost::uint64_t * maxEnd_;
+		const boost::uint32_t * blockId_;
+		const boost::uint32_t * chrId_;
+		const boost::uint32_t * stage_;
+		const boost::int8_t * strand_;
+		const char * names_;
+	#ifdef _WIN32
+		HANDLE file_;
+		HANDLE mapping_;
+	#endif
+
+		//Ranges given by an index must split [0, total) into consecutive pieces
+		bool IsIndex(const boost::uint64_t * index, boost::uint64_t total) const
+		{
+			if(index[0] != 0 || index[chrCount_] != total)
+			{
+				return false;
+			}
+
+			for(boost::uint64_t i = 0; i < chrCount_; i++)
+			{
+				if(index[i] > index[i + 1])
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		void Fail(const std::string & message)
+		{
+			Unmap();
+			throw std::runtime_error(message.c_str());
+		}
+
+	#ifdef _WIN32
+		void Map(const std::string & fileName)
+		{
+			mapping_ = 0;
+			file_ = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+			LARGE_INTEGER size;
+			if(file_ == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_, &size))
+			{
+				Fail("Cannot open file " + fileName);
+			}
+
+			size_ = static_cast<size_t>(size.QuadPart);
+			if(size_ > 0)
+			{
+				mapping_ = CreateFileMappingA(file_, 0, PAGE_READONLY, 0, 0, 0);
+				data_ = mapping_ != 0 ? static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0)) : 0;
+				if(data_ == 0)
+				{
+					Fail("Cannot map file " + fileName);
+				}
+			}
+		}
+
+		void Unmap()
+		{
+			if(data_ != 0)
+			{
+				UnmapViewOfFile(data_);
+			}
+
+			if(mapping_ != 0)
+			{
+				CloseHandle(mapping_);
+			}
+
+			if(file_ != INVALID_HANDLE_VALUE)
+			{
+				CloseHandle(file_);
+			}
+
+			data_ = 0;
+			mapping_ = 0;
+			file_ = INVALID_HANDLE_VALUE;
+		}
+	#else
+		void Map(const std::string & fileName)
+		{
+			int handle = open(fileName.c_str(), O_RDONLY);
+			struct stat info;
+			if(handle == -1 || fstat(handle, &info) != 0)
+			{
+				if(handle != -1)
+				{
+					close(handle);
+				}
+
+				Fail("Cannot open file " + fileName);
+			}
+
+			size_ = static_cast<size_t>(info.st_size);
+			if(size_ > 0)
+			{
+				void * ptr = mmap(0, size_, PROT_READ, MAP_SHARED, handle, 0);
+				data_ = ptr != MAP_FAILED ? static_cast<const char*>(ptr) : 0;
+			}
+
+			close(handle);
+			if(size_ > 0 && data_ == 0)
+			{
+				Fail("Cannot map file " + fileName);
+			}
+		}
+
+		void Unmap()
+		{
+			if(data_ != 0)
+			{
+				munmap(const_cast<char*>(data_), size_);
+				data_ = 0;
+			}
+		}
+	#endif
+	};
+}
+
+#endif
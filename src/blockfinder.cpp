@@ -8,10 +8,7 @@
 
 namespace SyntenyFinder
 {
-	namespace
-	{
-		const size_t PROGRESS_STRIDE = 50;
-	}
+	const size_t BlockFinder::PROGRESS_STRIDE = 50;
 
 	size_t BlockFinder::SimplifyGraph(DNASequence & sequence, BifurcationStorage & bifStorage, size_t k, size_t minBranchSize, size_t maxIterations, ProgressCallBack callBack)
 	{
@@ -19,26 +16,39 @@ namespace SyntenyFinder
 		size_t totalBulges = 0;
 		size_t iterations = 0;
 		size_t totalProgress = 0;
+		size_t vertices = bifStorage.GetMaxId() + 1;
+		double startTime = GetWallClock();
 		bool anyChanges = true;
 		if(!callBack.empty())
 		{
 			callBack(totalProgress, start);
 		}
 
+		Report("bulge removal", start, k, 0, vertices * maxIterations, 0, startTime);
 		size_t threshold = (bifStorage.GetMaxId() * maxIterations) / PROGRESS_STRIDE;
 		do
 		{
 			iterations++;
+			size_t bulges = 0;
+			Profiler::Scope scope("iteration", iterations);
 			for(size_t id = 0; id <= bifStorage.GetMaxId(); id++)
 			{			
-				totalBulges += RemoveBulges(sequence, bifStorage, k, minBranchSize, id);
-				if(++count >= threshold && !callBack.empty())
+				bulges += RemoveBulges(sequence, bifStorage, k, minBranchSize, id);
+				if(++count >= threshold)
 				{
 					count = 0;
 					totalProgress = std::min(totalProgress + 1, PROGRESS_STRIDE);
-					callBack(totalProgress, run);
+					if(!callBack.empty())
+					{
+						callBack(totalProgress, run);
+					}
+
+					Report("bulge removal", run, k, (iterations - 1) * vertices + id + 1, vertices * maxIterations, totalBulges + bulges, startTime);
 				}
 			}
+
+			totalBulges += bulges;
+			Profiler::Count("bulges", bulges);
 		}
 		while((totalBulges > 0) && iterations < maxIterations);
 
@@ -47,23 +57,25 @@ namespace SyntenyFinder
 			callBack(PROGRESS_STRIDE, end);
 		}
 		
+		Report("bulge removal", end, k, iterations * vertices, iterations * vertices, totalBulges, startTime);
 		return totalBulges;
 	}
 	
 	BlockFinder::BlockFinder(const std::vector<FASTARecord> & chrList):
-		originalChrList_(&chrList)
+		version_(0), originalChrList_(&chrList), cachedEdgeValid_(false)
 	{
 		Init(chrList);
 	}
 
 	BlockFinder::BlockFinder(const std::vector<FASTARecord> & chrList, const std::string & tempDir):
-		originalChrList_(&chrList), tempDir_(tempDir)
+		tempDir_(tempDir), version_(0), originalChrList_(&chrList), cachedEdgeValid_(false)
 	{
 		Init(chrList);
 	}
 
 	void BlockFinder::Init(const std::vector<FASTARecord> & chrList)
 	{
+		fingerprint_ = InputFingerprint(chrList);
 		rawSeq_.resize(chrList.size());
 		originalPos_.resize(chrList.size());
 		for(size_t i = 0; i < originalPos_.size(); i++)
@@ -75,13 +87,101 @@ namespace SyntenyFinder
 		}
 	}
 
+	void BlockFinder::SetProgressReport(ProgressReport report)
+	{
+		report_ = report;
+	}
+
+	void BlockFinder::Report(const std::string & phase, State state, size_t k, size_t done, size_t total, size_t found, double startTime) const
+	{
+		if(!report_.empty())
+		{
+			Progress progress;
+			progress.phase = phase;
+			progress.state = state;
+			progress.k = k;
+			progress.done = done;
+			progress.total = total;
+			progress.found = found;
+			progress.seconds = GetWallClock() - startTime;
+			report_(progress);
+		}
+	}
+
+	void BlockFinder::ReleaseIndex()
+	{
+		cachedIndex_.reset();
+		ReleaseEdges();
+	}
+
+	void BlockFinder::ReleaseEdges()
+	{
+		cachedEdgeValid_ = false;
+		std::vector<Edge>().swap(cachedEdge_);
+	}
+
+	IndexedSequence& BlockFinder::GetIndexedSequence(size_t k, bool clear)
+	{
+		if(cachedIndex_.get() != 0 && cachedK_ == k && cachedVersion_ == version_)
+		{
+			//The positions are in the index already, clearing frees them as the
+			//construction with "clear" would do
+			for(size_t chr = 0; clear && chr < originalPos_.size(); chr++)
+			{
+				PosVector().swap(originalPos_[chr]);
+			}
+		}
+		else
+		{
+			ReleaseIndex();
+			size_t bases = 0;
+			for(size_t i = 0; i < rawSeq_.size(); i++)
+			{
+				bases += rawSeq_[i].size();
+			}
+
+			double startTime = GetWallClock();
+			Report("index", start, k, 0, bases, 0, startTime);
+			cachedIndex_.reset(new IndexedSequence(rawSeq_, originalPos_, k, tempDir_, clear));
+			Report("index", end, k, bases, bases, 0, startTime);
+			cachedK_ = k;
+			cachedVersion_ = version_;
+		}
+
+		return *cachedIndex_;
+	}
+
+	const std::vector<BlockFinder::Edge>& BlockFinder::GetEdges(size_t k)
+	{
+		IndexedSequence & iseq = GetIndexedSequence(k);
+		if(!cachedEdgeValid_)
+		{
+			Profiler::Scope scope("ListEdges");
+			ListEdges(iseq.Sequence(), iseq.BifStorage(), k, cachedEdge_);
+			Profiler::Count("edges", cachedEdge_.size());
+			cachedEdgeValid_ = true;
+		}
+
+		return cachedEdge_;
+	}
+
+	void BlockFinder::TakeEdges(size_t k, std::vector<Edge> & edge)
+	{
+		GetEdges(k);
+		edge.swap(cachedEdge_);
+		ReleaseEdges();
+	}
+
 	size_t BlockFinder::PerformGraphSimplifications(size_t k, size_t minBranchSize, size_t maxIterations, ProgressCallBack f)
 	{
-		IndexedSequence iseq(rawSeq_, originalPos_, k, tempDir_, true);
+		IndexedSequence & iseq = GetIndexedSequence(k, true);
+		ReleaseEdges();
 		iseq_ = &iseq;
 		DNASequence & sequence = iseq.Sequence();
 		BifurcationStorage & bifStorage = iseq.BifStorage();		
+		Profiler::Scope scope("simplification");
 		size_t ret = SimplifyGraph(sequence, bifStorage, k, minBranchSize, maxIterations, f);
+		scope.Stop();
 		for(size_t chr = 0; chr < sequence.ChrNumber(); chr++)
 		{
 			originalPos_[chr].clear();
@@ -94,6 +194,10 @@ namespace SyntenyFinder
 			}
 		}
 
+		iseq_ = 0;
+		version_++;
+		fingerprint_ = StageFingerprint(k, minBranchSize, maxIterations);
+		ReleaseIndex();
 		return ret;
 	}	
 }
\ No newline at end of file
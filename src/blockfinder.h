@@ -35,24 +35,53 @@ namespace SyntenyFinder
 			end
 		};
 
+		//Progress of a long phase. The work is counted in units of the phase: bases
+		//for "index", vertices for "bulge removal", groups of edges for "synteny blocks".
+		//"found" is the number of bulges collapsed or blocks found so far. The total of
+		//bulge removal assumes that all the iterations are made, the last report of a
+		//phase has the actual amount of work
+		struct Progress
+		{
+			std::string phase;
+			State state;
+			size_t k;
+			size_t done;
+			size_t total;
+			size_t found;
+			double seconds;
+		};
+
 		static const char SEPARATION_CHAR;
 		typedef boost::function<void(size_t, State)> ProgressCallBack;
+		typedef boost::function<void(const Progress&)> ProgressReport;
 		BlockFinder(const std::vector<FASTARecord> & chrList);
 		BlockFinder(const std::vector<FASTARecord> & chrList, const std::string & tempDir);
 		void SerializeGraph(size_t k, std::ostream & out);
 		void SerializeCondensedGraph(size_t k, std::ostream & out, ProgressCallBack f = ProgressCallBack());
 		void GenerateSyntenyBlocks(size_t k, size_t trimK, size_t minSize, std::vector<BlockInstance> & block, bool sharedOnly = false, ProgressCallBack f = ProgressCallBack());
 		size_t PerformGraphSimplifications(size_t k, size_t minBranchSize, size_t maxIterations, ProgressCallBack f = ProgressCallBack());
+		void SaveCheckpoint(const std::string & fileName) const;
+		bool LoadCheckpoint(const std::string & fileName, size_t k, size_t minBranchSize, size_t maxIterations);
+		void SetProgressReport(ProgressReport report);
+		//The index of the last k is kept for the next call with the same k, this frees it
+		void ReleaseIndex();
 	private:
 		DISALLOW_COPY_AND_ASSIGN(BlockFinder);
 		typedef std::vector<Pos> PosVector;
 		typedef std::pair<size_t, size_t> ChrPos;
 		std::string tempDir_;
 		IndexedSequence * iseq_;		
+		size_t version_;
+		uint64_t fingerprint_;
+		size_t cachedK_;
+		size_t cachedVersion_;
+		boost::scoped_ptr<IndexedSequence> cachedIndex_;
 		std::vector<std::string> rawSeq_;	
 		std::vector<size_t> originalSize_;
 		std::vector<PosVector> originalPos_;		
 		const std::vector<FASTARecord> * originalChrList_;
+		ProgressReport report_;
+		static const size_t PROGRESS_STRIDE;
 		static const char POS_FREE;
 		static const char POS_OCCUPIED;
 
@@ -99,6 +128,9 @@ namespace SyntenyFinder
 			const std::vector<Edge> * edge_;			
 		};		
 
+		bool cachedEdgeValid_;
+		std::vector<Edge> cachedEdge_;
+
 		static bool EdgeEmpty(const Edge & a, size_t k);				
 		static std::vector<size_t> EdgeToVector(const Edge & a);
 		static bool CompareEdgesNaturally(const Edge & a, const Edge & b);
@@ -108,6 +140,14 @@ namespace SyntenyFinder
 		void SpellBulges(const DNASequence & sequence, size_t k, size_t bifStart, size_t bifEnd, const std::vector<StrandIterator> & startKMer, const std::vector<VisitData> & visitData);
 		
 		void Init(const std::vector<FASTARecord> & chrList);		
+		void Report(const std::string & phase, State state, size_t k, size_t done, size_t total, size_t found, double startTime) const;
+		void ReleaseEdges();
+		uint64_t StageFingerprint(size_t k, size_t minBranchSize, size_t maxIterations) const;
+		static uint64_t InputFingerprint(const std::vector<FASTARecord> & chrList);
+		IndexedSequence& GetIndexedSequence(size_t k, bool clear = false);
+		const std::vector<Edge>& GetEdges(size_t k);
+		//Moves the edges out of the cache, for the last user of them
+		void TakeEdges(size_t k, std::vector<Edge> & edge);
 		size_t RemoveBulges(DNASequence & sequence, BifurcationStorage & bifStorage, size_t k, size_t minBranchSize, size_t bifId);		
 		void ListEdges(const DNASequence & sequence, const BifurcationStorage & bifStorage, size_t k, std::vector<Edge> & edge) const;
 		bool TrimBlocks(std::vector<Edge> & block, size_t trimK, size_t minSize);
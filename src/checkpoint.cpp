@@ -0,0 +1,213 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#include "blockfinder.h"
+
+namespace SyntenyFinder
+{
+	namespace
+	{
+		//Layout of a checkpoint (native byte order):
+		//	char[8]  magic
+		//	uint64_t fingerprint
+		//	uint64_t number of sequences N
+		//	uint64_t length of each sequence, N times
+		//	Pos      original positions of each sequence, concatenated
+		//	char     simplified sequences, concatenated
+		//All arrays start at offsets computable from the header, so the file
+		//can be mapped into memory as is.
+		const char CHECKPOINT_MAGIC[8] = {'S', 'I', 'B', 'C', 'K', 'P', 'T', '1'};
+		const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+		const uint64_t FNV_PRIME = 1099511628211ULL;
+
+		template<class Iterator>
+			uint64_t UpdateFingerprint(uint64_t hash, Iterator start, Iterator end)
+			{
+				for(; start != end; ++start)
+				{
+					hash = (hash ^ static_cast<unsigned char>(*start)) * FNV_PRIME;
+				}
+
+				return hash;
+			}
+
+		uint64_t UpdateFingerprint(uint64_t hash, uint64_t value)
+		{
+			const char * ptr = reinterpret_cast<const char*>(&value);
+			return UpdateFingerprint(hash, ptr, ptr + sizeof(value));
+		}
+
+		void CheckedWrite(const void * ptr, size_t size, size_t count, FILE * handle)
+		{
+			if(count > 0 && fwrite(ptr, size, count, handle) != count)
+			{
+				throw std::runtime_error("Error while writing a checkpoint");
+			}
+		}
+
+		bool TryRead(void * ptr, size_t size, size_t count, FILE * handle)
+		{
+			return count == 0 || fread(ptr, size, count, handle) == count;
+		}
+
+		//The array grows with the data actually read, so a damaged length runs into the
+		//end of the file instead of allocating a huge buffer
+		template<class T>
+			bool ReadArray(std::vector<T> & data, uint64_t count, FILE * handle)
+			{
+				const uint64_t CHUNK = 1 << 20;
+				data.clear();
+				for(uint64_t done = 0; done < count; )
+				{
+					size_t now = static_cast<size_t>(std::min(CHUNK, count - done));
+					data.resize(data.size() + now);
+					if(!TryRead(&data[data.size() - now], sizeof(T), now, handle))
+					{
+						return false;
+					}
+
+					done += now;
+				}
+
+				return true;
+			}
+
+		//Reads the whole checkpoint into the vectors, false if the file is not a checkpoint of
+		//the stage or is damaged. The vectors are sized by the number of sequences
+		bool ReadCheckpoint(FILE * handle, uint64_t expected, std::vector<std::vector<Pos> > & originalPos, std::vector<std::string> & rawSeq)
+		{
+			char magic[sizeof(CHECKPOINT_MAGIC)];
+			uint64_t fingerprint;
+			uint64_t chrNumber;
+			if(!TryRead(magic, sizeof(magic[0]), sizeof(magic), handle) || !std::equal(magic, magic + sizeof(magic), CHECKPOINT_MAGIC) ||
+				!TryRead(&fingerprint, sizeof(fingerprint), 1, handle) || !TryRead(&chrNumber, sizeof(chrNumber), 1, handle) ||
+				fingerprint != expected || chrNumber != rawSeq.size())
+			{
+				return false;
+			}
+
+			std::vector<uint64_t> length(rawSeq.size());
+			if(!TryRead(length.empty() ? 0 : &length[0], sizeof(length[0]), length.size(), handle))
+			{
+				return false;
+			}
+
+			for(size_t chr = 0; chr < originalPos.size(); chr++)
+			{
+				if(!ReadArray(originalPos[chr], length[chr], handle))
+				{
+					return false;
+				}
+			}
+
+			std::vector<char> buffer;
+			for(size_t chr = 0; chr < rawSeq.size(); chr++)
+			{
+				if(!ReadArray(buffer, length[chr], handle))
+				{
+					return false;
+				}
+
+				rawSeq[chr].assign(buffer.begin(), buffer.end());
+			}
+
+			return fgetc(handle) == EOF;
+		}
+	}
+
+	uint64_t BlockFinder::InputFingerprint(const std::vector<FASTARecord> & chrList)
+	{
+		uint64_t ret = UpdateFingerprint(FNV_OFFSET, chrList.size());
+		for(size_t i = 0; i < chrList.size(); i++)
+		{
+			const std::string & sequence = chrList[i].GetSequence();
+			ret = UpdateFingerprint(ret, sequence.size());
+			ret = UpdateFingerprint(ret, sequence.begin(), sequence.end());
+		}
+
+		return ret;
+	}
+
+	uint64_t BlockFinder::StageFingerprint(size_t k, size_t minBranchSize, size_t maxIterations) const
+	{
+		uint64_t ret = UpdateFingerprint(fingerprint_, k);
+		ret = UpdateFingerprint(ret, minBranchSize);
+		return UpdateFingerprint(ret, maxIterations);
+	}
+
+	void BlockFinder::SaveCheckpoint(const std::string & fileName) const
+	{
+		std::string tempName = fileName + ".tmp";
+		FILE * handle = fopen(tempName.c_str(), "wb");
+		if(handle == 0)
+		{
+			throw std::runtime_error(("Cannot open file " + tempName).c_str());
+		}
+
+		try
+		{
+			uint64_t chrNumber = rawSeq_.size();
+			CheckedWrite(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC[0]), sizeof(CHECKPOINT_MAGIC), handle);
+			CheckedWrite(&fingerprint_, sizeof(fingerprint_), 1, handle);
+			CheckedWrite(&chrNumber, sizeof(chrNumber), 1, handle);
+			for(size_t chr = 0; chr < rawSeq_.size(); chr++)
+			{
+				uint64_t length = rawSeq_[chr].size();
+				CheckedWrite(&length, sizeof(length), 1, handle);
+			}
+
+			for(size_t chr = 0; chr < originalPos_.size(); chr++)
+			{
+				CheckedWrite(originalPos_[chr].empty() ? 0 : &originalPos_[chr][0], sizeof(Pos), originalPos_[chr].size(), handle);
+			}
+
+			for(size_t chr = 0; chr < rawSeq_.size(); chr++)
+			{
+				CheckedWrite(rawSeq_[chr].data(), sizeof(char), rawSeq_[chr].size(), handle);
+			}
+		}
+		catch(...)
+		{
+			fclose(handle);
+			remove(tempName.c_str());
+			throw;
+		}
+
+		fclose(handle);
+		remove(fileName.c_str());
+		if(rename(tempName.c_str(), fileName.c_str()) != 0)
+		{
+			throw std::runtime_error(("Cannot create checkpoint " + fileName).c_str());
+		}
+	}
+
+	bool BlockFinder::LoadCheckpoint(const std::string & fileName, size_t k, size_t minBranchSize, size_t maxIterations)
+	{
+		FILE * handle = fopen(fileName.c_str(), "rb");
+		if(handle == 0)
+		{
+			return false;
+		}
+
+		//The state is replaced only by a checkpoint read completely
+		uint64_t expected = StageFingerprint(k, minBranchSize, maxIterations);
+		std::vector<PosVector> originalPos(originalPos_.size());
+		std::vector<std::string> rawSeq(rawSeq_.size());
+		bool ok = ReadCheckpoint(handle, expected, originalPos, rawSeq);
+		fclose(handle);
+		if(!ok)
+		{
+			return false;
+		}
+
+		originalPos_.swap(originalPos);
+		rawSeq_.swap(rawSeq);
+		fingerprint_ = expected;
+		version_++;
+		ReleaseIndex();
+		return true;
+	}
+}
@@ -0,0 +1,161 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#include "coverage.h"
+
+namespace SyntenyFinder
+{
+	namespace
+	{
+		struct Boundary
+		{
+			size_t pos;
+			bool open;
+			size_t degree;
+			Boundary(size_t pos, bool open, size_t degree): pos(pos), open(open), degree(degree) {}
+			bool operator < (const Boundary & toCompare) const
+			{
+				return pos < toCompare.pos;
+			}
+		};
+	}
+
+	BlockCoverage::BlockCoverage(const std::vector<FASTARecord> & chrList, const std::vector<BlockInstance> & blockList):
+		chrList_(chrList), coveredBp_(chrList.size(), 0), depth_(chrList.size())
+	{
+		std::vector<int> blockId;
+		for(size_t i = 0; i < blockList.size(); i++)
+		{
+			blockId.push_back(blockList[i].GetBlockId());
+		}
+
+		std::sort(blockId.begin(), blockId.end());
+		std::map<int, size_t> degreeIndex;
+		for(size_t now = 0; now < blockId.size(); )
+		{
+			size_t prev = now;
+			for(; now < blockId.size() && blockId[now] == blockId[prev]; now++);
+			degreeIndex[blockId[prev]] = now - prev;
+			degree_.push_back(now - prev);
+		}
+
+		std::sort(degree_.begin(), degree_.end());
+		degree_.erase(std::unique(degree_.begin(), degree_.end()), degree_.end());
+		blockCount_.assign(degree_.size(), 0);
+		degreeCoveredBp_.assign(degree_.size(), std::vector<size_t>(chrList.size(), 0));
+		for(std::map<int, size_t>::iterator it = degreeIndex.begin(); it != degreeIndex.end(); ++it)
+		{
+			it->second = DegreeIndex(it->second);
+			blockCount_[it->second]++;
+		}
+
+		std::vector<std::vector<Boundary> > boundary(chrList.size());
+		for(size_t i = 0; i < blockList.size(); i++)
+		{
+			size_t degree = degreeIndex[blockList[i].GetBlockId()];
+			boundary[blockList[i].GetChrId()].push_back(Boundary(blockList[i].GetStart(), true, degree));
+			boundary[blockList[i].GetChrId()].push_back(Boundary(blockList[i].GetEnd(), false, degree));
+		}
+
+		std::vector<size_t> open(degree_.size(), 0);
+		std::vector<size_t> active;
+		std::vector<size_t> activePos(degree_.size());
+		for(size_t chr = 0; chr < boundary.size(); chr++)
+		{
+			size_t depth = 0;
+			size_t prev = 0;
+			std::vector<Segment> & segment = depth_[chr];
+			std::sort(boundary[chr].begin(), boundary[chr].end());
+			for(std::vector<Boundary>::iterator it = boundary[chr].begin(); it != boundary[chr].end(); ++it)
+			{
+				if(it->pos > prev && depth > 0)
+				{
+					size_t length = it->pos - prev;
+					coveredBp_[chr] += length;
+					for(size_t i = 0; i < active.size(); i++)
+					{
+						degreeCoveredBp_[active[i]][chr] += length;
+					}
+
+					if(!segment.empty() && segment.back().end == prev && segment.back().depth == depth)
+					{
+						segment.back().end = it->pos;
+					}
+					else
+					{
+						segment.push_back(Segment(prev, it->pos, depth));
+					}
+				}
+
+				prev = it->pos;
+				if(it->open)
+				{
+					depth++;
+					if(open[it->degree]++ == 0)
+					{
+						activePos[it->degree] = active.size();
+						active.push_back(it->degree);
+					}
+				}
+				else
+				{
+					depth--;
+					if(--open[it->degree] == 0)
+					{
+						active[activePos[it->degree]] = active.back();
+						activePos[active.back()] = activePos[it->degree];
+						active.pop_back();
+					}
+				}
+			}
+		}
+	}
+
+	size_t BlockCoverage::DegreeIndex(size_t degree) const
+	{
+		return std::lower_bound(degree_.begin(), degree_.end(), degree) - degree_.begin();
+	}
+
+	const std::vector<size_t> & BlockCoverage::GetDegrees() const
+	{
+		return degree_;
+	}
+
+	size_t BlockCoverage::GetBlockCount(size_t degree) const
+	{
+		size_t index = DegreeIndex(degree);
+		return index < degree_.size() && degree_[index] == degree ? blockCount_[index] : 0;
+	}
+
+	size_t BlockCoverage::GetCoveredBp(size_t chr) const
+	{
+		return coveredBp_[chr];
+	}
+
+	size_t BlockCoverage::GetCoveredBp(size_t chr, size_t degree) const
+	{
+		size_t index = DegreeIndex(degree);
+		return index < degree_.size() && degree_[index] == degree ? degreeCoveredBp_[index][chr] : 0;
+	}
+
+	const std::vector<BlockCoverage::Segment> & BlockCoverage::GetDepthSegments(size_t chr) const
+	{
+		return depth_[chr];
+	}
+
+	void BlockCoverage::WriteBedGraph(std::ostream & out) const
+	{
+		out << "track type=bedGraph name=\"Sibelia\" description=\"Number of synteny block instances covering the position\"" << std::endl;
+		for(size_t chr = 0; chr < depth_.size(); chr++)
+		{
+			std::string name = chrList_[chr].GetStripedId();
+			for(std::vector<Segment>::const_iterator it = depth_[chr].begin(); it != depth_[chr].end(); ++it)
+			{
+				out << name << '\t' << it->start << '\t' << it->end << '\t' << it->depth << '\n';
+			}
+		}
+	}
+}
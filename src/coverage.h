@@ -0,0 +1,47 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#ifndef _COVERAGE_H_
+#define _COVERAGE_H_
+
+#include "blockinstance.h"
+
+namespace SyntenyFinder
+{
+	//Coverage of the sequences by synteny blocks. It is computed by a single sweep over
+	//the sorted boundaries of the instances, memory is proportional to the number of blocks.
+	class BlockCoverage
+	{
+	public:
+		struct Segment
+		{
+			size_t start;
+			size_t end;
+			size_t depth;
+			Segment(size_t start, size_t end, size_t depth): start(start), end(end), depth(depth) {}
+		};
+
+		BlockCoverage(const std::vector<FASTARecord> & chrList, const std::vector<BlockInstance> & blockList);
+		//Distinct degrees of the blocks in the ascending order
+		const std::vector<size_t> & GetDegrees() const;
+		size_t GetBlockCount(size_t degree) const;
+		size_t GetCoveredBp(size_t chr) const;
+		size_t GetCoveredBp(size_t chr, size_t degree) const;
+		//Maximal runs of positions covered by the same number of instances, zero depth is omitted
+		const std::vector<Segment> & GetDepthSegments(size_t chr) const;
+		void WriteBedGraph(std::ostream & out) const;
+	private:
+		const std::vector<FASTARecord> & chrList_;
+		std::vector<size_t> degree_;
+		std::vector<size_t> blockCount_;
+		std::vector<size_t> coveredBp_;
+		std::vector<std::vector<size_t> > degreeCoveredBp_;
+		std::vector<std::vector<Segment> > depth_;
+		size_t DegreeIndex(size_t degree) const;
+	};
+}
+
+#endif
@@ -3,9 +3,11 @@
 import re
 import os
 import sys
+import zlib
 import time
 import glob
 import shutil
+import hashlib
 import tempfile
 import argparse
 import itertools
@@ -18,6 +20,8 @@ COVER = 1
 UNCOVER = 0
 LINE_LENGTH = 60
 MINIMUM_CONTEXT_SIZE = 30
+CACHE_SUFFIX = '.mfa.z'
+ALIGNER = {True: 'LAGAN 2.0 lagan.pl -mfa', False: 'LAGAN 2.0 mlagan'}
 BLOCKS_FILE = 'blocks_sequences.fasta'
 INSTALL_DIR = os.path.dirname(os.path.abspath(__file__))
 LAGAN_DIR = os.path.join(INSTALL_DIR, '..', 'lib', 'Sibelia', 'lagan')
@@ -271,28 +275,96 @@ def find_instance(instance_list, reference_seq_id, in_reference):
 			return instance
 	return None
 
-def process_block(block):	
+def names_matter(description_list):
+	# mlagan builds the guide tree from the first words of the names and looks
+	# them up as substrings, the names matter if a word is found in another name
+	for i, description in enumerate(description_list):
+		word = re.sub('^[^0-9A-Za-z]*', '', description.split()[0]) if description.split() else ''
+		if not word or len(word) >= 256 or '(' in description.split()[0] or ')' in description.split()[0]:
+			return True
+		if [other for other in description_list[:i] if word in other]:
+			return True
+	return False
+
+def alignment_cache_file(cache_dir, unique, instance_list, description_list):
+	key = hashlib.sha1(ALIGNER[unique])
+	for block in instance_list:
+		key.update('%d\n%s' % (len(block.seq), block.seq))
+	if not unique and names_matter(description_list):
+		key.update(''.join(description + '\n' for description in description_list))
+	return os.path.join(cache_dir, key.hexdigest() + CACHE_SUFFIX)
+
+def read_alignment_cache(cache_file, instance_list):
+	# An entry is a list of "instance index<TAB>alignment row" lines, a damaged one is a miss
+	try:
+		handle = open(cache_file, 'rb')
+		data = zlib.decompress(handle.read())
+		handle.close()
+		alignment = [line.split('\t') for line in data.split('\n') if line]
+		alignment = [(int(index), body) for index, body in alignment]
+	except (EnvironmentError, zlib.error, ValueError):
+		return None
+	if sorted(index for index, _ in alignment) != range(len(instance_list)):
+		return None
+	if [index for index, body in alignment if no_gaps(body) != instance_list[index].seq]:
+		return None
+	os.utime(cache_file, None)
+	return alignment
+
+def write_alignment_cache(cache_file, alignment):
+	temp_file = cache_file + '.' + str(os.getpid())
+	handle = open(temp_file, 'wb')
+	handle.write(zlib.compress(''.join('%d\t%s\n' % (index, body) for index, body in alignment)))
+	handle.close()
+	os.rename(temp_file, cache_file)
+
+def evict_alignment_cache(cache_dir, max_size):
+	entry = []
+	for file_name in os.listdir(cache_dir):
+		if file_name.endswith(CACHE_SUFFIX):
+			stat = os.stat(os.path.join(cache_dir, file_name))
+			entry.append((stat.st_mtime, stat.st_size, os.path.join(cache_dir, file_name)))
+	entry.sort()
+	total = sum(size for _, size, _ in entry)
+	for _, size, file_name in entry:
+		if total <= max_size:
+			break
+		os.remove(file_name)
+		total -= size
+
+def process_block(block, cache_dir=None):	
 	pid = str(os.getpid()) + '_'	
 	alignment_file = pid + 'align.fasta'
 	unique, synteny_block_id, instance_list = block
 	file_name = [pid + str(i) + 'block.fasta' for i, _ in enumerate(instance_list)]	
 	mlagan_cmd = [os.path.join(LAGAN_DIR, "mlagan")] + file_name
 	lagan_cmd = ['perl', os.path.join(LAGAN_DIR, "lagan.pl")] + file_name + ['-mfa']
-	alignment_handle = open(alignment_file, 'w')
 	alignment_block = dict()
+	description_list = [block.chr_id + str(block.start) + '_' + str(block.end) for block in instance_list]
 	for index, block in enumerate(instance_list):
-		description = block.chr_id + str(block.start) + '_' + str(block.end)
+		description = description_list[index]
 		alignment_block[description] = block
 		write_fasta_records([FastaRecord(id=block.chr_id, description=description, seq=block.seq)], file_name[index])
 
-	cmd = lagan_cmd if unique else mlagan_cmd
-	worker = subprocess.Popen(cmd, stdout=alignment_handle, stderr=subprocess.PIPE)
-	_, stderr = worker.communicate()
-	if worker.returncode != 0:
-		raise FailedStartException(stderr)
-	alignment_handle.close()
-	alignment = [record for record in parse_fasta_file(alignment_file)]
-	alignment = [AlignmentRecord(body=align.seq, block_instance=alignment_block[align.description]) for align in alignment]
+	cache_file = None if cache_dir is None else alignment_cache_file(cache_dir, unique, instance_list, description_list)
+	cached = None if cache_file is None else read_alignment_cache(cache_file, instance_list)
+	if cached is None:
+		alignment_handle = open(alignment_file, 'w')
+		cmd = lagan_cmd if unique else mlagan_cmd
+		worker = subprocess.Popen(cmd, stdout=alignment_handle, stderr=subprocess.PIPE)
+		_, stderr = worker.communicate()
+		if worker.returncode != 0:
+			raise FailedStartException(stderr)
+		alignment_handle.close()
+	else:
+		write_fasta_records([FastaRecord(id=instance_list[index].chr_id, description=description_list[index], seq=body)
+							for index, body in cached], alignment_file)
+	record_list = parse_fasta_file(alignment_file)
+	alignment = [AlignmentRecord(body=align.seq, block_instance=alignment_block[align.description]) for align in record_list]
+	if cached is None and not cache_file is None:
+		row = [(description_list.index(align.description), align.seq) for align in record_list]
+		if not [index for index, body in row if no_gaps(body) != instance_list[index].seq]:
+			write_alignment_cache(cache_file, row)
 	ret = []
 	if unique:	
 		reference_instance, assembly_instance = instance_list
@@ -340,7 +412,7 @@ def depict_coverage(block_seq, reference_seq, assembly_seq, base_cover):
 def coords_key(file_name):
 	return int(file_name.split('.')[0][13:])
 
-def call_variants(directory, genomes, reference_seq, assembly_seq, min_block_size, proc_num, align):
+def call_variants(directory, genomes, reference_seq, assembly_seq, min_block_size, proc_num, align, cache_dir, cache_size):
 	os.chdir(directory)
 	coords_file_re = re.compile('blocks_coords[0-9]*.txt')
 	coords_file_list = [coords_file for coords_file in os.listdir('.') if coords_file_re.match(coords_file)]
@@ -358,7 +430,7 @@ def call_variants(directory, genomes, reference_seq, assembly_seq, min_block_siz
 		annotated_block.append((unique, synteny_block_id, instance_list))
 															
 	if annotated_block:		
-		result = pool.map_async(process_block, annotated_block).get()
+		result = pool.map_async(functools.partial(process_block, cache_dir=cache_dir), annotated_block).get()
 		variant, alignment = unzip_list(result)
 		pool.close()
 		pool.join()
@@ -369,6 +441,8 @@ def call_variants(directory, genomes, reference_seq, assembly_seq, min_block_siz
 	
 	for f in glob.glob('*block*block.anchors'):
 		os.unlink(f)
+	if not cache_dir is None:
+		evict_alignment_cache(cache_dir, cache_size)
 	
 	all_cover = None
 	for stage in blocks_coords:
@@ -520,6 +594,8 @@ parser.add_argument('-i', '--maxiterations', help='Maximum number of iterations
 parser.add_argument('--maf', help='Output file for storing alignments in MAF format')
 parser.add_argument('-v', '--variant', help='Output file with detected variants', default='variant.vcf')
 parser.add_argument('-u', '--unmapped', help='Output file for storing unmapped insertions in text format', type=str)
+parser.add_argument('--aligncache', help='Directory where alignments of synteny blocks are kept between runs')
+parser.add_argument('--aligncachesize', help='Maximum size of the alignment cache in megabytes', type=int, default=1024)
 parser.add_argument('--debug', help='Generate output in text files', action='store_true')
 group = parser.add_mutually_exclusive_group()
 group.add_argument('-t', '--tempdir', help='Directory for temporary files')
@@ -571,7 +647,13 @@ try:
 	
 	print >> sys.stderr, "Calling variants..."
 	do_alignment = (not args.maf is None)
-	variant_list, insertion_list, alignment_list = call_variants(temp_dir, genomes, reference_seq, assembly_seq, args.minblocksize, args.processcount, do_alignment)
+	cache_dir = None
+	if not args.aligncache is None:
+		cache_dir = os.path.abspath(args.aligncache)
+		if not os.path.isdir(cache_dir):
+			os.makedirs(cache_dir)
+	variant_list, insertion_list, alignment_list = call_variants(temp_dir, genomes, reference_seq, assembly_seq, args.minblocksize, args.processcount, do_alignment,
+																cache_dir, args.aligncachesize << 20)
 	variant_list.sort(key=variant_key)
 	vcf_file = args.variant if args.outdir is None else os.path.join(args.outdir, args.variant)			
 	vcf_output = open(vcf_file, 'w')
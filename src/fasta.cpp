@@ -5,63 +5,192 @@
 //****************************************************************************
 
 #include "fasta.h"
-#include <boost/algorithm/string.hpp>
+#ifdef SIBELIA_USE_ZLIB
+	#include <zlib.h>
+#endif
+#include <kseq.h>
 
 namespace SyntenyFinder
-{	
+{
 	namespace
 	{
-		class ParseException : public std::runtime_error 
+		class ParseException : public std::runtime_error
 		{
 		public:
 			ParseException(const std::string & what):
 				std::runtime_error(what)
 			{}
 		};
+
+		const int STREAM_BUFFER_SIZE = 1 << 20;
+
+	#ifdef SIBELIA_USE_ZLIB
+		//gzread reads uncompressed files as is, so every input goes through zlib
+		typedef gzFile FileHandle;
+
+		FileHandle OpenFile(const std::string & fileName)
+		{
+			return gzopen(fileName.c_str(), "rb");
+		}
+
+		void CloseFile(FileHandle handle)
+		{
+			gzclose(handle);
+		}
+
+		int ReadFile(FileHandle handle, void * buffer, int size)
+		{
+			int ret = gzread(handle, buffer, size);
+			if(ret < 0)
+			{
+				throw ParseException("read error");
+			}
+
+			return ret;
+		}
+	#else
+		typedef FILE* FileHandle;
+
+		FileHandle OpenFile(const std::string & fileName)
+		{
+			FileHandle ret = fopen(fileName.c_str(), "rb");
+			if(ret != 0)
+			{
+				int magic[] = {fgetc(ret), fgetc(ret)};
+				if(magic[0] == 0x1f && magic[1] == 0x8b)
+				{
+					fclose(ret);
+					throw std::runtime_error(("Cannot read " + fileName + ": Sibelia is built without gzip support").c_str());
+				}
+
+				rewind(ret);
+			}
+
+			return ret;
+		}
+
+		void CloseFile(FileHandle handle)
+		{
+			fclose(handle);
+		}
+
+		int ReadFile(FileHandle handle, void * buffer, int size)
+		{
+			size_t ret = fread(buffer, 1, size, handle);
+			if(ret < static_cast<size_t>(size) && ferror(handle))
+			{
+				throw ParseException("read error");
+			}
+
+			return static_cast<int>(ret);
+		}
+	#endif
+
+		KSTREAM_INIT(FileHandle, ReadFile, STREAM_BUFFER_SIZE)
+
+		struct LineStream
+		{
+		public:
+			kstream_t * stream;
+			kstring_t line;
+			LineStream(FileHandle handle): stream(ks_init(handle))
+			{
+				line.l = line.m = 0;
+				line.s = 0;
+			}
+
+			~LineStream()
+			{
+				free(line.s);
+				ks_destroy(stream);
+			}
+		};
+
+		std::string ConstructNormalizationTable()
+		{
+			const std::string VALID_CHARS = "ACGTURYKMSWBDHWNX-";
+			std::string ret(1 << (sizeof(char) * 8), 0);
+			for(size_t i = 0; i < VALID_CHARS.size(); i++)
+			{
+				ret[static_cast<unsigned char>(VALID_CHARS[i])] = VALID_CHARS[i];
+				ret[tolower(VALID_CHARS[i])] = VALID_CHARS[i];
+			}
+
+			return ret;
+		}
+
+		const std::string NORMALIZED_CHAR(ConstructNormalizationTable());
+
+		bool IsSpace(char ch)
+		{
+			return isspace(static_cast<unsigned char>(ch)) != 0;
+		}
+	}
+
+	FASTAReader::FASTAReader(const std::string & fileName):
+		handle_(OpenFile(fileName)),
+		fileName_(fileName)
+	{
+	}
+
+	FASTAReader::~FASTAReader()
+	{
+		if(handle_ != 0)
+		{
+			CloseFile(static_cast<FileHandle>(handle_));
+		}
+	}
+
+	void FASTAReader::PushRecord(std::vector<FASTARecord> & record, std::string & sequence, std::string & header, size_t seqId)
+	{
+		record.push_back(FASTARecord());
+		record.back().id_ = seqId;
+		record.back().sequence_.swap(sequence);
+		record.back().description_.swap(header);
+		sequence.clear();
+		header.clear();
 	}
 
 	size_t FASTAReader::GetSequences(std::vector<FASTARecord> & record)
 	{
-		std::string buffer;
 		std::string sequence;
 		std::string header;
-		int line = 1;
+		size_t line = 0;
 		size_t seqId = record.size();
+		LineStream input(static_cast<FileHandle>(handle_));
 
 		try
 		{
-			while(!inputStream_.eof())
+			while(ks_getuntil(input.stream, '\n', &input.line, 0) >= 0)
 			{
-				std::getline(inputStream_, buffer);
-				boost::algorithm::trim(buffer);
+				++line;
+				const char * start = input.line.s;
+				const char * end = input.line.s + input.line.l;
+				for(; start != end && IsSpace(*start); ++start);
+				for(; start != end && IsSpace(*(end - 1)); --end);
 
-				if (buffer.empty()) continue;
+				if (start == end) continue;
 
-				if (buffer[0] == '>')
+				if (*start == '>')
 				{
 					if (!header.empty())
 					{
 						if (sequence.empty()) throw ParseException("empty sequence");
 
-						record.push_back(FASTARecord(sequence, header, seqId));
-						++seqId;
-						sequence.clear();
-						header.clear();
+						PushRecord(record, sequence, header, seqId++);
 					}
-					ValidateHeader(buffer);
-					header = buffer;
+
+					header.assign(start, end);
+					ValidateHeader(header);
 				}
 				else
 				{
-					ValidateSequence(buffer);
-					sequence += buffer;
+					ValidateSequence(start, end, sequence);
 				}
-
-				++line;
 			}
-			
+
 			if (sequence.empty()) throw ParseException("empty sequence");
-			record.push_back(FASTARecord(sequence, header, seqId));
+			PushRecord(record, sequence, header, seqId);
 		}
 		catch (ParseException & e)
 		{
@@ -73,6 +202,54 @@ namespace SyntenyFinder
 		return record.size();
 	}
 
+	void FASTAReader::ReadFiles(const std::vector<std::string> & fileName, std::vector<FASTARecord> & record, std::vector<size_t> & recordCount)
+	{
+		std::vector<std::string> error(fileName.size());
+		std::vector<std::vector<FASTARecord> > fileRecord(fileName.size());
+		#pragma omp parallel for schedule(dynamic)
+		for(int i = 0; i < static_cast<int>(fileName.size()); i++)
+		{
+			try
+			{
+				FASTAReader reader(fileName[i]);
+				if(!reader.IsOk())
+				{
+					throw std::runtime_error(("Cannot open file " + fileName[i]).c_str());
+				}
+
+				reader.GetSequences(fileRecord[i]);
+			}
+			catch(std::exception & e)
+			{
+				error[i] = e.what();
+			}
+			catch(...)
+			{
+				error[i] = "unknown error while reading " + fileName[i];
+			}
+		}
+
+		for(size_t i = 0; i < error.size(); i++)
+		{
+			if(!error[i].empty())
+			{
+				throw std::runtime_error(error[i]);
+			}
+		}
+
+		recordCount.clear();
+		for(size_t i = 0; i < fileRecord.size(); i++)
+		{
+			recordCount.push_back(fileRecord[i].size());
+			for(size_t j = 0; j < fileRecord[i].size(); j++)
+			{
+				PushRecord(record, fileRecord[i][j].sequence_, fileRecord[i][j].description_, record.size());
+			}
+
+			std::vector<FASTARecord>().swap(fileRecord[i]);
+		}
+	}
+
 	void FASTAReader::ValidateHeader(std::string & header)
 	{
 		size_t delim = header.find(' ');
@@ -89,22 +266,24 @@ namespace SyntenyFinder
 		if (header.empty()) throw ParseException("empty header");
 	}
 
-	void FASTAReader::ValidateSequence(std::string & sequence)
+	void FASTAReader::ValidateSequence(const char * start, const char * end, std::string & sequence)
 	{
-		const std::string VALID_CHARS = "ACGTURYKMSWBDHWNX-";
-		for (size_t i = 0; i < sequence.length(); ++i)
+		size_t pos = sequence.size();
+		sequence.resize(pos + (end - start));
+		for (; start != end; ++start, ++pos)
 		{
-			char orig = sequence[i];
-			sequence[i] = toupper(sequence[i]);
-			if (VALID_CHARS.find(sequence[i]) == std::string::npos) 
+			char ch = NORMALIZED_CHAR[static_cast<unsigned char>(*start)];
+			if (ch == 0)
 			{
-				throw ParseException((std::string("illegal character: ") + orig).c_str());
+				throw ParseException((std::string("illegal character: ") + *start).c_str());
 			}
+
+			sequence[pos] = ch;
 		}
 	}
 
 	bool FASTAReader::IsOk() const
 	{
-		return inputStream_.good();
+		return handle_ != 0;
 	}
 }
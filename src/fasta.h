@@ -14,7 +14,7 @@ namespace SyntenyFinder
 	struct FASTARecord
 	{
 	public:
-		FASTARecord() {}
+		FASTARecord(): id_(0) {}
 		FASTARecord(const std::string & sequence, const std::string & description, size_t id):
 			description_(description), id_(id), sequence_(sequence)
 		{
@@ -64,6 +64,7 @@ namespace SyntenyFinder
 		}
 
 	private:
+		friend class FASTAReader;
 		size_t id_;
 		std::string sequence_;
 		std::string description_;		
@@ -72,18 +73,19 @@ namespace SyntenyFinder
 	class FASTAReader
 	{
 	public:
-		explicit FASTAReader(const std::string & fileName): 
-			inputStream_(fileName.c_str()),
-			fileName_(fileName) {}
+		explicit FASTAReader(const std::string & fileName);
+		~FASTAReader();
 		size_t 	GetSequences(std::vector<FASTARecord>& record);
 		bool 	IsOk() const;
+		static void ReadFiles(const std::vector<std::string> & fileName, std::vector<FASTARecord> & record, std::vector<size_t> & recordCount);
 	private:
 		DISALLOW_COPY_AND_ASSIGN(FASTAReader);
 
-		void ValidateSequence(std::string & sequence);
+		void ValidateSequence(const char * start, const char * end, std::string & sequence);
 		void ValidateHeader(std::string & header);
+		static void PushRecord(std::vector<FASTARecord> & record, std::string & sequence, std::string & header, size_t seqId);
 
-		std::ifstream inputStream_;
+		void * handle_;
 		std::string fileName_;
 	};
 
@@ -0,0 +1,85 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#include "hierarchy.h"
+
+namespace SyntenyFinder
+{
+	namespace
+	{
+		bool CompareByChrAndStart(const BlockInstance & a, const BlockInstance & b)
+		{
+			return std::make_pair(a.GetChrId(), a.GetStart()) < std::make_pair(b.GetChrId(), b.GetStart());
+		}
+	}
+
+	BlockHierarchy::BlockHierarchy(const std::vector<std::vector<BlockInstance> > & history):
+		stage_(history), children_(history.size())
+	{
+		for(size_t i = 0; i < stage_.size(); i++)
+		{
+			std::sort(stage_[i].begin(), stage_[i].end(), CompareByChrAndStart);
+			children_[i].resize(stage_[i].size());
+			if(i > 0)
+			{
+				Join(i);
+			}
+		}
+	}
+
+	size_t BlockHierarchy::GetStageCount() const
+	{
+		return stage_.size();
+	}
+
+	const std::vector<BlockInstance> & BlockHierarchy::GetStage(size_t stage) const
+	{
+		return stage_[stage];
+	}
+
+	const std::vector<size_t> & BlockHierarchy::GetChildren(size_t stage, size_t instance) const
+	{
+		return children_[stage][instance];
+	}
+
+	void BlockHierarchy::Join(size_t stage)
+	{
+		//Children are sorted by start, so for a parent the candidates are the children that
+		//start before its end and whose running maximum of the ends is past its start.
+		//Instances of a stage rarely overlap, so few candidates are rejected.
+		const std::vector<BlockInstance> & parent = stage_[stage];
+		const std::vector<BlockInstance> & child = stage_[stage - 1];
+		std::vector<size_t> maxEnd(child.size());
+		for(size_t i = 0; i < child.size(); i++)
+		{
+			bool sameChr = i > 0 && child[i - 1].GetChrId() == child[i].GetChrId();
+			maxEnd[i] = sameChr ? std::max(maxEnd[i - 1], child[i].GetEnd()) : child[i].GetEnd();
+		}
+
+		size_t chrStart = 0;
+		size_t chrEnd = 0;
+		for(size_t i = 0; i < parent.size(); i++)
+		{
+			size_t chr = parent[i].GetChrId();
+			if(i == 0 || parent[i - 1].GetChrId() != chr)
+			{
+				for(chrStart = chrEnd; chrStart < child.size() && child[chrStart].GetChrId() < chr; chrStart++);
+				for(chrEnd = chrStart; chrEnd < child.size() && child[chrEnd].GetChrId() == chr; chrEnd++);
+			}
+
+			size_t start = parent[i].GetStart();
+			size_t end = parent[i].GetEnd();
+			size_t first = std::upper_bound(maxEnd.begin() + chrStart, maxEnd.begin() + chrEnd, start) - maxEnd.begin();
+			for(size_t j = first; j < chrEnd && child[j].GetStart() < end; j++)
+			{
+				if(child[j].GetEnd() > start)
+				{
+					children_[stage][i].push_back(j);
+				}
+			}
+		}
+	}
+}
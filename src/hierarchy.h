@@ -0,0 +1,32 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#ifndef _HIERARCHY_H_
+#define _HIERARCHY_H_
+
+#include "blockinstance.h"
+
+namespace SyntenyFinder
+{
+	//Blocks of all the stages linked into a tree: an instance at stage i is a parent of
+	//the instances at stage i - 1 that overlap it on the same sequence
+	class BlockHierarchy
+	{
+	public:
+		explicit BlockHierarchy(const std::vector<std::vector<BlockInstance> > & history);
+		size_t GetStageCount() const;
+		//Instances of the stage sorted by sequence and then by start
+		const std::vector<BlockInstance> & GetStage(size_t stage) const;
+		//Indices of the children in GetStage(stage - 1), in the ascending order
+		const std::vector<size_t> & GetChildren(size_t stage, size_t instance) const;
+	private:
+		std::vector<std::vector<BlockInstance> > stage_;
+		std::vector<std::vector<std::vector<size_t> > > children_;
+		void Join(size_t stage);
+	};
+}
+
+#endif
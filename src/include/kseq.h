@@ -128,7 +128,7 @@ typedef struct __kstring_t {
 				break;													\
 			}															\
 		}																\
-		if (str->l == 0) {												\
+		if (str->s == 0) {												\
 			str->m = 1;													\
 			str->s = (char*)calloc(1, 1);								\
 		}																\
@@ -27,6 +27,7 @@ namespace SyntenyFinder
 
 	void IndexedSequence::Init(std::vector<std::string> record, std::vector<std::vector<Pos> > & originalPos, size_t k, const std::string & tempDir, bool clear)
 	{
+		Profiler::Scope scope("index");
 		size_t maxId;
 		for(size_t i = 0; i < record.size(); i++)
 		{
@@ -39,15 +40,19 @@ namespace SyntenyFinder
 		std::vector<std::vector<BifurcationInstance> > bifurcation(2);	
 		if(tempDir.size() == 0)
 		{
-			maxId = EnumerateBifurcationsSArrayInRAM(record, bifurcation[0], bifurcation[1]);
+			maxId = EnumerateBifurcationsSArrayInRAM(record, k, bifurcation[0], bifurcation[1]);
 		}
 		else
 		{
-			maxId = EnumerateBifurcationsSArray(record, tempDir, bifurcation[0], bifurcation[1]);
+			maxId = EnumerateBifurcationsSArray(record, k, tempDir, bifurcation[0], bifurcation[1]);
 		}
 
 		bifStorage_.reset(new BifurcationStorage(maxId));
+		Profiler::Scope construction("DNASequence");
 		sequence_.reset(new DNASequence(record, originalPos, clear));
+		construction.Stop();
+		Profiler::Scope loading("AddPoint");
+		Profiler::Count("points", bifurcation[0].size() + bifurcation[1].size());
 		for(size_t strand = 0; strand < 2; strand++)
 		{
 			size_t nowBif = 0;
@@ -9,6 +9,7 @@
 
 #include "hashing.h"
 #include "platform.h"
+#include "profiler.h"
 #include "bifurcationstorage.h"
 
 namespace SyntenyFinder
@@ -30,6 +31,9 @@ namespace SyntenyFinder
 		IndexedSequence(const std::vector<std::string> & record, std::vector<std::vector<Pos> > & original, size_t k, const std::string & tempDir, bool clear = false);
 		static bool StrandIteratorPosGEqual(StrandIterator a, StrandIterator b);		
 		static size_t StrandIteratorDistance(StrandIterator start, StrandIterator end);		
+		//Only enumerates the vertices of the graph of the records, for measuring. The
+		//records must consist of definite bases. Returns the number of vertices
+		static size_t EnumerateVertices(const std::vector<std::string> & record, size_t k);
 	private:
 		DISALLOW_COPY_AND_ASSIGN(IndexedSequence);
 		typedef std::pair<StrandIterator, size_t> IteratorChrPair;
@@ -69,8 +73,8 @@ namespace SyntenyFinder
 
 		size_t GetMustBeBifurcation(StrandIterator it);
 		void Init(std::vector<std::string> record, std::vector<std::vector<Pos> > & original, size_t k, const std::string & tempDir, bool clear);
-		size_t EnumerateBifurcationsSArray(const std::vector<std::string> & data, const std::string & tempDir, std::vector<BifurcationInstance> & posBifurcation, std::vector<BifurcationInstance> & negBifurcation);
-		size_t EnumerateBifurcationsSArrayInRAM(const std::vector<std::string> & data, std::vector<BifurcationInstance> & posBifurcation, std::vector<BifurcationInstance> & negBifurcation);				
+		static size_t EnumerateBifurcationsSArray(const std::vector<std::string> & data, size_t k, const std::string & tempDir, std::vector<BifurcationInstance> & posBifurcation, std::vector<BifurcationInstance> & negBifurcation);
+		static size_t EnumerateBifurcationsSArrayInRAM(const std::vector<std::string> & data, size_t k, std::vector<BifurcationInstance> & posBifurcation, std::vector<BifurcationInstance> & negBifurcation);				
 	};
 }
 
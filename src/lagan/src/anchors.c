@@ -3,6 +3,7 @@
 #include <ctype.h>
 #include <string.h>
 #include "skiplist.h"
+#include "threadlocal.h"
 
 typedef struct GapFreeChunkList {
   int x;
@@ -31,11 +32,11 @@ typedef struct hllpointer {
   hll* myhll;
 } hptr;
 
-char seq1name[255];
-char seq2name[255];
+LAGAN_TLS char seq1name[255];
+LAGAN_TLS char seq2name[255];
 
-float gapopen =0, gapcont=0;
-int gapfreechunks = 0;
+LAGAN_TLS float gapopen =0, gapcont=0;
+LAGAN_TLS int gapfreechunks = 0;
 hll* parseCHAOS(FILE* infile, int* numhits);
 hll* findBestChain(hptr* myarr, int arrsize);
 void doOutput(hll* mylist);
@@ -124,6 +125,7 @@ float gapPen(hll* next, hll* prev) {
 hll* findBestChain(hptr* array, int arrsize) {
   sklst* skipper = makeSkLst();
   sle* help, *bestptr;
+  hll* t;
   float best = -1;
   int i;
   for (i = 0; i < arrsize; i++) {
@@ -131,7 +133,7 @@ hll* findBestChain(hptr* array, int arrsize) {
       help = SLfind(skipper, array[i].myhll->seq2start);
       if (help->myelem && 
 	  (gapPen(array[i].myhll, ((hll*)help->myelem)) + ((hll*)help->myelem)->scoreSoFar) > 0) {
-	array[i].myhll->bkptr = help->myelem;
+	array[i].myhll->bkptr = (hll*) help->myelem;
 	array[i].myhll->scoreSoFar = ((hll*)help->myelem)->scoreSoFar + array[i].myhll->score + gapPen(array[i].myhll, ((hll*)help->myelem));
       }
       else {
@@ -160,8 +162,10 @@ hll* findBestChain(hptr* array, int arrsize) {
     } 
     help = help->next[0];
   }
-
-  return (hll*)bestptr->myelem;
+  t = (hll*)bestptr->myelem;
+  delSkLst(skipper);
+  free(skipper);
+  return t;
 }
 
 void doOutput(hll* best) { 
@@ -5,16 +5,12 @@
 #include <stdio.h>
 #include <limits.h>
 #include "diagmatrix.h"
+#include "threadlocal.h"
 
 #define MAX2(x,y)   ( (x) >= (y) ? (x) : (y) )
 #define MIN2(x,y)   ( (x) <= (y) ? (x) : (y) )
 
-alel dummy;
-
-#ifdef MULTIAL__FLAG
-extern int *freed, freedsize, freedcap;
-extern align *freedptr;
-#endif
+LAGAN_TLS alel dummy;
 
 dmat* makeDM(int d1, int d2) {
   dmat* trgt = (dmat*)malloc(sizeof(dmat));
@@ -57,6 +53,11 @@ void freeDM(dmat* trgt) {
   for (i=0; i< NACT; i++) {
     free (trgt->myelems[i]);
   }
+  for (i=0; i < 2; i++) {
+    for (j=0; j<3; j++) {
+      free (trgt->myneck[i][j]);
+    }
+  }
   free(trgt->myptrs);
   free(trgt->diagindex);
   free(trgt->diagstart);
@@ -205,6 +206,37 @@ void DMsetElem(dmat* trgt, alel* tbi, int x, int y, char ptr) {
   trgt->myptrs[trgt->diagindex[dn] + elem-trgt->diagstart[dn]]=ptr;
 }
 
+/* The cell (x-dx, y-dy) next to the j-th cell (x, y) of diagonal dn is
+   res[j + *offset] for *first <= j <= *last, DMgetElem gives the dummy for
+   the other cells. Lets a diagonal be filled without checking the band
+   boundaries at every cell. */
+alel* DMgetNeighbours(dmat* trgt, int dn, int dx, int dy, int* offset, int* first, int* last) {
+  int size, x, y, elem, nd = dn - dx - dy;
+  DMgetDiagStart(trgt, dn, &size, &x, &y);
+  *offset = 0;
+  *first = 0;
+  *last = -1;
+  if (nd <= 0 || nd >= trgt->d1+trgt->d2)
+    return &dummy;
+  elem = (nd < trgt->d2)? (x-dx-1): trgt->d2-(y-dy);
+  *offset = elem - trgt->diagstart[nd];
+  *first = MAX2(0, -*offset);
+  *last = MIN2(size-1, trgt->diagend[nd] - trgt->diagstart[nd] - *offset);
+  return trgt->myelems[nd % NACT];
+}
+
+/* DMsetPtr for all the cells of diagonal dn */
+void DMsetPtrs(dmat* trgt, int dn, char* ptrs) {
+  int size = trgt->diagend[dn] - trgt->diagstart[dn] + 1;
+  int loc = trgt->diagindex[dn], i;
+  for (i = 0; i < size; i++, loc++) {
+    if (loc & 1)
+      trgt->myptrs[loc >> 1] = (char)(trgt->myptrs[loc >> 1] & 0xf0) | (char)(ptrs[i] & 0x0f);
+    else
+      trgt->myptrs[loc >> 1] = (char)(trgt->myptrs[loc >> 1] & 0x0f) | (char)(ptrs[i] << 4);
+  }
+}
+
 char DMnextDiag(dmat* trgt) {
   char* newptrs;
   int i;
@@ -6,16 +6,18 @@
 #else
 #include "order.h"
 #endif
+#include "threadlocal.h"
 
 #define Mmask 0x3
 #define Nmask 0x4
 #define Omask 0x8
 #define NACT 3
 
+/* 32-bit scores, the recurrences compute them in int anyway */
 typedef struct AlignElement {
-  long int M;
-  long int N; 
-  long int O;
+  int M;
+  int N; 
+  int O;
 } alel;
 
 typedef struct diagmatrix {
@@ -36,6 +38,9 @@ typedef struct diagmatrix {
   int neckdiag[2]; /* For each the size of its 2 diagonals */
 } dmat;
 
+/* Neighbour of the cells outside of the band */
+extern LAGAN_TLS alel dummy;
+
 
 dmat* makeDM(int d1, int d2);
 void freeDM(dmat* trgt);
@@ -48,6 +53,8 @@ align* DMgetNeck(dmat* trgt, int x, int y, int which);
 void DMsetNeck(dmat* trgt, align* myal, int x, int y, int which);
 alel* DMgetDiagStart(dmat* trgt, int dn, int* size, int* startx, int* starty);
 void DMsetElem(dmat* trgt, alel* elem, int x, int y, char ptr);
+alel* DMgetNeighbours(dmat* trgt, int dn, int dx, int dy, int* offset, int* first, int* last);
+void DMsetPtrs(dmat* trgt, int dn, char* ptrs);
 char DMnextDiag(dmat* trgt);
 int DMnextNecks(dmat* trgt, int diag);
 
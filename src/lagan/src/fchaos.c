@@ -7,9 +7,11 @@
 #include "fchaos.h"
 #include "skiplist.h"
 #include "thrtrie.h"
+#include "kmerindex.h"
 #include "global.h"
 #include "translate.h"
 #include "filebuffer.h"
+#include "threadlocal.h"
 
 #define VER_NUM "0.932"
 #define BLOSUM_FILE "blosum62s.txt"
@@ -29,29 +31,29 @@ typedef struct SeqMatch {
   int offset;
 } match;
 
-extern int indeces[256];
 
 
 void remElem(LList* tbf, int i);
 
-int verbose = 0;
-int wordlen = 10;
-int ndegen = 1;
-int cutoff = 25;
-int lookback = 20;
-int gapfreechunks = 0;
-int mgaplen = 5;
-int gappenc = -1;
-int gappeno = 0 ;
-int both = 0;
-int translated = 0;
-int s1start = 0;
-int s1end = 0;
-int s2start = 0;
-int s2end = 0;
-
-int extend = 0;
-int reScoreCutoff = 0;
+LAGAN_TLS int verbose = 0;
+LAGAN_TLS int wordlen = 10;
+LAGAN_TLS int ndegen = 1;
+LAGAN_TLS int cutoff = 25;
+LAGAN_TLS int lookback = 20;
+LAGAN_TLS int gapfreechunks = 0;
+LAGAN_TLS int mgaplen = 5;
+LAGAN_TLS int gappenc = -1;
+LAGAN_TLS int gappeno = 0 ;
+LAGAN_TLS int both = 0;
+LAGAN_TLS int translated = 0;
+LAGAN_TLS int s1start = 0;
+LAGAN_TLS int s1end = 0;
+LAGAN_TLS int s2start = 0;
+LAGAN_TLS int s2end = 0;
+
+LAGAN_TLS int extend = 0;
+LAGAN_TLS int flatindex = 0;
+LAGAN_TLS int reScoreCutoff = 0;
 
 //int matchsco = 12;
 //int mismatchsco = -8;
@@ -63,17 +65,17 @@ int dropcutoff = 1500;
 int substmatrix[256][256];
 
 
-hll* allhits = 0;
-sklst* mylist;
-int gapstart=20;
-int gapcont=1;
-char* alpha = "ATCGN";
-char* triealpha = "ATCG";
+LAGAN_TLS hll* allhits = 0;
+LAGAN_TLS sklst* mylist;
+LAGAN_TLS int gapstart=20;
+LAGAN_TLS int gapcont=1;
+LAGAN_TLS char* alpha = "ATCGN";
+LAGAN_TLS char* triealpha = "ATCG";
 char* protalpha = "PCMH[DE][KR][NQ][ST][ILV][FYW][AG]X*";
 char* prottriealpha = "PCMH[DE][KR][NQ][ST][ILV][FYW][AG]";
-char direction;
+LAGAN_TLS char direction;
 
-FILE* pairfile = 0;
+LAGAN_TLS FILE* pairfile = 0;
 
 
 char comp(char c) {
@@ -427,8 +429,8 @@ int chain(LList* second, int off2, LList* first, int off1, int diff1, int gap, f
   return mindiff*baseval+gap;
 }
 
-int tc =0;
-int wc = 0;
+LAGAN_TLS int tc =0;
+LAGAN_TLS int wc = 0;
 
  void findPrev(LList* curr, int position, int offset, float baseval) {
   int j,k;
@@ -533,12 +535,12 @@ void connectToPrev(LList* curr, int index, float baseval) {
   }
 }
 
-int doAlgo(TNode* root, seq* query, seq* dbase) {
+int doAlgo(TNode* root, KIndex* index, seq* query, seq* dbase) {
   char* currword = dbase->lets;
   LList** LListArr = (LList**) malloc(sizeof(LList*) * dbase->numlets);
   LList* temp;
   match* mattemp;
-  int i = 0, j;
+  int i = 0, j, looked = 0;
   float bestscore=-1, baseval;
   int bestqueryloc=-1, bestdbaseloc=-1, numhits;
   while (*currword) {
@@ -549,7 +551,14 @@ int doAlgo(TNode* root, seq* query, seq* dbase) {
     if (*currword == '.') {
       /*TODO */
     }
-    LListArr[i] = temp = getNextWords(root, currword++, ndegen);
+    if (index) {
+      if (i == looked)
+	looked += getNextWordsBatch(index, dbase->lets, i, KI_BATCH, ndegen, LListArr + i);
+      temp = LListArr[i];
+      currword++;
+    }
+    else
+      LListArr[i] = temp = getNextWords(root, currword++, ndegen);
 
     /*****/
     numhits = 1;
@@ -667,6 +676,9 @@ void paramParse(int argc, char** argv) {
     else if (!strcmp(argv[i], "-ext") || !strcmp(argv[i], "-EXT")) {
       extend = 1;
     }
+    else if (!strcmp(argv[i], "-flat") || !strcmp(argv[i], "-FLAT")) {
+      flatindex = 1;
+    }
     else if (!strcmp(argv[i], "-wl") || !strcmp(argv[i], "-WL")) {
       wordlen = atoi(argv[++i]);
     }
@@ -716,6 +728,7 @@ void usage() {
   printf("-b     = Both strands [default forward-only]\n");
   printf("-t     = Translated [default off]\n");
   printf("-ext   = do BLAST-like extention with given cutoff [default off]\n");
+  printf("-flat  = seed with a flat k-mer index instead of the trie, genomic only [default off]\n");
   printf("-wl #  = Word Length [default 10 for genomic, 4 for peptide]\n");
   printf("-nd #  = Number of Degeneracy [default 1 for genomic, 0 for peptide]\n");
   printf("-co #  = score CutOff [default 25]\n");
@@ -735,10 +748,10 @@ void rc(seq* dbase) {
 }
 
 
-int paircnt = 0;
+LAGAN_TLS int paircnt = 0;
 
-char savs[2];
-int savlocs[2] = {-1,-1};
+LAGAN_TLS char savs[2];
+LAGAN_TLS int savlocs[2] = {-1,-1};
 
 void procPairs(seq* currquery, seq* currdbase) {
   //  int s1start, s1end, s2start, s2end;
@@ -835,7 +848,7 @@ void doTranslated(FileBuffer query, FileBuffer dbase) {
       for (i=0; i < 6; i++) 
 	for (j=(i/3)*3; j < (i/3+1)*3; j++) {
 	  //	  fprintf(stderr, "1DOING FRAME %d AGAINST %d\n",i,j);
-	  doAlgo(roots[i], queryframes[i], dbaseframes[j]);
+	  doAlgo(roots[i], 0, queryframes[i], dbaseframes[j]);
 	  /****/
 	  allhits = removeDups(allhits, queryframes[i], dbaseframes[j]);
 	  transloc(allhits, i, j, queryframes[i]->numlets, dbaseframes[j]->numlets);
@@ -847,7 +860,7 @@ void doTranslated(FileBuffer query, FileBuffer dbase) {
 	for (i=0; i < 6; i++) 
 	  for (j=(i>2)?0:3; j < ((i>2)?3:6); j++) {
 	    //	    fprintf(stderr, "2DOING FRAME %d AGAINST %d\n",i,j);
-	    doAlgo(roots[i], queryframes[i], dbaseframes[j]);
+	    doAlgo(roots[i], 0, queryframes[i], dbaseframes[j]);
 	    /****/
 	    allhits = removeDups(allhits, queryframes[i], dbaseframes[j]);
 	    transloc(allhits, i, j, queryframes[i]->numlets, dbaseframes[j]->numlets);
@@ -881,7 +894,8 @@ int main(int argc, char** argv) {
 
   seq *currquery, *currdbase, *temp; 
   char* currword; 
-  TNode* root;
+  TNode* root = 0;
+  KIndex* index = 0;
   int i;
 
   if (argc < 3) {
@@ -923,14 +937,16 @@ int main(int argc, char** argv) {
   }
 
   do {
-    root = makeTrie(wordlen, triealpha);
     mylist = makeSkLst();
     currword = currquery->lets;
-    insertString(root,currword);
+    if (!flatindex || triealpha == prottriealpha || !(index = makeKmerIndex(currword, wordlen))) {
+      root = makeTrie(wordlen, triealpha);
+      insertString(root,currword);
+    }
 
     while (currdbase) {
       direction = '+';
-      doAlgo(root, currquery, currdbase);
+      doAlgo(root, index, currquery, currdbase);
       /***/
       allhits = removeDups(allhits, currquery, currdbase);
       printHLL(allhits, currquery, currdbase, currdbase->numlets);
@@ -938,7 +954,7 @@ int main(int argc, char** argv) {
       if (both) {
 	direction = '-';
 	rc(currdbase);
-	doAlgo(root, currquery, currdbase);
+	doAlgo(root, index, currquery, currdbase);
 	/****/
 	allhits = removeDups(allhits, currquery, currdbase);
 	printHLL(allhits, currquery, currdbase, currdbase->numlets);
@@ -953,7 +969,10 @@ int main(int argc, char** argv) {
     currdbase = temp;
     if (pairfile) {
       procPairs(currquery, currdbase);
-      freeTrie(root);
+      if (index)
+	freeKmerIndex(index);
+      else
+	freeTrie(root);
     }
   } while (pairfile)
       ;
@@ -2,7 +2,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <ctype.h>
 #include <assert.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 #ifdef CHAOS__FLAG
 char* alphabet = "ATCGNPCMHDEKRQSILVFYWX*";
@@ -10,6 +15,25 @@ char* alphabet = "ATCGNPCMHDEKRQSILVFYWX*";
 char* alphabet = "ATCGN-.";
 #endif
 
+/* Maps a regular file, the buffer is read from data otherwise */
+void FileMap (FileBuffer buf){
+#ifndef _WIN32
+  struct stat info;
+  void *map;
+
+  if (fstat (fileno (buf->data), &info) || !S_ISREG (info.st_mode) || info.st_size <= 0)
+    return;
+  map = mmap (0, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno (buf->data), 0);
+  if (map == MAP_FAILED)
+    return;
+  fclose (buf->data);
+  buf->data = 0;
+  buf->buffer = buf->head = (char*) map;
+  buf->tail = buf->buffer + info.st_size;
+  buf->mapsize = info.st_size;
+#endif
+}
+
 FileBuffer FileOpen (const char *path){
   FileBuffer buf;
   FILE *data = fopen (path, "r");
@@ -24,11 +48,19 @@ FileBuffer FileOpen (const char *path){
   //buf->pos = BUFFER_SIZE;
   //buf->len = BUFFER_SIZE;
   buf->data = data;
+  buf->buffer = NULL;
+  buf->mapsize = 0;
+  FileMap (buf);
+  if (!buf->mapsize && !(buf->buffer = (char*) malloc (BUFFER_SIZE))){
+    fclose (data);
+    free (buf);
+    return NULL;
+  }
   return buf;  
 }
 
 void FileUpdate (FileBuffer buf){
-  if (buf->head >= buf->tail){
+  if (buf->data && buf->head >= buf->tail){
     buf->tail = buf->buffer + fread (buf->buffer, sizeof(char), BUFFER_SIZE, buf->data);
     buf->head = buf->buffer;
   }
@@ -36,7 +68,7 @@ void FileUpdate (FileBuffer buf){
 
 int FileEOF (FileBuffer buf){
   FileUpdate (buf);
-  return buf->head >= buf->tail && feof (buf->data);
+  return buf->head >= buf->tail && (!buf->data || feof (buf->data));
 }
 
 void FileGetS (char *buffer, int length, FileBuffer buf){
@@ -85,19 +117,45 @@ char FilePeekC (FileBuffer buf){
 }
 
 void FileClose (FileBuffer buf){
-  fclose (buf->data);
+#ifndef _WIN32
+  if (buf->mapsize)
+    munmap (buf->buffer, buf->mapsize);
+#endif
+  if (buf->data){
+    fclose (buf->data);
+    free (buf->buffer);
+  }
   free (buf);
 }
 
+/* A record written on one line of letters FileRead keeps as they are, it
+   ends with a line break followed by the next record or the end of the
+   file. Returns the end of the letters or 0, next is set to the record
+   that follows. */
+char *FileLineRecord (FileBuffer buf, char *trans, int *numNs, char **next){
+  char *end = buf->head;
+
+  *numNs = 0;
+  while (end < buf->tail && trans[(unsigned char) *end] == *end){
+    if (*end == 'N') (*numNs)++;
+    end++;
+  }
+  if (end == buf->head || end >= buf->tail || (*end != '\n' && *end != '\r'))
+    return 0;
+  for (*next = end; *next < buf->tail && (**next == '\n' || **next == '\r'); (*next)++);
+  return (*next == buf->tail || **next == '>') ? end : 0;
+}
+
 seq* FileRead (FileBuffer buf, int start, int finish, int version){
-  char* res = (char*) malloc(sizeof(char));
-  int ressize = 1, numread = 0, i, numNs = 0;
-  char *tempname, temp[256], currchar, *curr, *resend;
-  seq* myseq = (seq*) malloc(sizeof(seq));
+  char* res;
+  int ressize = 2, numread = 0, i, numNs = 0;
+  char *tempname, temp[256], currchar, *curr, *resend, *next;
+  seq* myseq;
 
 
   if (FileEOF(buf))
     return 0;
+  myseq = (seq*) malloc(sizeof(seq));
 
   if (start == 1 && finish == 0) {
     start = buf->startpos;
@@ -125,46 +183,59 @@ seq* FileRead (FileBuffer buf, int start, int finish, int version){
   }
 
   FileUpdate (buf);
-  curr = res;
-  resend = res + ressize;
 
-  if (version == VER_ORDER || version == VER_MLAGAN){
-    ressize = 2;
-    numread = 1;
-    if (version == VER_ORDER)
-      res[0] = 0;
-    else 
-      res[0] = 'N';
-    curr++;
+  if (version == VER_MLAGAN && buf->mapsize && (curr = FileLineRecord (buf, temp, &numNs, &next))){
+    /* the line breaks around the letters become the leading 'N' and the terminator */
+    res = buf->head - 1;
+    res[0] = 'N';
+    numread = curr - res;
+    res[numread] = 0;
+    buf->head = next;
+    myseq->rptr = 0;
   }
+  else {
+    /* a mapped record is copied at once */
+    if (buf->mapsize){
+      next = (char*) memchr (buf->head, '>', buf->tail - buf->head);
+      ressize = (next ? next : buf->tail) - buf->head + 2;
+    }
+    res = (char*) malloc(sizeof(char) * ressize);
+    curr = res;
+    resend = res + ressize;
 
-  while (buf->head < buf->tail || !feof (buf->data)){
-
-    while (buf->head < buf->tail){
-      currchar = *(buf->head);
-      if (currchar == '>') goto outer;
-      if (currchar != ' ' && currchar != '\n' && currchar != '\r' && 
-	  currchar != '\t' && currchar != '\t' && currchar != '\v') {
-	if (currchar == 'N') numNs++;
-	*curr++ = temp[(int) currchar];
-	if (curr >= resend) {
-	  numread = curr - res;
-	  res = (char *) realloc (res, sizeof(char) * (ressize *= 2));
-	  curr = res + numread;
-	  resend = res + ressize;
-	}
-      }
-      buf->head++;
+    if (version == VER_ORDER || version == VER_MLAGAN){
+      if (version == VER_ORDER)
+        res[0] = 0;
+      else 
+        res[0] = 'N';
+      curr++;
     }
 
-    buf->tail = buf->buffer + fread (buf->buffer, sizeof(char), BUFFER_SIZE, buf->data);
-    buf->head = buf->buffer;
-  }
+    while (!FileEOF (buf)){
+
+      while (buf->head < buf->tail){
+        currchar = *(buf->head);
+        if (currchar == '>') goto outer;
+        if (currchar != ' ' && currchar != '\n' && currchar != '\r' && 
+	    currchar != '\t' && currchar != '\t' && currchar != '\v') {
+	  if (currchar == 'N') numNs++;
+	  *curr++ = temp[(unsigned char) currchar];
+	  if (curr >= resend) {
+	    numread = curr - res;
+	    res = (char *) realloc (res, sizeof(char) * (ressize *= 2));
+	    curr = res + numread;
+	    resend = res + ressize;
+	  }
+        }
+        buf->head++;
+      }
+    }
   
- outer:
-  numread = curr - res;
-  res[numread]=0;
-  myseq->rptr = res;
+  outer:
+    numread = curr - res;
+    res[numread]=0;
+    myseq->rptr = res;
+  }
 
   if (version == VER_FCHAOS){
     if (start > 0) {
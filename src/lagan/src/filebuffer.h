@@ -14,10 +14,14 @@
 #define VER_ORDER 1
 #define VER_MLAGAN 2
 
+/* A regular file is mapped into memory as a whole (privately, so FileRead
+   may write into it) and data is 0. Other files are read through a buffer
+   of BUFFER_SIZE bytes. */
 struct FileBufferImplementation {
   FILE *data;
   char* filename;
-  char buffer[BUFFER_SIZE];
+  char *buffer;
+  long mapsize;
   char *head, *tail;
   int startpos, endpos;
   //  int pos, len;
@@ -31,6 +35,9 @@ void FileGetS (char *buffer, int length, FileBuffer buf);
 char FilePeekC (FileBuffer buf);
 void FilePopC (FileBuffer buf);
 void FileClose (FileBuffer buf);
+/* With VER_MLAGAN, a record of a mapped file written on one line in upper
+   case is returned as a view: lets points into the mapping, rptr is 0 and
+   the letters stay valid until FileClose. */
 seq* FileRead (FileBuffer buf, int start, int end, int version);
 
 #endif
@@ -1,8 +1,9 @@
 #include "global.h"
+#include "threadlocal.h"
 #include <stdlib.h>
 #include <stdio.h>
 
-extern int indeces[256];
+extern LAGAN_TLS int indeces[256];
 
 #define MAX2(x,y)   ( (x) >= (y) ? (x) : (y) )
 #define MAX3(x,y,z)  MAX2(MAX2(x,y),z)
@@ -169,6 +170,7 @@ int printalign(char* seq1, int start1, int end1, char* seq2, int start2,
   printf("score = %d, nmatches = %d, nga=%d, ngb=%d nletters=%d, perc = %f\n",
 	 myalign->score,nm,nga,ngb,nlets,(float)nm/(float)nlets);
   printf("\n");
+  return 0;
 }
 
 
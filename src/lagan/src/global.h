@@ -1,3 +1,6 @@
+#ifndef __GLOBAL_H
+#define __GLOBAL_H
+
 #define INSERTION 2
 #define DELETION 3
 
@@ -12,3 +15,5 @@ align* global(char* seq1, int start1, int end1, char* seq2, int start2, int end2
 
 int printalign(char* seq1, int start1, int end1, char* seq2, int start2, int end2,
 	      align* myalign);
+
+#endif
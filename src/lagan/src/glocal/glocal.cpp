@@ -6,74 +6,73 @@ bool seq1StartCompare(const Fragment &f1, const Fragment &f2) {
 	return f1.seq1Start < f2.seq1Start;
 }
 
-//vectors that would be needed globally
-vector<Fragment> fragments;
-vector<Point>startPoints;
-vector<Point>endPoints;
-long long int numFragments;
-InterPoint inter;
-
-
-/*SLAGANCHANGE This has to change*/
-
-RI RI_regions[1<<(UPSTRANDBITS+DOWNSTRANDBITS+RELPOSBITS)];
-LI LI_regions[1<<(UPSTRANDBITS+DOWNSTRANDBITS+RELPOSBITS)];
-
-vector<class Score*> scoreFunctions[1<<(UPSTRANDBITS+DOWNSTRANDBITS+RELPOSBITS)];
-
-Name allNames;
-
-
-extern Fragment LI_dummy;
-Fragment * unrelatedFrag;
+// the sentinels stand for the empty chain, they must not match any fragment
+static void initSentinel(Fragment *frag) {
+	frag->seq1Start = frag->seq2Start = frag->seq1End = frag->seq2End = 0;
+	frag->strand = NEGATIVE;
+	frag->score = frag->totalScore = 0;
+	frag->back = NULL;
+	frag->deleted = FALSE;
+	frag->seq1Name[0] = frag->seq2Name[0] = '\0';
+	frag->nameIter = Name::iterator();
+	frag->base = 0;
+}
 
-Fragment *max_score_index;
-float max_score;
 
-int main(int, char **argv) {
+long long int glocalChain(const vector<Fragment> &input, const ScoreTable *scores, vector<Fragment> &chain) {
 	long long int nextEndRow,nextStartRow, nextInterPointRow;
 	long long int i;
 	Point intersectionPoint;
+	Chainer *chainer = new Chainer;
+	Fragment *current;
+
+	chain.clear();
+	chainer->fragments = input;
+	chainer->numFragments = input.size();
+	chainer->scores = scores;
+	chainer->nextStart = chainer->nextEnd = 0;
+
+	if (chainer->numFragments == 0) {
+		delete chainer;
+		return 0;
+	}
 
-	numFragments = readInput(argv[1]);
-
-	findAllNames( numFragments);
-	decideContigBase();
-	storeIterators(numFragments);
-
-	initScoreFunctionPointers(argv[2]);
-	unrelatedFrag = &LI_dummy;
+	findAllNames(chainer);
+	decideContigBase(chainer);
+	storeIterators(chainer);
 
-	/*SLAGANCHANGE  need a LI, RI pointer array and init */
-	/*SLAGANCHANGE:: Need score function init */
+	initSentinel(&chainer->LI_dummy);
+	initSentinel(&chainer->RI_origin);
+	initSentinel(&chainer->RI_end);
+	chainer->unrelatedFrag = &chainer->LI_dummy;
 
-	if (DEBUG) { fprintf(stderr,"Numfrg::%lld",numFragments); }
-	max_score_index=NULL;
-	max_score =-INF;
+	if (DEBUG) { fprintf(stderr,"Numfrg::%lld",chainer->numFragments); }
+	chainer->max_score_index=NULL;
+	chainer->max_score =-INF;
 
 	long long int break_flag =0;
 
-	createPointLists(numFragments);
-//	printFragmentsInPointListOrder(numFragments);
-//	exit(0);
+	createPointLists(chainer);
 
 	//The initial Row upto which startPointHandler goes
-	nextEndRow = endPoints[0].seq1;
-	nextStartRow = startPoints[0].seq1;
+	nextEndRow = chainer->endPoints[0].seq1;
+	nextStartRow = chainer->startPoints[0].seq1;
 
+	// the handlers only look up the regions of the RIGHT and LEFT cases
 	for (i=0;i<1<<TOTALSHIFT;i++) {
-		initRI(&RI_regions[i],i);
-		InitLI(&LI_regions[i],i);
+		if ((i >> RELPOSSHIFT) > LEFT || (i >> UPSTRANDSHIFT & 7) > POSITIVE || (i >> DOWNSTRANDSHIFT & 7) > POSITIVE) { continue; }
+		initRI(&chainer->RI_regions[i],i,scores,&chainer->RI_origin,&chainer->RI_end);
+		InitLI(&chainer->LI_regions[i],i,&chainer->inter,&chainer->LI_dummy,scores);
 	}
 
 	if (DEBUG) { fprintf(stderr,"The number of regions was %lld",i); }
 
 	while (1) {
-		if (inter.begin()==inter.end()) {
+		if (chainer->inter.begin()==chainer->inter.end()) {
 			nextInterPointRow = INF;
 			if (DEBUG) { fprintf(stderr,"\nORHERE"); }
 		} else {
-			intersectionPoint = (inter.begin())->first;
+			intersectionPoint = (chainer->inter.begin())->first;
 			nextInterPointRow = intersectionPoint.seq1;
 			if (DEBUG) { fprintf(stderr,"\nHERE"); }
 		}
@@ -81,40 +80,47 @@ int main(int, char **argv) {
 		if (nextStartRow <= nextEndRow) {
 			//CHANGE HERE
 			if (nextStartRow<nextInterPointRow) {
-				nextStartRow=startPointHandler();
+				nextStartRow=startPointHandler(chainer);
 
 				if (nextStartRow == INF) {
 					//break;
 					break_flag = 1;
 				}
 			} else {
-				intersectionPointHandler();
+				intersectionPointHandler(chainer);
 			}
 		} else {
 			//CHANGE HERE
 			if (nextEndRow<nextInterPointRow) {
-				nextEndRow=endPointHandler();
+				nextEndRow=endPointHandler(chainer);
 				if (break_flag == 1) {
 					break;
 				}
 			} else {
-				intersectionPointHandler();
+				intersectionPointHandler(chainer);
 			}
 		}
 	}
 
-	if (DEBUG) { fprintf(stderr,"\nMAX CHAIN\n"); }
-	printChain(max_score_index);
+	// the fragments are copied out of the run, so the links are not
+	for (current = chainer->max_score_index; current; current = current->back) {
+		if (current == &chainer->LI_dummy || current == &chainer->RI_origin) { break; }
+		chain.push_back(*current);
+		chain.back().back = NULL;
+	}
 
-	//fprintf(stderr,"\nALL\n");
-	//printAllFragments(numFragments);
-	return 0;
+	delete chainer;
+	return chain.size();
 }
 
 
 //Processes till the row number reaches the argument
-long long int startPointHandler() {
-	static long long int current=0;
+long long int startPointHandler(Chainer *chainer) {
+	vector<Point> &startPoints = chainer->startPoints;
+	RI *RI_regions = chainer->RI_regions;
+	LI *LI_regions = chainer->LI_regions;
+	const ScoreTable *scores = chainer->scores;
+	long long int &current = chainer->nextStart;
 	Fragment *owner;
 	long long int current_seq1= startPoints[current].seq1;
 	float current_score;
@@ -132,25 +138,25 @@ long long int startPointHandler() {
 
 		owner=LILookUpOwnerStart(&LI_regions[possibleCase],startPoints[current].frag);
 
-		current_score = fragmentSetScore(startPoints[current].frag, owner, &LI_regions[possibleCase], NULL, FALSE);
+		current_score = fragmentSetScore(scores, startPoints[current].frag, owner, &LI_regions[possibleCase], NULL, FALSE);
 
 		owner = lookUpOwnerStart(&RI_regions[possibleCase], startPoints[current].frag);
 
-		current_score = fragmentSetScore(startPoints[current].frag, owner, NULL, &RI_regions[possibleCase], TRUE);
+		current_score = fragmentSetScore(scores, startPoints[current].frag, owner, NULL, &RI_regions[possibleCase], TRUE);
 
 		upStrand = NEGATIVE;
 		possibleCase = downStrand << DOWNSTRANDSHIFT | upStrand <<UPSTRANDSHIFT | relPos << RELPOSSHIFT;
 
 		owner = lookUpOwnerStart(&RI_regions[possibleCase], startPoints[current].frag);
 
-		current_score = fragmentSetScore(startPoints[current].frag, owner, NULL,&RI_regions[possibleCase], TRUE);
+		current_score = fragmentSetScore(scores, startPoints[current].frag, owner, NULL,&RI_regions[possibleCase], TRUE);
 		if (DEBUG) { fprintf(stderr, "HI1"); }
 
 		owner = LILookUpOwnerStart(&LI_regions[possibleCase],startPoints[current].frag);
-		current_score = fragmentSetScore(startPoints[current].frag, owner, &LI_regions[possibleCase], NULL, FALSE);
+		current_score = fragmentSetScore(scores, startPoints[current].frag, owner, &LI_regions[possibleCase], NULL, FALSE);
 		if (DEBUG) { fprintf(stderr, "HI2"); }
 
-		current_score = fragmentSetScore(startPoints[current].frag, unrelatedFrag, NULL, NULL, 3);
+		current_score = fragmentSetScore(scores, startPoints[current].frag, chainer->unrelatedFrag, NULL, NULL, 3);
 		if (DEBUG) { fprintf(stderr, "HI3"); }
 
 		if ((startPoints[current].frag)->back == NULL) {
@@ -161,16 +167,16 @@ long long int startPointHandler() {
 			fprintf(stderr, "Score for the owner fragment is::%f", startPoints[current].frag->back->totalScore);
 		}
 
-		if (startPoints[current].frag->totalScore > max_score) {
-			max_score = startPoints[current].frag->totalScore;
-			max_score_index = startPoints[current].frag ;
+		if (startPoints[current].frag->totalScore > chainer->max_score) {
+			chainer->max_score = startPoints[current].frag->totalScore;
+			chainer->max_score_index = startPoints[current].frag ;
 		}
 
 		current++;
 
 		if (DEBUG) { fprintf(stderr,"\ncurrent fragment is %lld",current); }
 		
-		if (current>=2*numFragments) {
+		if (current>=2*chainer->numFragments) {
 			return INF;
 		}
 	}
@@ -181,8 +187,10 @@ long long int startPointHandler() {
 
 //takes as arguements the start row number and the end row number and processes all the rows
 //This would usually have to find the case
-long long int endPointHandler() {
-	static long long int current=0;
+long long int endPointHandler(Chainer *chainer) {
+	vector<Point> &endPoints = chainer->endPoints;
+	long long int numFragments = chainer->numFragments;
+	long long int &current = chainer->nextEnd;
 
 	long long int current_seq1= endPoints[current].seq1;
 
@@ -223,13 +231,13 @@ long long int endPointHandler() {
 			for (relPos=0;relPos<2;relPos++) {
 				possibleCase = downStrand << DOWNSTRANDSHIFT | upStrand <<UPSTRANDSHIFT | relPos<< RELPOSSHIFT;
 
-				RICommitEndPoint(&RI_regions[possibleCase],endPoints[current].frag);
-				LICommitPoint(&LI_regions[possibleCase],endPoints[current].frag);
+				RICommitEndPoint(&chainer->RI_regions[possibleCase],endPoints[current].frag);
+				LICommitPoint(&chainer->LI_regions[possibleCase],endPoints[current].frag);
 			}
 		}
 
-		if (endPoints[current].frag->totalScore > unrelatedFrag->totalScore)
-		unrelatedFrag = endPoints[current].frag;
+		if (endPoints[current].frag->totalScore > chainer->unrelatedFrag->totalScore)
+		chainer->unrelatedFrag = endPoints[current].frag;
 
 		current++;
 	}
@@ -238,21 +246,19 @@ long long int endPointHandler() {
 }
 
 
-void intersectionPointHandler() {
+void intersectionPointHandler(Chainer *chainer) {
 	long long int current_seq1;
-	Point p,curr;
+	Point p;
 
-	p=inter.begin()->first;
+	p=chainer->inter.begin()->first;
 
 	current_seq1=p.seq1;
 
 	if (DEBUG) { fprintf(stderr,"\nIntersection PointHandler"); }
 	do {
-		// printState(&LI_regions[0]);
-		HandleOneIntersectionPoint();
+		// printState(&chainer->LI_regions[0]);
+		HandleOneIntersectionPoint(&chainer->inter);
 
-		//printState(&LI_regions[0]);
-		p=inter.begin()->first;
-		current_seq1=p.seq1;
-	} while (current_seq1==curr.seq1);
+		//printState(&chainer->LI_regions[0]);
+	} while (!chainer->inter.empty() && chainer->inter.begin()->first.seq1 == current_seq1);
 }
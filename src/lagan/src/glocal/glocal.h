@@ -1,7 +1,10 @@
 #ifndef GLOCAL
 #define GLOCAL
 
-#define DEBUG 1
+// Traces the sweep to stderr. The standalone program is built with it, see Makefile
+#ifndef DEBUG
+#define DEBUG 0
+#endif
 
 #ifndef LLONG_MAX
 // limits.h entries from ISO C99
@@ -15,9 +18,31 @@
 #include<leftinfluence.h>
 #include<score.h>
 
-long long int startPointHandler();
-long long int endPointHandler();
-float fragmentSetScore(Fragment * current,Fragment *owner);
-void intersectionPointHandler();
+// Everything one chaining run works on. Runs own their state and only read the score
+// table, so runs on different inputs may go on in parallel.
+typedef struct Chainer {
+	vector<Fragment> fragments;
+	vector<Point> startPoints;
+	vector<Point> endPoints;
+	long long int numFragments;
+	InterPoint inter;
+	RI RI_regions[1<<(UPSTRANDBITS+DOWNSTRANDBITS+RELPOSBITS)];
+	LI LI_regions[1<<(UPSTRANDBITS+DOWNSTRANDBITS+RELPOSBITS)];
+	const struct ScoreTable *scores;
+	Name allNames;
+	Fragment LI_dummy;
+	Fragment RI_origin, RI_end;
+	Fragment *unrelatedFrag;
+	Fragment *max_score_index;
+	float max_score;
+	long long int nextStart, nextEnd;
+} Chainer;
+
+// Chains the fragments (made with createFragment) and stores the best chain from its last
+// fragment back to its first. Returns the number of fragments in the chain.
+long long int glocalChain(const vector<Fragment> &input, const struct ScoreTable *scores, vector<Fragment> &chain);
+long long int startPointHandler(Chainer *chainer);
+long long int endPointHandler(Chainer *chainer);
+void intersectionPointHandler(Chainer *chainer);
 
 #endif
@@ -3,11 +3,6 @@
 #include<io.h>
 #include<algorithm>
 
-extern vector <Fragment> fragments;
-extern vector <Point> startPoints;
-extern vector <Point> endPoints;
-extern Name allNames;
-
 bool PointCompare(const Point &f1, const Point &f2) {
 	if (f1.seq1 < f2.seq1) {
 		return (f1.seq1 < f2.seq1);
@@ -99,10 +94,10 @@ void printFragment ( Fragment * curfrag ) {
 }
 
 
-void printAllFragments(long long int numFragments) {
+void printAllFragments(Chainer *chainer) {
 	long long int i;
-	for (i=0; i<numFragments; i++) {
-		printFragment(&fragments[i]);
+	for (i=0; i<chainer->numFragments; i++) {
+		printFragment(&chainer->fragments[i]);
 	}
 	return;
 }
@@ -161,7 +156,7 @@ Fragment createFragment(hll *temp) {
 
 
 // reads the input file and returns the number of fragments read.
-long long int readInput(char * fileName) {
+long long int readInput(char * fileName, vector<Fragment> &fragments) {
 	hll tempInput;
 	FILE * fp;
 	long long int i=0;
@@ -204,13 +199,19 @@ long long int readInput(char * fileName) {
 }
 
 
-void createPointLists(long long int numFragments) {
+void createPointLists(Chainer *chainer) {
+	vector<Fragment> &fragments = chainer->fragments;
+	vector<Point> &startPoints = chainer->startPoints;
+	vector<Point> &endPoints = chainer->endPoints;
 	long long int i;
 	Point startPoint, endPoint;
 
 	//SLAGANCHANGE:: Push -seq2,seq1 on the start list as well.
 
-	for (i=0; i<numFragments; i++) {
+	startPoints.reserve(2*chainer->numFragments + 1);
+	endPoints.reserve(chainer->numFragments + 1);
+
+	for (i=0; i<chainer->numFragments; i++) {
 		startPoint.seq1 = fragments[i].seq1Start;
 		startPoint.seq2 = fragments[i].seq2Start;
 		endPoint.seq1 = fragments[i].seq1End;
@@ -225,10 +226,20 @@ void createPointLists(long long int numFragments) {
 	}
 	sort(startPoints.begin(), startPoints.end(), PointCompare);
 	sort(endPoints.begin(), endPoints.end(), PointCompare);
+
+	// the handlers read one point past the last row they process
+	startPoint.seq1 = endPoint.seq1 = INF;
+	startPoint.seq2 = endPoint.seq2 = INF;
+	startPoint.frag = endPoint.frag = NULL;
+	startPoints.push_back(startPoint);
+	endPoints.push_back(endPoint);
 }
 
 
-void printPointLists(long long int numFragments) {
+void printPointLists(Chainer *chainer) {
+	vector<Point> &startPoints = chainer->startPoints;
+	vector<Point> &endPoints = chainer->endPoints;
+	long long int numFragments = chainer->numFragments;
 	long long int i;
 	printf("StartPoint lists:\n");
 
@@ -244,7 +255,10 @@ void printPointLists(long long int numFragments) {
 }
 
 
-void findAllNames(long long int numFragments) {
+void findAllNames(Chainer *chainer) {
+	vector<Fragment> &fragments = chainer->fragments;
+	Name &allNames = chainer->allNames;
+	long long int numFragments = chainer->numFragments;
 	long long int i;
 	long long int size;
 	long long int numContigs=0;
@@ -268,7 +282,8 @@ void findAllNames(long long int numFragments) {
 }
 
 
-void decideContigBase() {
+void decideContigBase(Chainer *chainer) {
+	Name &allNames = chainer->allNames;
 	Name::iterator currName;
 	long long int offset =0;
 	long long int temp;
@@ -281,11 +296,12 @@ void decideContigBase() {
 }
 
 
-void storeIterators(long long int numFragments) {
+void storeIterators(Chainer *chainer) {
+	vector<Fragment> &fragments = chainer->fragments;
 	long long int i;
 
-	for (i=0; i<numFragments; i++) {
-		fragments[i].nameIter = allNames.find(fragments[i].seq2Name);
+	for (i=0; i<chainer->numFragments; i++) {
+		fragments[i].nameIter = chainer->allNames.find(fragments[i].seq2Name);
 		fragments[i].seq2Start += (fragments[i].nameIter)->second;
 		fragments[i].seq2End += (fragments[i].nameIter)->second;
 		fragments[i].base = (fragments[i].nameIter)->second;
@@ -10,13 +10,14 @@
 
 
 long long int printChain(Fragment *current);
-long long int readInput(char * fileName);
-void printAllFragments( long long int numFragments);
-void createPointLists(long long int numFragments);
-void printPointLists(long long int numFragments);
+long long int readInput(char * fileName, vector<Fragment> &fragments);
+Fragment createFragment(hll *temp);
+void printAllFragments(struct Chainer *chainer);
+void createPointLists(struct Chainer *chainer);
+void printPointLists(struct Chainer *chainer);
 void printFragment ( Fragment * curfrag );
-void findAllNames(long long int numFragments);
-void storeIterators(long long int numFragments);
-void decideContigBase();
+void findAllNames(struct Chainer *chainer);
+void storeIterators(struct Chainer *chainer);
+void decideContigBase(struct Chainer *chainer);
 
 #endif
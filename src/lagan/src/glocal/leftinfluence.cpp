@@ -1,6 +1,5 @@
 #include<leftinfluence.h>
-
-Fragment LI_dummy;
+#include<score.h>
 
 // Returns the fragment who is the owner of the region in which the current point is
 Owner::iterator LILookUpOwnerIterator(LI * LeftInfluence, long long int seq1, long long int seq2) {
@@ -35,7 +34,7 @@ Fragment * LILookUpOwnerEnd(LI * LeftInfluence,Fragment * current) {
 	Owner::iterator own = LILookUpOwnerIterator(LeftInfluence, current->seq1End, current->getSeq2End(LeftInfluence->reflectFlag));
 
 	if (own == (LeftInfluence->o).end()) {
-		return &LI_dummy;
+		return LeftInfluence->dummy;
 	} else {
 		return *own;
 	}
@@ -46,7 +45,7 @@ Fragment * LILookUpOwnerStart(LI * LeftInfluence, Fragment * current) {
 	Owner::iterator own = LILookUpOwnerIterator(LeftInfluence, current->seq1Start, current->getSeq2Start(LeftInfluence->reflectFlag));
 
 	if (own == (LeftInfluence->o).end()) {
-		return &LI_dummy;
+		return LeftInfluence->dummy;
 	} else {
 		return *own;
 	}
@@ -76,7 +75,7 @@ Fragment * LICOwner(LI * LeftInfluence, long long int seq1, long long int seq2)
 	citer = LICColumn(LeftInfluence, seq1, seq2);
 
 	if (citer == (LeftInfluence->c).end()) {
-		return &LI_dummy;
+		return LeftInfluence->dummy;
 	} else {
 		return *(citer->second);
 	}
@@ -88,7 +87,7 @@ Fragment * LIDOwner(LI * LeftInfluence, long long int seq1, long long int seq2)
 	diter = LIDDiagonal(LeftInfluence, seq1, seq2);
 
 	if (diter == (LeftInfluence->d).end()) {
-		return &LI_dummy;
+		return LeftInfluence->dummy;
 	} else {
 		return *(diter->second);
 	}
@@ -124,13 +123,16 @@ float LILookUpScore(LI * LeftInfluence, Fragment * current) {
 		//MUKCHECK
 		return -1;
 	} else {
-		return scoreAll(owner,current,LeftInfluence->scoreIndex);
+		return scoreAll(LeftInfluence->scores,owner,current,LeftInfluence->scoreIndex);
 	}
 }
 
 
-void InitLI(LI * LeftInfluence, long long int scoreIndex) {
+void InitLI(LI * LeftInfluence, long long int scoreIndex, InterPoint *inter, Fragment *dummy, const ScoreTable *scores) {
 	LeftInfluence->scoreIndex = scoreIndex;
+	LeftInfluence->inter = inter;
+	LeftInfluence->dummy = dummy;
+	LeftInfluence->scores = scores;
 
 	if (((scoreIndex >> RELPOSSHIFT) & 1) == LEFT) {
 		LeftInfluence->reflectFlag = TRUE;
@@ -138,12 +140,12 @@ void InitLI(LI * LeftInfluence, long long int scoreIndex) {
 		LeftInfluence->reflectFlag = FALSE;
 	}
 
-	LI_dummy.score = -1;
-	LI_dummy.totalScore = 0;
-	LI_dummy.back = NULL;
+	dummy->score = -1;
+	dummy->totalScore = 0;
+	dummy->back = NULL;
 
 	//there will be a list of structures to insert this into
-	(LeftInfluence->o).insert((LeftInfluence->o).begin(), &LI_dummy);
+	(LeftInfluence->o).insert((LeftInfluence->o).begin(), dummy);
 }
 
 
@@ -163,7 +165,7 @@ long long int LI_Winner(LI * LeftInfluence, Fragment * first, Fragment * second)
 		dummy.nameIter = second->nameIter;
 	}
 
-	if (scoreAll(first, &dummy, LeftInfluence->scoreIndex) >= scoreAll(second, &dummy, LeftInfluence->scoreIndex)) {
+	if (scoreAll(LeftInfluence->scores, first, &dummy, LeftInfluence->scoreIndex) >= scoreAll(LeftInfluence->scores, second, &dummy, LeftInfluence->scoreIndex)) {
 		return TRUE;
 	} else {
 		return FALSE;
@@ -247,24 +249,24 @@ long long int LI_CommitDiagonalOwner(LI * LeftInfluence, Fragment * current, Fra
 
 			tempowner = LI_OwnerInsertAfter(LeftInfluence, current_diagonal->second, current);
 			(LeftInfluence->c)[current->getSeq2End(LeftInfluence->reflectFlag)] = tempowner;
-			(LeftInfluence->ci)[current->getSeq2End(LeftInfluence->reflectFlag)] = inter.end();
+			(LeftInfluence->ci)[current->getSeq2End(LeftInfluence->reflectFlag)] = LeftInfluence->inter->end();
 			my_col_inter = (LeftInfluence->ci).find(current->getSeq2End(LeftInfluence->reflectFlag));
 
 			tempowner = LI_OwnerInsertAfter(LeftInfluence, tempowner, owner);
 
 			(LeftInfluence->d)[current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End] = tempowner;
-			(LeftInfluence->di)[current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End] = inter.end();
+			(LeftInfluence->di)[current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End] = LeftInfluence->inter->end();
 			my_diag_inter = (LeftInfluence->di).find(current->getSeq2End(LeftInfluence->reflectFlag)-current->seq1End);
 
 			if (next_column!= (LeftInfluence->c).end()) {
 				next_column_inter = (LeftInfluence->ci).find(next_column->first);
 
-				if (next_column_inter->second == current_diag_inter->second && current_diag_inter->second!=inter.end()) {
-					DeleteIntersectionPoint(next_column_inter->second, next_column_inter, current_diag_inter);
+				if (next_column_inter->second == current_diag_inter->second && current_diag_inter->second!=LeftInfluence->inter->end()) {
+					DeleteIntersectionPoint(LeftInfluence, next_column_inter->second, next_column_inter, current_diag_inter);
 					CreateIntersectionPoint(LeftInfluence, next_column->first,
                                             current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End,
                                             next_column_inter, my_diag_inter);
-				} else if (next_column_inter->second == inter.end()) {
+				} else if (next_column_inter->second == LeftInfluence->inter->end()) {
 					CreateIntersectionPoint(LeftInfluence, next_column->first,
                                             current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End,
                                             next_column_inter, my_diag_inter);
@@ -287,7 +289,7 @@ long long int LI_CommitDiagonalOwner(LI * LeftInfluence, Fragment * current, Fra
 			own++;
 			tempowner = (LeftInfluence->o).insert(own, current);
 			(LeftInfluence->c)[current->getSeq2End(LeftInfluence->reflectFlag)] = tempowner;
-			(LeftInfluence->ci)[current->getSeq2End(LeftInfluence->reflectFlag)] = inter.end();
+			(LeftInfluence->ci)[current->getSeq2End(LeftInfluence->reflectFlag)] = LeftInfluence->inter->end();
 			colInter = (LeftInfluence->ci).find(current->getSeq2End(LeftInfluence->reflectFlag));
 
 			//There is no diagonal here
@@ -303,7 +305,7 @@ long long int LI_CommitDiagonalOwner(LI * LeftInfluence, Fragment * current, Fra
 				prevDiag--;
 
 				prevDiagInter = (LeftInfluence->di).find(prevDiag->first);
-				if (prevDiagInter->second == inter.end()) {
+				if (prevDiagInter->second == LeftInfluence->inter->end()) {
 					CreateIntersectionPoint(LeftInfluence, current->getSeq2End(LeftInfluence->reflectFlag),
                                             prevDiag->first, colInter, prevDiagInter);
 				}
@@ -320,7 +322,7 @@ long long int LI_CommitDiagonalOwner(LI * LeftInfluence, Fragment * current, Fra
 		//The intersection point processing removes the entry?!
 
 		(LeftInfluence->d)[current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End] = next_column->second;
-		(LeftInfluence->di)[current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End] = inter.end();
+		(LeftInfluence->di)[current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End] = LeftInfluence->inter->end();
 		my_diag_inter = (LeftInfluence->di).find(current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End);
 
 		next_column->second = tempowner;
@@ -331,7 +333,7 @@ long long int LI_CommitDiagonalOwner(LI * LeftInfluence, Fragment * current, Fra
 		if (next_column!= (LeftInfluence->c).end()) {
 			next_column_inter =(LeftInfluence->ci).find(next_column->first);
 
-			if (next_column_inter->second == inter.end()) {
+			if (next_column_inter->second == LeftInfluence->inter->end()) {
 				CreateIntersectionPoint(LeftInfluence, next_column->first,
                                         current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End,
                                         next_column_inter, my_diag_inter);
@@ -354,12 +356,12 @@ long long int LI_CommitColumnOwner(LI * LeftInfluence, Fragment * current, Fragm
 		//Init has already put in one fragment
 		tempowner = LI_OwnerInsertAfter(LeftInfluence, (LeftInfluence->o).begin(), current);
 		(LeftInfluence->c)[current->getSeq2End(LeftInfluence->reflectFlag)] = tempowner;
-		(LeftInfluence->ci)[current->getSeq2End(LeftInfluence->reflectFlag)] = inter.end();
+		(LeftInfluence->ci)[current->getSeq2End(LeftInfluence->reflectFlag)] = LeftInfluence->inter->end();
 
 		//FIX #5 FIRST MAJOR FIX
-		tempowner = LI_OwnerInsertAfter(LeftInfluence, tempowner, &LI_dummy);
+		tempowner = LI_OwnerInsertAfter(LeftInfluence, tempowner, LeftInfluence->dummy);
 		(LeftInfluence->d)[current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End] = tempowner;
-		(LeftInfluence->di)[current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End] = inter.end();
+		(LeftInfluence->di)[current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End] = LeftInfluence->inter->end();
 		return TRUE;
 	}
 
@@ -386,12 +388,12 @@ long long int LI_CommitColumnOwner(LI * LeftInfluence, Fragment * current, Fragm
 		}
 
 		(LeftInfluence->c)[current->getSeq2End(LeftInfluence->reflectFlag)] = tempowner;
-		(LeftInfluence->ci)[current->getSeq2End(LeftInfluence->reflectFlag)] = inter.end();
+		(LeftInfluence->ci)[current->getSeq2End(LeftInfluence->reflectFlag)] = LeftInfluence->inter->end();
 		//This is inefficient
 		colInter = (LeftInfluence->ci).find(current->getSeq2End(LeftInfluence->reflectFlag));
 		tempowner = LI_OwnerInsertAfter(LeftInfluence, tempowner, owner);
 		(LeftInfluence->d)[current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End] = tempowner;
-		(LeftInfluence->di)[current->getSeq2End(LeftInfluence->reflectFlag)-current->seq1End] = inter.end();
+		(LeftInfluence->di)[current->getSeq2End(LeftInfluence->reflectFlag)-current->seq1End] = LeftInfluence->inter->end();
 
 		//This is inefficient
 		diagInter = (LeftInfluence->di).find(current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End);
@@ -400,7 +402,7 @@ long long int LI_CommitColumnOwner(LI * LeftInfluence, Fragment * current, Fragm
 		if (next_column != (LeftInfluence->c).end()) {
 			nextColInter = (LeftInfluence->ci).find(next_column->first);
 
-			if (nextColInter->second == inter.end()) {
+			if (nextColInter->second == LeftInfluence->inter->end()) {
 				CreateIntersectionPoint(LeftInfluence, next_column->first,
                                         current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End, nextColInter, diagInter);
 			}
@@ -415,7 +417,7 @@ long long int LI_CommitColumnOwner(LI * LeftInfluence, Fragment * current, Fragm
 		tempowner = (LeftInfluence->o).insert(next_column->second, current);
 		(LeftInfluence->d)[current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End] = next_column->second;
 		//FIX #6 SECOND MAJOR FIX
-		(LeftInfluence->di)[current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End] = inter.end();
+		(LeftInfluence->di)[current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End] = LeftInfluence->inter->end();
 
 		//I dont think that i need this
 		diagInter = (LeftInfluence->di).find(current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End);
@@ -427,7 +429,7 @@ long long int LI_CommitColumnOwner(LI * LeftInfluence, Fragment * current, Fragm
 		if (next_column != (LeftInfluence->c).end()) {
 			nextColInter = (LeftInfluence->ci).find(next_column->first);
 
-			if (nextColInter->second == inter.end()) {
+			if (nextColInter->second == LeftInfluence->inter->end()) {
 				CreateIntersectionPoint(LeftInfluence, next_column->first,
                                         current->getSeq2End(LeftInfluence->reflectFlag) - current->seq1End, nextColInter, diagInter);
 			}
@@ -445,22 +447,22 @@ void CreateIntersectionPoint(LI * LeftInfluence, long long int col, long long in
 	temp.seq2 = col;
 
 	pair<Point,LI*> pairp(temp, LeftInfluence);
-	tempinter = inter.insert(pairp);
+	tempinter = LeftInfluence->inter->insert(pairp);
 
 	colInter->second = tempinter;
 	diagInter->second = tempinter;
 }
 
 
-void DeleteIntersectionPoint(InterPoint::iterator tobeerased, CInter::iterator colInter, DInter::iterator diagInter) {
-	inter.erase(tobeerased);
-	colInter->second = inter.end();
-	diagInter->second = inter.end();
+void DeleteIntersectionPoint(LI * LeftInfluence, InterPoint::iterator tobeerased, CInter::iterator colInter, DInter::iterator diagInter) {
+	LeftInfluence->inter->erase(tobeerased);
+	colInter->second = LeftInfluence->inter->end();
+	diagInter->second = LeftInfluence->inter->end();
 }
 
 
 // handles one intersection point that is at the head of inter
-void HandleOneIntersectionPoint() {
+void HandleOneIntersectionPoint(InterPoint *inter) {
 	InterPoint::iterator head;
 	Owner::iterator delOwner, leftOwner, rightOwner;
 
@@ -469,7 +471,7 @@ void HandleOneIntersectionPoint() {
 	DInter::iterator prevDiagInter, diagInter;
 	DBound::iterator diag, prevDiag;
 
-	head = inter.begin();
+	head = inter->begin();
 
 	LI * LeftInfluence;
 
@@ -519,16 +521,16 @@ void HandleOneIntersectionPoint() {
 
 		if (nextCol != (LeftInfluence->c).end()) {
 			// the column exists
-			if (nextColInter->second == inter.end()) {
+			if (nextColInter->second == inter->end()) {
 				// the column is not involved in an intersection
-				diagInter->second = inter.end();
+				diagInter->second = inter->end();
 				CreateIntersectionPoint(LeftInfluence, nextCol->first, diag->first, nextColInter, diagInter);
 			} else {
 				//should unset the diagonal
-				diagInter->second = inter.end();
+				diagInter->second = inter->end();
 			}
 		} else {
-			diagInter->second = inter.end();
+			diagInter->second = inter->end();
 		}
 	} else {
 		if (DEBUG) { fprintf(stderr, "\nIn HandleOneIter Column continues %f %f %f", (*delOwner)->score, (*leftOwner)->score, (*rightOwner)->score); }
@@ -546,23 +548,23 @@ void HandleOneIntersectionPoint() {
 				exit(0);
 			}
 
-			if (prevDiagInter->second == inter.end()) {
+			if (prevDiagInter->second == inter->end()) {
 				// the diagonal is not involved in an intersection
-				colInter->second = inter.end();
+				colInter->second = inter->end();
 				CreateIntersectionPoint(LeftInfluence, col->first,prevDiag->first, colInter, prevDiagInter);
 			} else {
 				//should unset the column flag
-				colInter->second = inter.end();
+				colInter->second = inter->end();
 			}
 		} else {
-			colInter->second = inter.end();
+			colInter->second = inter->end();
 		}
 	}
 
 	//delete the owner
 	(LeftInfluence->o).erase(delOwner);
 
-	inter.erase(inter.begin());
+	inter->erase(inter->begin());
 }
 
 
@@ -622,15 +624,15 @@ void printState(LI * LeftInfluence) {
 	ownerCount = printOwners(LeftInfluence);
 	colCount = printCBound(LeftInfluence);
 	diagCount = printDBound(LeftInfluence);
-	interPointPrint();
+	interPointPrint(LeftInfluence->inter);
 }
 
 
-void interPointPrint() {
+void interPointPrint(InterPoint *inter) {
 	if (DEBUG) { return; }
 	InterPoint::iterator i;
 	fprintf(stderr, "\nThe Inter is ::");
-	for (i = inter.begin(); i != inter.end(); i++) {
+	for (i = inter->begin(); i != inter->end(); i++) {
 		fprintf(stderr, "%lld %lld  ", (i->first).seq1, (i->first).seq2);
 	}
 	fprintf(stderr, "Inter Done/n");
@@ -2,7 +2,6 @@
 #define LEFTINFLUENCE
 
 #include<structs.h>
-#include<score.h>
 
 struct LI;
 
@@ -60,15 +59,13 @@ typedef struct LI
   DInter di;
   long long int scoreIndex;
   long long int reflectFlag;
-
-  
+  //state shared by the regions of one chaining run
+  InterPoint *inter;
+  Fragment *dummy;
+  const struct ScoreTable *scores;
 }LI;
 
 
-extern InterPoint inter;
- 
-
-
 
 
 Owner::iterator LILookUpOwnerIterator(LI* LeftInfluence,long long int seq1,long long int seq2) ;
@@ -79,21 +76,21 @@ Fragment *LICOwner(LI* LeftInfluence,long long int seq1, long long int seq2);
 Fragment *LIDOwner(LI* LeftInfluence,long long int seq1, long long int seq2);
 DBound::iterator LIDDiagonal(LI* LeftInfluence,long long int seq1, long long int seq2);
 float LILookUpScore(LI *LeftInfluence,Fragment *current);
-void InitLI(LI* LeftInfluence, long long int scoreIndex);
+void InitLI(LI* LeftInfluence, long long int scoreIndex, InterPoint *inter, Fragment *dummy, const struct ScoreTable *scores);
 long long int LI_Winner(LI* LeftInfluence,Fragment * first,Fragment * second);
 long long int LICommitPoint(LI *LeftInfluence,Fragment *current);
 Owner::iterator LI_OwnerInsertAfter(LI* LeftInfluence,Owner::iterator current,Fragment * curfrag);
 long long int  LI_CommitDiagonalOwner(LI* LeftInfluence,Fragment *current,Fragment *owner);
 long long int  LI_CommitColumnOwner(LI* LeftInfluence,Fragment *current,Fragment *owner);
 void CreateIntersectionPoint(LI* LeftInfluence,long long int col,long long int diag,CInter::iterator colInter,DInter::iterator diagInter);
-void DeleteIntersectionPoint(InterPoint::iterator tobeerased,CInter::iterator colInter,DInter::iterator diagInter);
-void HandleOneIntersectionPoint();
+void DeleteIntersectionPoint(LI* LeftInfluence,InterPoint::iterator tobeerased,CInter::iterator colInter,DInter::iterator diagInter);
+void HandleOneIntersectionPoint(InterPoint *inter);
 
 long long int printDBound(LI * LeftInfluence);
 long long int printOwners(LI * LeftInfluence);
 long long int printCBound(LI * LeftInfluence);
 void printState(LI* LeftInfluence);
-void interPointPrint();
+void interPointPrint(InterPoint *inter);
 
 
 
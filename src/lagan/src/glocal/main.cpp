@@ -0,0 +1,22 @@
+#include<glocal.h>
+
+int main(int, char **argv) {
+	vector<Fragment> fragments;
+	vector<Fragment> chain;
+	ScoreTable scores;
+	unsigned long long int i;
+
+	readInput(argv[1], fragments);
+	initScoreFunctionPointers(argv[2], &scores);
+
+	glocalChain(fragments, &scores, chain);
+
+	if (DEBUG) { fprintf(stderr,"\nMAX CHAIN\n"); }
+	for (i=0; i<chain.size(); i++) {
+		printFragment(&chain[i]);
+	}
+
+	//fprintf(stderr,"\nALL\n");
+	freeScoreFunctions(&scores);
+	return 0;
+}
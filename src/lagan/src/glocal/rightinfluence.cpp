@@ -1,10 +1,10 @@
 #include <rightinfluence.h>
-
-Fragment origin, end;
+#include <score.h>
 
 // Sets the first default owner of the whole region
-void initRI(RI *RightInfluence, long long int scoreIndex) {
+void initRI(RI *RightInfluence, long long int scoreIndex, const ScoreTable *scores, Fragment *origin, Fragment *end) {
 	RightInfluence->scoreIndex = scoreIndex;
+	RightInfluence->scores = scores;
 
 	if (((scoreIndex >> RELPOSSHIFT) & 1) == LEFT) {
 		RightInfluence->reflectFlag = TRUE;
@@ -13,22 +13,22 @@ void initRI(RI *RightInfluence, long long int scoreIndex) {
 	}
 
 	// will lose to anyone
-	origin.seq1End = 0; origin.seq2End = 0;
-    origin.seq1Start = 0; origin.seq2Start = 0;
+	origin->seq1End = 0; origin->seq2End = 0;
+    origin->seq1Start = 0; origin->seq2Start = 0;
 
 	// hack to aid winner selection
-	origin.score = -1;
-	end.score = -2;
-	origin.totalScore = end.totalScore = 0;
+	origin->score = -1;
+	end->score = -2;
+	origin->totalScore = end->totalScore = 0;
 
 	// will win against anyone
-	end.seq1End = 0; end.seq2End = 0;
-	end.seq1Start = 0; end.seq2Start = 0;
+	end->seq1End = 0; end->seq2End = 0;
+	end->seq1Start = 0; end->seq2Start = 0;
 
-	origin.back = NULL;
+	origin->back = NULL;
 
-    RightInfluence->act[-INF] = &origin;
-    RightInfluence->act[+INF] = &end;
+    RightInfluence->act[-INF] = origin;
+    RightInfluence->act[+INF] = end;
 }
 
 
@@ -40,7 +40,7 @@ float lookUpScore(RI * RightInfluence, Fragment * current) {
 	owner = lookUpOwnerStart(RightInfluence, current);
 
 	// return the score using the appropriate score function
-	return scoreAll(owner, current, RightInfluence->scoreIndex);
+	return scoreAll(RightInfluence->scores, owner, current, RightInfluence->scoreIndex);
 }
 
 
@@ -86,7 +86,7 @@ long long int RIWinner(RI * RightInfluence, Fragment * first, Fragment * second)
 		dummy.nameIter = second->nameIter;
 	}
 
-	if (scoreAll(first, &dummy, RightInfluence->scoreIndex) > scoreAll(second, &dummy, RightInfluence->scoreIndex)) {
+	if (scoreAll(RightInfluence->scores, first, &dummy, RightInfluence->scoreIndex) > scoreAll(RightInfluence->scores, second, &dummy, RightInfluence->scoreIndex)) {
 		return TRUE;
 	} else {
 		return FALSE;
@@ -116,39 +116,6 @@ long long int RICommitEndPoint(RI * RightInfluence, Fragment * current) {
     //inserting into the list of active owners
 	RightInfluence->act[current->getSeq2End(RightInfluence->reflectFlag) - current->seq1End] = current;
 
-int possibleCase = NEGATIVE << DOWNSTRANDSHIFT | NEGATIVE <<UPSTRANDSHIFT | LEFT << RELPOSSHIFT;
-if (RightInfluence->scoreIndex == possibleCase) {
-    Active::iterator j,i = RightInfluence->act.begin();
-    i++;
-    while(i != RightInfluence->act.end()) {
-        //    if (i == NULL) { continue;}
-        j = i;
-        j++;
-        if (j != RightInfluence->act.end()) {
-            if ((*j).second->score == -2) { break;} // j is act.end (why does the check above fail?)
-            if ((*i).second->totalScore > (*j).second->totalScore) {
-                /*                fprintf(stdout,"Assertion failed in RICommitEndPoint: Cur frag:\n");
-                printFragment(current);
-                fprintf(stdout,"Cur orig owner:\n");
-                printFragment(tempOwner);
-                fprintf(stdout,"Cur frag diag: %lld\n", (current->getSeq2End(RightInfluence->reflectFlag) - current->seq1End));
-                fprintf(stdout,"    Frag 1 in pair (j):\n    ");
-                printFragment((*j).second);
-                fprintf(stdout,"    Frag 2 in pair (i):\n    ");
-                printFragment((*i).second);
-                fprintf(stdout,"RI:\n");
-                printActive(RightInfluence);
-                assert (0);
-                */
-                break;
-                //            assert(i->first->score >= j->first->score);
-            }
-         }
-        i++;
-    }
-}
- 
-
     return 1;
 }
 
@@ -2,8 +2,6 @@
 #define RIGHTINFLUENCE
 
 #include<structs.h>
-#include<io.h>
-#include<score.h>
 
 
 struct longlongCompare {
@@ -24,10 +22,11 @@ typedef struct RI {
   Active  act;
   long long int scoreIndex;
   long long int reflectFlag;   
+  const struct ScoreTable *scores;
 } RI;
 
 
-void initRI(RI *RightInfluence,long long int scoreIndex);
+void initRI(RI *RightInfluence,long long int scoreIndex,const struct ScoreTable *scores,Fragment *origin,Fragment *end);
 float lookUpScore(RI * RightInfluence,Fragment *current);
 Fragment* lookUpOwnerEnd(RI * RightInfluence,Fragment *current);
 Fragment* lookUpOwnerStart(RI * RightInfluence,Fragment *current);
@@ -4,8 +4,6 @@
 #include<rightinfluence.h>
 #include<fstream>
 
-extern vector<class Score*> scoreFunctions[1<<(UPSTRANDBITS+DOWNSTRANDBITS+RELPOSBITS)];
-
 
 float Score::getScore(Fragment *up, Fragment * down) {
 	long long int absSeq1,absSeq2,absDiagonal,absMin,absMax;
@@ -35,7 +33,7 @@ Score::Score (float iopenConstant , float iminConstant ,float imaxConstant,float
 }
 
 
-void initScoreFunctionPointers(char * scoreFileName) {
+void initScoreFunctionPointers(char * scoreFileName, ScoreTable *scores) {
 	ifstream SFP;
 	char line[255];
 
@@ -49,11 +47,11 @@ void initScoreFunctionPointers(char * scoreFileName) {
 	while (1) {
 		SFP.getline(line,255);
 		if (line[0]=='\0') { break; }
-		createScoreFunctionObjects(line);
+		createScoreFunctionObjects(line, scores);
 	}
 }
 
-void createScoreFunctionObjects(char * line) {
+void createScoreFunctionObjects(char * line, ScoreTable *scores) {
 	long long int i;
 	long long int j;
 	long long int rem[4];
@@ -109,12 +107,28 @@ void createScoreFunctionObjects(char * line) {
 
 	for (i=0; i<numCases; i++) {
 		for (j=0; j<numObjects; j++) {
-			scoreFunctions[cases[i]].push_back(SFObjects[j]);
+			scores->cases[cases[i]].push_back(SFObjects[j]);
 		}
 	}
 }
 
 
+// the objects of a line are shared by its cases
+void freeScoreFunctions(ScoreTable *scores) {
+	set<Score*> objects;
+	unsigned long long int i;
+
+	for (i=0; i<sizeof(scores->cases)/sizeof(scores->cases[0]); i++) {
+		objects.insert(scores->cases[i].begin(), scores->cases[i].end());
+		scores->cases[i].clear();
+	}
+
+	for (set<Score*>::iterator it = objects.begin(); it != objects.end(); it++) {
+		delete *it;
+	}
+}
+
+
 long long int charToCase(char in) {
 	switch(in) {
 		case '+': return POSITIVE;
@@ -132,7 +146,7 @@ long long int charToCase(char in) {
 }
 
 
-float scoreAll(Fragment * up, Fragment * down, long long int ret_case) {
+float scoreAll(const ScoreTable *scores, Fragment * up, Fragment * down, long long int ret_case) {
 	unsigned long long int i;
 //  TODO TODO TODO
 	float ret_score=NEGINF;
@@ -146,8 +160,8 @@ float scoreAll(Fragment * up, Fragment * down, long long int ret_case) {
 		}
 	}
 
-	for (i=0; i<scoreFunctions[ret_case].size(); i++) {
-		temp_score = scoreFunctions[ret_case][i]->getScore(up,down);
+	for (i=0; i<scores->cases[ret_case].size(); i++) {
+		temp_score = scores->cases[ret_case][i]->getScore(up,down);
 
 		if (temp_score > ret_score) {
 			ret_score = temp_score;
@@ -177,12 +191,12 @@ long long int Myabs(long long int a) {
 }
 
 
-float fragmentSetScore(Fragment * current, Fragment *owner, LI *LeftInfluence, RI * RightInfluence, long long int rightInfluenceFlag) {
+float fragmentSetScore(const ScoreTable *scores, Fragment * current, Fragment *owner, LI *LeftInfluence, RI * RightInfluence, long long int rightInfluenceFlag) {
 	/*SLAGANCHANGE change call to the score based on the Leftinfluence, this has to be passed i guess*/
 	float tempScore;
 
 	if (rightInfluenceFlag == 3) {
-		tempScore = scoreAll(owner,current, current->strand << DOWNSTRANDSHIFT | owner->strand <<UPSTRANDSHIFT | UNRELATED<< RELPOSSHIFT);
+		tempScore = scoreAll(scores,owner,current, current->strand << DOWNSTRANDSHIFT | owner->strand <<UPSTRANDSHIFT | UNRELATED<< RELPOSSHIFT);
         if (tempScore == NEGINF) { // TODO
             if (current->totalScore <= 0) {
                 current->totalScore = current->score;
@@ -194,7 +208,7 @@ float fragmentSetScore(Fragment * current, Fragment *owner, LI *LeftInfluence, R
 			current->back = owner;
 		}
 	} else if (rightInfluenceFlag == TRUE) {
-		tempScore = scoreAll(owner,current,RightInfluence->scoreIndex);
+		tempScore = scoreAll(scores,owner,current,RightInfluence->scoreIndex);
 
         if (tempScore == NEGINF) { // TODO
             if (current->totalScore <= 0) {
@@ -207,7 +221,7 @@ float fragmentSetScore(Fragment * current, Fragment *owner, LI *LeftInfluence, R
 			current->back = owner;
 		}
 	} else {
-		tempScore = scoreAll(owner,current,LeftInfluence->scoreIndex);
+		tempScore = scoreAll(scores,owner,current,LeftInfluence->scoreIndex);
         
         if (tempScore == NEGINF) { // TODO
             if (current->totalScore <= 0) {
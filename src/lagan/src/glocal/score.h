@@ -27,13 +27,20 @@ class Score :public ScoreInterface {
 };
 
 
-void initScoreFunctionPointers(char *scoreFileName);
-void  createScoreFunctionObjects(char * line);
+// Score functions of every case, read once and shared by any number of chaining runs
+typedef struct ScoreTable {
+	vector<class Score*> cases[1<<(UPSTRANDBITS+DOWNSTRANDBITS+RELPOSBITS)];
+} ScoreTable;
+
+
+void initScoreFunctionPointers(char *scoreFileName, ScoreTable *scores);
+void  createScoreFunctionObjects(char * line, ScoreTable *scores);
+void freeScoreFunctions(ScoreTable *scores);
 long long int charToCase(char in);
-float scoreAll(Fragment *up,Fragment *down, long long int ret_case);
+float scoreAll(const ScoreTable *scores,Fragment *up,Fragment *down, long long int ret_case);
 long long int Myabs(long long int a);
 long long int Mymin(long long int a,long long int b);
 long long int Mymax(long long int a,long long int b);
-float fragmentSetScore(Fragment * current,Fragment *owner,LI *LeftInfluence, RI * RightInfluence,long long int rightInfluenceFlag);
+float fragmentSetScore(const ScoreTable *scores,Fragment * current,Fragment *owner,LI *LeftInfluence, RI * RightInfluence,long long int rightInfluenceFlag);
 
 #endif
@@ -89,4 +89,8 @@ typedef struct Point {
 	Fragment *frag;
 } Point;
 
+
+struct Chainer;
+struct ScoreTable;
+
 #endif
@@ -0,0 +1,179 @@
+#include <stdlib.h>
+#include <string.h>
+#include "skiplist.h"
+#include "kmerindex.h"
+
+int kcode(char c) {
+  switch (c) {
+  case 'A': return 0;
+  case 'C': return 1;
+  case 'G': return 2;
+  case 'T': return 3;
+  }
+  return -1;
+}
+
+int hashWord(kword word, int shift) {
+  return (int)((word * 0x9E3779B97F4A7C15ULL) >> shift);
+}
+
+int findWord(KIndex* index, kword word) {
+  int i = hashWord(word, index->hashshift);
+  while (index->table[i] >= 0) {
+    if (index->words[index->table[i]] == word)
+      return index->table[i];
+    i = (i + 1) & (index->tablesize - 1);
+  }
+  return -1;
+}
+
+KIndex* makeKmerIndex(char* str, int wordlen) {
+  KIndex* index;
+  kword word = 0, mask;
+  int* wordof;
+  int n = strlen(str), numpos = 0, valid = 0, i, j, w, total;
+
+  if (wordlen < 1 || wordlen > KI_MAX_WORDLEN)
+    return 0;
+  mask = (wordlen == KI_MAX_WORDLEN) ? ~0ULL : ((1ULL << (2 * wordlen)) - 1);
+  index = (KIndex*) malloc (sizeof(KIndex));
+  index->wordlen = wordlen;
+  index->numwords = 0;
+  index->tablesize = 16;
+  index->hashshift = 60;
+  while (index->tablesize < 2 * n) {
+    index->tablesize *= 2;
+    index->hashshift--;
+  }
+  index->table = (int*) malloc (sizeof(int) * index->tablesize);
+  for (i = 0; i < index->tablesize; i++)
+    index->table[i] = -1;
+  index->words = (kword*) malloc (sizeof(kword) * (n + 1));
+  wordof = (int*) malloc (sizeof(int) * (n + 1));
+
+  /* the same words the trie gets from insertString, in the order of their locations */
+  for (i = 0; i < n; i++) {
+    if (kcode(str[i]) < 0) {
+      valid = 0;
+      continue;
+    }
+    word = ((word << 2) | kcode(str[i])) & mask;
+    if (++valid < wordlen)
+      continue;
+    j = hashWord(word, index->hashshift);
+    while (index->table[j] >= 0 && index->words[index->table[j]] != word)
+      j = (j + 1) & (index->tablesize - 1);
+    if (index->table[j] < 0) {
+      index->table[j] = index->numwords;
+      index->words[index->numwords++] = word;
+    }
+    wordof[numpos++] = index->table[j];
+  }
+
+  index->locators = (locs*) malloc (sizeof(locs) * (index->numwords + 1));
+  index->locations = (int*) malloc (sizeof(int) * (numpos + 1));
+  for (w = 0; w < index->numwords; w++)
+    index->locators[w].locssize = 0;
+  for (i = 0; i < numpos; i++)
+    index->locators[wordof[i]].locssize++;
+  for (w = total = 0; w < index->numwords; w++) {
+    index->locators[w].locs = index->locations + total;
+    index->locators[w].numlocs = 0;
+    total += index->locators[w].locssize;
+  }
+  for (i = valid = numpos = 0; i < n; i++) {
+    valid = (kcode(str[i]) < 0) ? 0 : valid + 1;
+    if (valid >= wordlen) {
+      w = wordof[numpos++];
+      index->locators[w].locs[index->locators[w].numlocs++] = i - wordlen + 1;
+    }
+  }
+  free(wordof);
+  return index;
+}
+
+void freeKmerIndex(KIndex* index) {
+  free(index->table);
+  free(index->words);
+  free(index->locators);
+  free(index->locations);
+  free(index);
+}
+
+void addWord(KIndex* index, kword word, int numdeg, int* deg, LList*** tail) {
+  LList* res;
+  int i, w = findWord(index, word);
+  if (w < 0)
+    return;
+  res = (LList*) malloc (sizeof(LList));
+  res->myloc = &(index->locators[w]);
+  res->degleft = numdeg;
+  /* offsets from the last letter, as makeLList stores them */
+  for (i = 0; i < numdeg; i++)
+    res->degloc[i] = (char *)(long)(index->wordlen - 1 - deg[i]);
+  res->next = 0;
+  **tail = res;
+  *tail = &(res->next);
+}
+
+/* Words that differ from word in at most ndegen letters from position p on.
+   Letters outside of the alphabet (bad) are stored as 0 and must differ. */
+void addNeighbours(KIndex* index, kword word, char* bad, int numbad, int p, int numdeg, int* deg,
+		   int ndegen, LList*** tail) {
+  int q, c, shift;
+  kword old;
+  if (numbad > ndegen - numdeg)
+    return;
+  if (!numbad)
+    addWord(index, word, numdeg, deg, tail);
+  if (numdeg == ndegen)
+    return;
+  for (q = p; q < index->wordlen; q++) {
+    shift = 2 * (index->wordlen - 1 - q);
+    old = (word >> shift) & 3;
+    deg[numdeg] = q;
+    for (c = 0; c < 4; c++) {
+      if (!bad[q] && c == old)
+	continue;
+      addNeighbours(index, (word & ~(3ULL << shift)) | ((kword) c << shift), bad, numbad - bad[q],
+		    q + 1, numdeg + 1, deg, ndegen, tail);
+    }
+    if (bad[q])
+      break;
+  }
+}
+
+int getNextWordsBatch(KIndex* index, char* str, int from, int count, int ndegen, LList** res) {
+  char bad[KI_MAX_WORDLEN];
+  int deg[MAX_DEGEN];
+  int wordlen = index->wordlen, first, numbad = 0, filled, i, q;
+  kword word = 0, mask;
+  LList** tail;
+
+  if (ndegen > MAX_DEGEN)
+    ndegen = MAX_DEGEN;
+  mask = (wordlen == KI_MAX_WORDLEN) ? ~0ULL : ((1ULL << (2 * wordlen)) - 1);
+  memset(bad, 0, sizeof(bad));
+  first = (from >= wordlen) ? from - wordlen + 1 : 0;
+  for (i = first; i < from; i++) {
+    word = ((word << 2) | (kcode(str[i]) < 0 ? 0 : kcode(str[i]))) & mask;
+    numbad += kcode(str[i]) < 0;
+  }
+  for (filled = 0; filled < count && str[from + filled]; filled++) {
+    i = from + filled;
+    word = ((word << 2) | (kcode(str[i]) < 0 ? 0 : kcode(str[i]))) & mask;
+    numbad += kcode(str[i]) < 0;
+    if (i - wordlen >= first)
+      numbad -= kcode(str[i - wordlen]) < 0;
+    res[filled] = 0;
+    if (i < wordlen - 1 || numbad > ndegen)
+      continue;
+    for (q = 0; numbad && q < wordlen; q++)
+      bad[q] = kcode(str[i - wordlen + 1 + q]) < 0;
+    tail = &res[filled];
+    addNeighbours(index, word, bad, numbad, 0, 0, deg, ndegen, &tail);
+    if (numbad)
+      memset(bad, 0, sizeof(bad));
+  }
+  return filled;
+}
@@ -0,0 +1,36 @@
+#ifndef __KMERINDEX_H
+#define __KMERINDEX_H
+
+#include "thrtrie.h"
+
+/* Flat alternative to the threaded trie: the words of the query are packed
+   two bits per letter and kept in an open addressing hash table, their
+   locations are stored in one array grouped by word. Only the nucleotide
+   alphabet is supported, so words are at most KI_MAX_WORDLEN long. */
+
+#define KI_MAX_WORDLEN 32
+#define KI_BATCH 1024
+
+typedef unsigned long long kword;
+
+typedef struct KmerIndex {
+  int wordlen;
+  int numwords;
+  int tablesize;
+  int hashshift;    /* 64 - log2(tablesize) */
+  int* table;       /* index of the word or -1 */
+  kword* words;
+  locs* locators;   /* locs of the word i point into locations */
+  int* locations;
+} KIndex;
+
+KIndex* makeKmerIndex(char* str, int wordlen);
+void freeKmerIndex(KIndex* index);
+
+/* Fills res[0..] with the words ending at str[from], str[from+1], ... that
+   differ from the words of the index in at most ndegen letters, like
+   consecutive calls of getNextWords do. Stops after count positions or at
+   the end of str, returns the number of positions filled. */
+int getNextWordsBatch(KIndex* index, char* str, int from, int count, int ndegen, LList** res);
+
+#endif
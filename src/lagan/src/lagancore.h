@@ -0,0 +1,91 @@
+#ifndef __LAGANCORE_H
+#define __LAGANCORE_H
+
+/* Common prologue of the library translation units. Each of them includes
+   the C sources of one program inside its own namespace, so the system
+   headers are pulled in here first, the globals become thread-local and
+   the diagnostics the programs print to stderr go to the null device. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <assert.h>
+#include <limits.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <smmintrin.h>
+#endif
+#include "liblagan.h"
+#include "rechaos.h"
+
+#ifdef _MSC_VER
+#define LAGAN_TLS __declspec(thread)
+#define LAGAN_NULL_DEVICE "NUL"
+#else
+#define LAGAN_TLS __thread
+#define LAGAN_NULL_DEVICE "/dev/null"
+#endif
+
+#define register
+
+namespace Lagan
+{
+	inline FILE * NullStream()
+	{
+		static FILE * null = fopen(LAGAN_NULL_DEVICE, "w");
+		return null ? null : stderr;
+	}
+
+	struct Chunk
+	{
+		int x;
+		int y;
+		int length;
+		int score;
+	};
+
+	//A CHAOS hit as printed by "chaos -pairs", coordinates are 1-based
+	struct Hit
+	{
+		int start1;
+		int end1;
+		int start2;
+		int end2;
+		float score;
+		std::vector<Chunk> chunk;
+	};
+
+	struct Region
+	{
+		int start1;
+		int end1;
+		int start2;
+		int end2;
+	};
+
+	struct ChaosParams
+	{
+		int wordLength;
+		int degeneracy;
+		int cutoff;
+		int rescoreCutoff;
+		bool gapFreeChunks;
+	};
+
+	//Runs "chaos seq1 seq2 -ext -pairs" with the given regions and parameters
+	void ChaosRound(const std::string & seq1, const std::string & seq2, const ChaosParams & params,
+		const std::vector<Region> & region, std::vector<Hit> & hit);
+}
+
+#undef stderr
+#define stderr Lagan::NullStream()
+
+#endif
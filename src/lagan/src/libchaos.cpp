@@ -0,0 +1,192 @@
+#include "lagancore.h"
+
+namespace Lagan
+{
+	namespace Chaos
+	{
+#define CHAOS__FLAG
+#define main ChaosMain
+#include "fchaos.c"
+#include "thrtrie.c"
+#include "kmerindex.c"
+#include "skiplist.c"
+#include "global.c"
+#include "translate.c"
+#include "filebuffer.c"
+#undef main
+	}
+
+	namespace
+	{
+		//Nucleotide part of nucmatrix.txt, CHAOS doubles its gap scores
+		const char NUC_LETTER[] = "ACGT.N";
+		const int NUC_SCORE[6][6] =
+		{
+			{91, -114, -31, -123, 0, -43},
+			{-114, 100, -125, -31, 0, -43},
+			{-31, -125, 100, -114, 0, -43},
+			{-123, -31, -114, 91, 0, -43},
+			{0, 0, 0, 0, 0, 0},
+			{-43, -43, -43, -43, 0, -43}
+		};
+
+		const int NUC_GAP_CONT = -25;
+
+		bool Init()
+		{
+			for (int i = 0; i < 6; i++)
+			{
+				for (int j = 0; j < 6; j++)
+				{
+					Chaos::substmatrix[(unsigned char)NUC_LETTER[i]][(unsigned char)NUC_LETTER[j]] = NUC_SCORE[i][j];
+				}
+			}
+
+			Chaos::gappenstart = Chaos::gappenext = NUC_GAP_CONT * 2;
+			Chaos::init = 1;
+			return true;
+		}
+
+		//FileRead(..., VER_FCHAOS) of a whole sequence
+		Chaos::seq * MakeSeq(const std::string & str)
+		{
+			char map[256];
+			for (int i = 0; i < 256; i++)
+			{
+				map[i] = strchr(Chaos::alphabet, toupper(i)) != 0 ? toupper(i) : 'N';
+			}
+
+			int numNs = 0;
+			Chaos::seq * ret = (Chaos::seq*)malloc(sizeof(Chaos::seq));
+			ret->rptr = (char*)malloc(str.size() + 1);
+			for (size_t i = 0; i < str.size(); i++)
+			{
+				numNs += str[i] == 'N';
+				ret->rptr[i] = map[(unsigned char)str[i]];
+			}
+
+			ret->rptr[str.size()] = 0;
+			ret->lets = ret->rptr;
+			ret->numlets = static_cast<int>(str.size());
+			ret->numsiglets = ret->numlets - numNs;
+			ret->leftbound = ret->rightbound = 0;
+			ret->name = 0;
+			return ret;
+		}
+
+		//Restricts the sequence to [start, end] the way procPairs does
+		char Restrict(Chaos::seq * s, int start, int end)
+		{
+			char ret = s->rptr[end];
+			s->rptr[end] = 0;
+			s->lets = s->rptr + start - 1;
+			s->numlets = end - start + 1;
+			return ret;
+		}
+	}
+
+	//Body of the "-pairs" loop of the CHAOS main with printHLL for '+' hits
+	void ChaosRound(const std::string & seq1, const std::string & seq2, const ChaosParams & params,
+		const std::vector<Region> & region, std::vector<Hit> & hit)
+	{
+		using namespace Chaos;
+		static const bool ready = Init();
+		hit.clear();
+		wordlen = params.wordLength;
+		ndegen = params.degeneracy;
+		cutoff = params.cutoff;
+		reScoreCutoff = params.rescoreCutoff;
+		gapfreechunks = params.gapFreeChunks;
+		extend = 1;
+		direction = '+';
+		seq * query = MakeSeq(seq1);
+		seq * dbase = MakeSeq(seq2);
+		for (size_t r = 0; r < region.size(); r++)
+		{
+			const Region & pair = region[r];
+			if (pair.end1 - pair.start1 + 1 < wordlen + 1 && pair.end2 - pair.start2 + 1 < wordlen + 1)
+			{
+				continue;
+			}
+
+			s1start = pair.start1;
+			s1end = pair.end1;
+			s2start = pair.start2;
+			s2end = pair.end2;
+			char save1 = Restrict(query, s1start, s1end);
+			char save2 = Restrict(dbase, s2start, s2end);
+			//Exact words are the same in the flat index and in the trie, degenerate
+			//ones are not, the trie misses some of them
+			TNode * root = 0;
+			KIndex * index = ndegen == 0 ? makeKmerIndex(query->lets, wordlen) : 0;
+			if (!index)
+			{
+				root = makeTrie(wordlen, triealpha);
+				insertString(root, query->lets);
+			}
+
+			mylist = makeSkLst();
+			doAlgo(root, index, query, dbase);
+			allhits = removeDups(allhits, query, dbase);
+			while (allhits)
+			{
+				hll * res = allhits;
+				Hit now;
+				now.start1 = res->seq1start + s1start;
+				now.end1 = res->seq1end + s1start;
+				now.start2 = res->seq2start + s2start;
+				now.end2 = res->seq2end + s2start;
+				now.score = res->score;
+				if (gapfreechunks)
+				{
+					int currx = now.start1;
+					int curry = now.start2;
+					for (gfc * tmpgf = res->first; tmpgf; )
+					{
+						if (tmpgf->length)
+						{
+							Chunk chunk = {currx, curry, tmpgf->length, tmpgf->score};
+							now.chunk.push_back(chunk);
+							currx += tmpgf->length;
+							curry += tmpgf->length;
+						}
+
+						tmpgf = tmpgf->next;
+						if (tmpgf)
+						{
+							if (tmpgf->offset > 0)
+							{
+								curry += tmpgf->offset;
+							}
+							else
+							{
+								currx -= tmpgf->offset;
+							}
+						}
+					}
+				}
+
+				hit.push_back(now);
+				allhits = res->next;
+				freeHLL(res);
+			}
+
+			if (index)
+			{
+				freeKmerIndex(index);
+			}
+			else
+			{
+				freeTrie(root);
+			}
+
+			delSkLst(mylist);
+			free(mylist);
+			query->rptr[s1end] = save1;
+			dbase->rptr[s2end] = save2;
+		}
+
+		freeSeq(query);
+		freeSeq(dbase);
+	}
+}
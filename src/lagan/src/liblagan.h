@@ -0,0 +1,31 @@
+#ifndef __LIBLAGAN_H
+#define __LIBLAGAN_H
+
+#include <string>
+#include <vector>
+
+/* In-process versions of the LAGAN drivers. The programs are compiled into
+   separate namespaces with thread-local globals (see threadlocal.h), so the
+   calls below are reentrant and produce exactly what the scripts print. */
+namespace Lagan
+{
+	struct Anchor
+	{
+		int start1;
+		int end1;
+		int start2;
+		int end2;
+		float score;
+	};
+
+	//Anchors of rechaos.pl in ascending order, gapFreeChunks is its -gfc flag
+	void FindAnchors(const std::string & seq1, const std::string & seq2, bool gapFreeChunks, std::vector<Anchor> & anchor);
+	//Rows of "lagan.pl seq1 seq2 -mfa"
+	void AlignPair(const std::string & seq1, const std::string & seq2, std::string & row1, std::string & row2);
+	//Rows of "mlagan seq1 ... seqn" in the order it prints them, row i belongs to
+	//seq[order[i]]. Names are the FASTA headers that mlagan uses to build the guide tree,
+	//only their first 255 chars are kept. Throws std::runtime_error if the tree can't be read
+	void AlignMultiple(const std::vector<std::string> & seq, const std::vector<std::string> & name, std::vector<std::string> & row, std::vector<size_t> & order);
+}
+
+#endif
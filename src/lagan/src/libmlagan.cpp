@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <stdexcept>
+#include "lagancore.h"
+
+namespace Lagan
+{
+	namespace Multial
+	{
+#define MULTIAL__FLAG
+#define main MlaganMain
+#include "multial.c"
+//The programs define MIN2 with different, equivalent bodies
+#undef MIN2
+#include "diagmatrix.c"
+#include "skiplist.c"
+#include "filebuffer.c"
+#undef MIN2
+#include "mlagan.c"
+#undef main
+	}
+
+	namespace
+	{
+		//Nucleotide part of nucmatrix.txt, readSubstMatrix splits the gap
+		//opening score between the start and the end of a gap
+		const char NUC_LETTER[] = "ACGT.N";
+		const int NUC_SCORE[6][6] =
+		{
+			{91, -114, -31, -123, 0, -43},
+			{-114, 100, -125, -31, 0, -43},
+			{-31, -125, 100, -114, 0, -43},
+			{-123, -31, -114, 91, 0, -43},
+			{0, 0, 0, 0, 0, 0},
+			{-43, -43, -43, -43, 0, -43}
+		};
+
+		const int NUC_GAP_START = -400;
+		const int NUC_GAP_CONT = -25;
+		//treeToRPN reads the names of the guide tree into a buffer of 256 chars
+		const size_t MAX_NAME_LENGTH = 255;
+
+		bool Init()
+		{
+			for (int i = 0; i < 6; i++)
+			{
+				for (int j = 0; j < 6; j++)
+				{
+					Multial::substmatrix[(unsigned char)NUC_LETTER[i]][(unsigned char)NUC_LETTER[j]] = NUC_SCORE[i][j];
+				}
+			}
+
+			Multial::readit = 1;
+			Multial::init = 1;
+			return true;
+		}
+
+		//FileRead(..., VER_MLAGAN) of a whole sequence
+		Multial::seq * MakeSeq(const std::string & str, const std::string & name, int index)
+		{
+			char map[256];
+			for (int i = 0; i < 256; i++)
+			{
+				map[i] = strchr(Multial::alphabet, toupper(i)) != 0 ? toupper(i) : 'N';
+			}
+
+			int numNs = 0;
+			Multial::seq * ret = (Multial::seq*)malloc(sizeof(Multial::seq));
+			ret->rptr = (char*)malloc(str.size() + 2);
+			ret->rptr[0] = 'N';
+			for (size_t i = 0; i < str.size(); i++)
+			{
+				numNs += str[i] == 'N';
+				ret->rptr[i + 1] = map[(unsigned char)str[i]];
+			}
+
+			ret->rptr[str.size() + 1] = 0;
+			ret->lets = ret->rptr;
+			ret->numlets = static_cast<int>(str.size()) + 1;
+			ret->numsiglets = ret->numlets - numNs;
+			size_t length = std::min(name.size(), MAX_NAME_LENGTH);
+			ret->name = (char*)malloc(length + 1);
+			memcpy(ret->name, name.data(), length);
+			ret->name[length] = 0;
+			ret->filename = 0;
+			ret->leftbound = ret->rightbound = 0;
+			ret->index = index;
+			return ret;
+		}
+
+		//Anchors as getAnchsFromFile reads the output of rechaos.pl
+		Multial::hll * MakeAnchors(const std::string & seq1, const std::string & seq2)
+		{
+			std::vector<Anchor> anchor;
+			FindAnchors(seq1, seq2, false, anchor);
+			Multial::hll * ret = 0;
+			for (size_t i = anchor.size(); i > 0; i--)
+			{
+				Multial::hll * tt = (Multial::hll*)calloc(1, sizeof(Multial::hll));
+				tt->seq1start = anchor[i - 1].start1;
+				tt->seq1end = anchor[i - 1].end1;
+				tt->seq2start = anchor[i - 1].start2;
+				tt->seq2end = anchor[i - 1].end2;
+				tt->score = anchor[i - 1].score;
+				tt->next = ret;
+				ret = tt;
+			}
+
+			return ret;
+		}
+	}
+
+	void AlignMultiple(const std::vector<std::string> & seq, const std::vector<std::string> & name, std::vector<std::string> & row, std::vector<size_t> & order)
+	{
+		using namespace Multial;
+		static const bool ready = Init();
+		int n = static_cast<int>(seq.size());
+		row.assign(n, std::string());
+		order.assign(n, 0);
+		if (n == 1)
+		{
+			Multial::seq * single = MakeSeq(seq[0], name[0], 1);
+			row[0].assign(single->lets + 1, single->lets + single->numlets);
+			freeSequence(single);
+			return;
+		}
+
+		if (n == 0)
+		{
+			return;
+		}
+
+		//The pairs are independent and the anchor search keeps its state per thread
+		std::vector<hll*> table(n * n, static_cast<hll*>(0));
+		#pragma omp parallel for schedule(dynamic)
+		for (int k = 0; k < n * n; k++)
+		{
+			if (k / n < k % n)
+			{
+				table[k] = MakeAnchors(seq[k / n], seq[k % n]);
+			}
+		}
+
+		gapstart = NUC_GAP_START - NUC_GAP_START / 2 + NUC_GAP_CONT;
+		gapend = NUC_GAP_START / 2;
+		gapcont = NUC_GAP_CONT;
+		gapperseq = -1;
+		overlap = 0;
+		glwidth = 15;
+		numseqs = n;
+		std::vector<Multial::seq*> seqs(n);
+		std::vector<align*> myaligns(n), simalign(n);
+		simaligns = &simalign[0];
+		for (int i = 0; i < n; i++)
+		{
+			seqs[i] = MakeSeq(seq[i], name[i], i + 1);
+			myaligns[i] = simaligns[i] = mkSimAlign(seqs[i]);
+			simaligns[i]->index = i;
+			simaligns[i]->hlls = (hll**)calloc(n, sizeof(hll*));
+			for (int j = i + 1; j < n; j++)
+			{
+				simaligns[i]->hlls[j] = table[i * n + j];
+			}
+		}
+
+		int depth = 0;
+		std::vector<align*> stack(n * 2, static_cast<align*>(0));
+		char * treestr = graphCollapsal(&myaligns[0]);
+		if (treeToRPN(treestr, &stack[0], &depth) < 0)
+		{
+			for (int i = 0; i < n; i++)
+			{
+				freeAlign(simaligns[i]);
+				freeSequence(seqs[i]);
+			}
+
+			free(treestr);
+			simaligns = 0;
+			throw std::runtime_error("mlagan cannot build the guide tree of the block");
+		}
+
+		align * final = procStack(&stack[0], depth, &myaligns[0]);
+		for (int i = 0; i < final->numseq; i++)
+		{
+			int inds = 1;
+			std::string & now = row[i];
+			order[i] = final->seqs[i]->index - 1;
+			for (int k = 1; k < final->algnlen; k++)
+			{
+				now.push_back(!isGap(final, i, k) ? final->seqs[i]->lets[inds++] : '-');
+			}
+		}
+
+		freeAlign(final);
+		for (int i = 0; i < n; i++)
+		{
+			freeAlign(simaligns[i]);
+			freeSequence(seqs[i]);
+		}
+
+		free(treestr);
+		simaligns = 0;
+	}
+}
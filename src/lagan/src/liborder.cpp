@@ -0,0 +1,124 @@
+#include "lagancore.h"
+
+namespace Lagan
+{
+	namespace Order
+	{
+#define main OrderMain
+#include "order.c"
+//The programs define MIN2 with different, equivalent bodies
+#undef MIN2
+#include "diagmatrix.c"
+#include "filebuffer.c"
+#undef main
+	}
+
+	namespace
+	{
+		//Nucleotide part of nucmatrix.txt with its gap scores
+		const char NUC_LETTER[] = "ACGT.N";
+		const int NUC_SCORE[6][6] =
+		{
+			{91, -114, -31, -123, 0, -43},
+			{-114, 100, -125, -31, 0, -43},
+			{-31, -125, 100, -114, 0, -43},
+			{-123, -31, -114, 91, 0, -43},
+			{0, 0, 0, 0, 0, 0},
+			{-43, -43, -43, -43, 0, -43}
+		};
+
+		const int NUC_GAP_START = -400;
+		const int NUC_GAP_CONT = -25;
+		const int LEADING_PAD = 8;
+
+		bool Init()
+		{
+			for (int i = 0; i < 6; i++)
+			{
+				for (int j = 0; j < 6; j++)
+				{
+					Order::substmatrix[(unsigned char)NUC_LETTER[i]][(unsigned char)NUC_LETTER[j]] = NUC_SCORE[i][j];
+				}
+			}
+
+			return true;
+		}
+
+		//FileRead(..., VER_ORDER) of a whole sequence
+		Order::seq * MakeSeq(const std::string & str)
+		{
+			char map[256];
+			for (int i = 0; i < 256; i++)
+			{
+				map[i] = strchr(Order::alphabet, toupper(i)) != 0 ? toupper(i) : 'N';
+			}
+
+			//makeAlign looks a few letters before the sequence at the border of
+			//the matrix, the program reads the zero bytes of the malloc header there
+			Order::seq * ret = (Order::seq*)malloc(sizeof(Order::seq));
+			ret->rptr = (char*)calloc(str.size() + LEADING_PAD + 2, 1);
+			ret->lets = ret->rptr + LEADING_PAD;
+			for (size_t i = 0; i < str.size(); i++)
+			{
+				ret->lets[i + 1] = map[(unsigned char)str[i]];
+			}
+
+			ret->numlets = static_cast<int>(str.size());
+			ret->name = 0;
+			return ret;
+		}
+	}
+
+	void AlignPair(const std::string & seq1, const std::string & seq2, std::string & row1, std::string & row2)
+	{
+		using namespace Order;
+		static const bool ready = Init();
+		std::vector<Anchor> anchor;
+		FindAnchors(seq1, seq2, true, anchor);
+		seq * first = MakeSeq(seq1);
+		seq * second = MakeSeq(seq2);
+		s1start = 1;
+		s1end = first->numlets;
+		s2start = 1;
+		s2end = second->numlets;
+		gapstart = NUC_GAP_START;
+		gapcont = NUC_GAP_CONT;
+		overlap = 0;
+		glwidth = 15;
+		hll * myres = 0;
+		for (size_t i = anchor.size(); i > 0; i--)
+		{
+			hll * tt = (hll*)malloc(sizeof(hll));
+			tt->seq1start = anchor[i - 1].start1;
+			tt->seq1end = anchor[i - 1].end1;
+			tt->seq2start = anchor[i - 1].start2;
+			tt->seq2end = anchor[i - 1].end2;
+			myres = addAnc(myres, tt, first, second);
+		}
+
+		dmat * mydm = makeDM(first->numlets + 1, second->numlets + 1);
+		shapeAncs(mydm, first, second, myres);
+		align * a = makeAlign(mydm, first->lets, second->lets);
+		row1.clear();
+		row2.clear();
+		for (int c = 1, s1 = 1, s2 = 1; c < a->algnlen; c++)
+		{
+			row1.push_back(a->algn[c] != DELETION ? first->lets[s1++] : '-');
+			row2.push_back(a->algn[c] != INSERTION ? second->lets[s2++] : '-');
+		}
+
+		while (myres)
+		{
+			hll * next = myres->next;
+			free(myres);
+			myres = next;
+		}
+
+		freeAlign(a);
+		freeDM(mydm);
+		free(first->rptr);
+		free(first);
+		free(second->rptr);
+		free(second);
+	}
+}
@@ -0,0 +1,311 @@
+#include <algorithm>
+#include "lagancore.h"
+
+namespace Lagan
+{
+	namespace Anchors
+	{
+#define main AnchorsMain
+#include "anchors.c"
+#include "skiplist.c"
+#undef main
+	}
+
+	namespace
+	{
+		//Recursion levels of rechaos.pl without the translated one: word length,
+		//degeneracy, cutoff and rescoring cutoff
+		const int ROUND[][4] = {{12, 0, 25, 0}, {13, 1, 30, 0}, {8, 1, 30, 0}, {7, 1, 30, 0}};
+		const int ROUNDS = sizeof(ROUND) / sizeof(ROUND[0]);
+		const int MIN_BOX = 10;
+		const int MIN_SIDE = 5;
+		const char SENTINEL_LEFT[] = "1.1";
+		const char SENTINEL_RIGHT[] = "1.2";
+
+		//Output line of the anchors program
+		struct Line
+		{
+			int start1;
+			int end1;
+			int start2;
+			int end2;
+			std::string score;
+			std::string text;
+		};
+
+		//Order of "sort -n -k 2,2": the second field starts with the end of the
+		//first range, ties are broken by comparing whole lines
+		bool LineLess(const Line & a, const Line & b)
+		{
+			if (a.end1 != b.end1)
+			{
+				return a.end1 < b.end1;
+			}
+
+			return a.text < b.text;
+		}
+
+		//Scores pass through "%f" when the scripts hand them to the next program
+		float Reparse(float score)
+		{
+			char buf[64];
+			sprintf(buf, "%f", score);
+			return strtof(buf, 0);
+		}
+
+		Anchors::hll * NewAnchor(int start1, int end1, int start2, int end2, float score, Anchors::hll * next)
+		{
+			Anchors::hll * ret = (Anchors::hll*)malloc(sizeof(Anchors::hll));
+			ret->seq2start = start1;
+			ret->seq2end = end1;
+			ret->seq1start = start2;
+			ret->seq1end = end2;
+			ret->score = score;
+			ret->first = ret->last = 0;
+			ret->next = next;
+			ret->bkptr = 0;
+			ret->scoreSoFar = 0;
+			return ret;
+		}
+
+		void PushLine(int start1, int end1, int start2, int end2, const char * score, std::vector<Line> & line)
+		{
+			char buf[256];
+			sprintf(buf, "(%d %d)=(%d %d) %s", start1, end1, start2, end2, score);
+			Line now = {start1, end1, start2, end2, score, buf};
+			line.push_back(now);
+		}
+
+		//The anchors program: parseCHAOS prepends the hits read in this order,
+		//the best chain is printed and then sorted
+		void Chain(const std::vector<Hit> & hit, const std::vector<Line> & carried, bool more, int length1, int length2, std::vector<Line> & line)
+		{
+			using namespace Anchors;
+			hll * mylist = 0;
+			int numhits = 0;
+			for (size_t i = 0; i < hit.size(); i++, numhits++)
+			{
+				mylist = NewAnchor(hit[i].start1, hit[i].end1, hit[i].start2, hit[i].end2, Reparse(hit[i].score), mylist);
+				if (gapfreechunks)
+				{
+					for (size_t j = 0; j < hit[i].chunk.size(); j++)
+					{
+						gfc * temp = (gfc*)malloc(sizeof(gfc));
+						temp->y = hit[i].chunk[j].x;
+						temp->x = hit[i].chunk[j].y;
+						temp->length = hit[i].chunk[j].length;
+						temp->score = hit[i].chunk[j].score;
+						temp->next = mylist->first;
+						mylist->first = temp;
+						if (j == 0)
+						{
+							mylist->last = temp;
+						}
+					}
+				}
+			}
+
+			for (size_t i = 0; i < carried.size(); i++, numhits++)
+			{
+				const Line & now = carried[i];
+				mylist = NewAnchor(now.start1, now.end1, now.start2, now.end2, strtof(now.score.c_str(), 0), mylist);
+			}
+
+			if (more)
+			{
+				mylist = NewAnchor(0, 0, 0, 0, strtof(SENTINEL_LEFT, 0), mylist);
+				mylist = NewAnchor(length1 + 1, length1 + 1, length2 + 1, length2 + 1, strtof(SENTINEL_RIGHT, 0), mylist);
+				numhits += 2;
+			}
+
+			line.clear();
+			if (numhits > 0)
+			{
+				int i = 0;
+				hptr * myptrs = (hptr*)malloc(sizeof(hptr) * numhits * 2);
+				for (hll * temp = mylist; temp; temp = temp->next)
+				{
+					myptrs[i].number = temp->seq1start;
+					myptrs[i].isstart = 1;
+					myptrs[i].myhll = temp;
+					myptrs[i + 1].number = temp->seq1end;
+					myptrs[i + 1].isstart = 0;
+					myptrs[i + 1].myhll = temp;
+					i = i + 2;
+				}
+
+				qsort(myptrs, numhits * 2, sizeof(hptr), hptrcomp);
+				for (hll * temp = findBestChain(myptrs, numhits * 2); temp; temp = temp->bkptr)
+				{
+					char buf[64];
+					if (!gapfreechunks || !temp->first)
+					{
+						sprintf(buf, "%f", temp->score);
+						PushLine(temp->seq2start, temp->seq2end, temp->seq1start, temp->seq1end, buf, line);
+					}
+					else
+					{
+						for (gfc * tmpgf = temp->first; tmpgf; tmpgf = tmpgf->next)
+						{
+							sprintf(buf, "%d", tmpgf->score);
+							PushLine(tmpgf->y, tmpgf->y + tmpgf->length - 1, tmpgf->x, tmpgf->x + tmpgf->length - 1, buf, line);
+						}
+					}
+				}
+
+				free(myptrs);
+			}
+
+			while (mylist)
+			{
+				hll * next = mylist->next;
+				for (gfc * tmpgf = mylist->first; tmpgf; )
+				{
+					gfc * help = tmpgf->next;
+					free(tmpgf);
+					tmpgf = help;
+				}
+
+				free(mylist);
+				mylist = next;
+			}
+
+			std::sort(line.begin(), line.end(), LineLess);
+		}
+
+		int Letters(const std::string & seq)
+		{
+			int ret = 0;
+			for (size_t i = 0; i < seq.size(); i++)
+			{
+				ret += isalpha(static_cast<unsigned char>(seq[i])) || seq[i] == '.' || seq[i] == '-';
+			}
+
+			return ret;
+		}
+
+		bool Init()
+		{
+			Anchors::init = 1;
+			return true;
+		}
+	}
+
+	void FindAnchors(const std::string & seq1, const std::string & seq2, bool gapFreeChunks, std::vector<Anchor> & anchor)
+	{
+		static const bool ready = Init();
+		Anchors::gapopen = Anchors::gapcont = 0;
+		Anchors::gapfreechunks = gapFreeChunks;
+		int length1 = Letters(seq1);
+		int length2 = Letters(seq2);
+		std::vector<Hit> hit;
+		std::vector<Line> line;
+		std::vector<Line> carried;
+		Region all = {1, length1, 1, length2};
+		std::vector<Region> region(1, all);
+		for (int r = 0; r < ROUNDS; r++)
+		{
+			ChaosParams params = {ROUND[r][0], ROUND[r][1], ROUND[r][2], ROUND[r][3], gapFreeChunks};
+			ChaosRound(seq1, seq2, params, region, hit);
+			bool more = r + 1 < ROUNDS;
+			Chain(hit, carried, more, length1, length2, line);
+			if (!more)
+			{
+				break;
+			}
+
+			region.clear();
+			carried.clear();
+			for (size_t m = 1; m < line.size(); m++)
+			{
+				if (m < line.size() - 1)
+				{
+					carried.push_back(line[m]);
+				}
+
+				long long gap1begin = line[m - 1].end1 + 1;
+				long long gap2begin = line[m - 1].end2 + 1;
+				long long gap1end = line[m].start1 - 1;
+				long long gap2end = line[m].start2 - 1;
+				long long boxarea = (gap1end - gap1begin + 1) * (gap2end - gap2begin + 1);
+				if (boxarea >= MIN_BOX && gap1end - gap1begin + 1 > MIN_SIDE && gap2end - gap2begin + 1 > MIN_SIDE &&
+					gap1begin < gap1end && gap2begin < gap2end)
+				{
+					Region now = {static_cast<int>(gap1begin), static_cast<int>(gap1end), static_cast<int>(gap2begin), static_cast<int>(gap2end)};
+					region.push_back(now);
+				}
+			}
+		}
+
+		anchor.clear();
+		for (size_t i = 0; i < line.size(); i++)
+		{
+			Anchor now = {line[i].start1, line[i].end1, line[i].start2, line[i].end2, strtof(line[i].score.c_str(), 0)};
+			anchor.push_back(now);
+		}
+	}
+}
+
+namespace
+{
+	//The first record of a FASTA file as FileRead takes it: the header line is
+	//skipped, whitespace is dropped and the record ends at the next '>'
+	bool ReadFirstRecord(const char * fileName, std::string & seq)
+	{
+		FILE * file = fopen(fileName, "r");
+		if (!file)
+		{
+			return false;
+		}
+
+		int ch = fgetc(file);
+		for (; ch != EOF && ch != '\n'; ch = fgetc(file));
+		for (ch = fgetc(file); ch != EOF && ch != '>'; ch = fgetc(file))
+		{
+			if (ch != ' ' && ch != '\n' && ch != '\r' && ch != '\t' && ch != '\v')
+			{
+				seq.push_back(static_cast<char>(ch));
+			}
+		}
+
+		fclose(file);
+		return true;
+	}
+}
+
+extern "C" int rechaosAnchors(const char * file1, const char * file2, int gfc, LaganAnchor ** anchor)
+{
+	std::string seq[2];
+	const char * file[] = {file1, file2};
+	for (int i = 0; i < 2; i++)
+	{
+		FILE * masked = fopen((std::string(file[i]) + ".masked").c_str(), "r");
+		if (masked)
+		{
+			fclose(masked);
+			return -1;
+		}
+
+		if (!ReadFirstRecord(file[i], seq[i]))
+		{
+			return -1;
+		}
+	}
+
+	//The script prints the anchors sorted in the descending order
+	std::vector<Lagan::Anchor> found;
+	Lagan::FindAnchors(seq[0], seq[1], gfc != 0, found);
+	*anchor = (LaganAnchor*)malloc(sizeof(LaganAnchor) * (found.size() + 1));
+	for (size_t i = 0; i < found.size(); i++)
+	{
+		const Lagan::Anchor & now = found[found.size() - i - 1];
+		LaganAnchor & out = (*anchor)[i];
+		out.start1 = now.start1;
+		out.end1 = now.end1;
+		out.start2 = now.start2;
+		out.end2 = now.end2;
+		out.score = now.score;
+	}
+
+	return static_cast<int>(found.size());
+}
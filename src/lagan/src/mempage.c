@@ -11,7 +11,7 @@ typedef struct MemoryPage {
 } mpage;
 
 
-mpage* globalpage = 0;
+LAGAN_TLS mpage* globalpage = 0;
 
 void initMP(int pagesize) {
   mpage* newpage;
@@ -36,7 +36,7 @@ void* MPmalloc(int size) {
   return tbr;
 }
 
-void* MPallfree() {
+void MPallfree() {
   mpage *n;
   while (globalpage) {
     free (globalpage->memory);
@@ -8,6 +8,8 @@
 #include "skiplist.h"
 #include "multial.h"
 #include "filebuffer.h"
+#include "rechaos.h"
+#include "threadlocal.h"
 
 #define VER_NUM "2.0"
 #define MIN2(x,y)   ( (x) >= (y) ? (y) : (x) )
@@ -20,7 +22,7 @@ static int postir = 0;
 static int lazy = 0;
 static int notree = 1;
 static int verbose = 0;
-static int numseqs = 0;
+static LAGAN_TLS int numseqs = 0;
 static int itertimes = 1;
 static int cutoffmatch = 12;
 static int translate = 0;
@@ -28,7 +30,7 @@ static int extend = 1;
 static int fastreject = 0;
 static int gapfreechunks = 0;
 
-static align *simaligns[MAX_SEQ];
+static LAGAN_TLS align **simaligns;
 static char* lagan_dir;
 
 static int hptrcomp (const void *p1, const void *p2) {
@@ -48,8 +50,7 @@ static int hptrcomp (const void *p1, const void *p2) {
 
 
 void usage(void) {
-  printf("mlagan seqfile_1 seqfile_2 [... seqfile_%d] [-parameters]\n\n",
-	 MAX_SEQ);
+  printf("mlagan seqfile_1 seqfile_2 [... seqfile_n] [-parameters]\n\n");
   printf("-nested : runs improvement in a nested fashion\n");  
   printf("-postir : incorporates the final improvement phase\n");
   printf("-lazy : uses lazy mode\n");
@@ -137,11 +138,10 @@ align* findAlignByName(align *aligns[], char *name) {
     i++;
   }
   fprintf(stderr, "alignment not found for: %s", name);
-  exit(2);
   return NULL;
 }
 
-int kk = 0;
+LAGAN_TLS int kk = 0;
 
 void printHLL(hll *myres) {
   fprintf(stderr, "into %d\n", ++kk);
@@ -202,6 +202,37 @@ hll* getAnchsFromFile(char *fname, FileBuffer f1, FileBuffer f2) {
 
 
 
+/* Runs the rechaos.pl search in this process, so no temporary files are
+   written. Returns 0 with *done unset for options only the script has. */
+hll* getAnchsInProcess(FileBuffer f1, FileBuffer f2, int *done) {
+  LaganAnchor *anchs;
+  hll *myres = 0, *tt;
+  int i, numanchs;
+
+  *done = 0;
+  if (!extend || translate || fastreject || lazy) {
+    return 0;
+  }
+  numanchs = rechaosAnchors(f1->filename, f2->filename, gapfreechunks, &anchs);
+  if (numanchs < 0) {
+    return 0;
+  }
+  for (i = 0; i < numanchs; i++) {
+    tt = (hll*) malloc(sizeof(hll));
+    tt->seq1start = anchs[i].start1;
+    tt->seq1end = anchs[i].end1;
+    tt->seq2start = anchs[i].start2;
+    tt->seq2end = anchs[i].end2;
+    tt->score = anchs[i].score;
+    tt->next = myres;
+    myres = tt;
+  }
+  free(anchs);
+  fprintf(stderr,"read %d anchs\n", numanchs);
+  *done = 1;
+  return myres;
+}
+
 hll* generateAnchors( FileBuffer a1, FileBuffer a2) {
   char buff[256];
   char fname[80];
@@ -211,7 +242,12 @@ hll* generateAnchors( FileBuffer a1, FileBuffer a2) {
   align* temp;
   hll* res;
   char flip = 0;
-  int retstat;
+  int retstat, done;
+
+  res = getAnchsInProcess(a1, a2, &done);
+  if (done) {
+    return res;
+  }
 
   name1 = strrchr (a1->filename, '/');
   if (!name1) name1 = a1->filename;
@@ -278,7 +314,7 @@ hll* findBestChain(hptr* array, int arrsize) {
     if (array[i].isstart) {
       help = SLfind(skipper, array[i].myhll->seq2start);
       if (help->myelem) {
-	array[i].myhll->bkptr = help->myelem;
+	array[i].myhll->bkptr = (hll*) help->myelem;
 	array[i].myhll->scoreSoFar = ((hll*)help->myelem)->scoreSoFar + array[i].myhll->score;
       }
       else {
@@ -299,6 +335,7 @@ hll* findBestChain(hptr* array, int arrsize) {
   }
   t= (hll*)SLgetLast(skipper)->myelem;
   delSkLst(skipper);
+  free(skipper);
   return t;
 }
 
@@ -482,7 +519,7 @@ align* iterativeImprovement (align *current, align *rpntree[], int length) {
   int converged = 0;
   int i=0, oldscore, cutoff;
   seq *removed;
-  align *readd, *old, *new;
+  align *readd, *old, *readded;
   hll* anchs, *tt;
   if (current->numseq <= 2)
     return current;
@@ -494,7 +531,9 @@ align* iterativeImprovement (align *current, align *rpntree[], int length) {
 
     // Throw out a sequence.  Calling code in multial.
     removed = current->seqs[0];
-    new = findAlignByName(simaligns, removed->name);
+    readded = findAlignByName(simaligns, removed->name);
+    if (!readded)
+      exit(2);
     old = current;
     anchs = getAnchsFromAlign(current, 0, cutoff);
     current = removeSeq(current, 0);
@@ -502,7 +541,7 @@ align* iterativeImprovement (align *current, align *rpntree[], int length) {
 
     // Re-align this thrown-out sequence to the remaining alignment.
 
-    current = makeAlign (current, new, anchs, &old);
+    current = makeAlign (current, readded, anchs, &old);
     if (verbose) {
       printf("improved:\n");
       printHLL(anchs);  
@@ -523,28 +562,45 @@ align* iterativeImprovement (align *current, align *rpntree[], int length) {
 
 
 
-int treeToRPN(char *treestr, align *stack[MAX_SEQ*2], int *depth) {
+/* Returns the number of characters read or -1 if the tree is malformed or
+   names a sequence that is not there */
+int treeToRPN(char *treestr, align *stack[], int *depth) {
 
-  int i=0; int j, k; 
+  int i=0; int j, k, len; 
   char buffer[256];
 
-  while (treestr[i]!='(') { i++; } i++;
+  while ((treestr[i]!='(') && (treestr[i] != '\0')) { i++; }
+  if (treestr[i] == '\0') {
+    fprintf(stderr, "ERROR parsing tree, no opening bracket\n");
+    return -1;
+  }
+  i++;
 
   while ((treestr[i] != ')') && (treestr[i] != '\0')) { 
     //    printf("%d: %s\n", *depth, treestr+i);
 
   
     if (treestr[i]=='(') {
-      i += treeToRPN(treestr+i, stack, depth);
+      len = treeToRPN(treestr+i, stack, depth);
+      if (len < 0)
+        return -1;
+      i += len;
     }  
     else if (isalnum(treestr[i])) {
       k = 0;
       // push alignment
-      while((!isspace(treestr[i])) && (treestr[i]!='(') && (treestr[i]!=')')) { 
+      while((treestr[i] != '\0') && (!isspace(treestr[i])) && (treestr[i]!='(') && (treestr[i]!=')')) { 
+	if (k == (int) sizeof(buffer) - 1) {
+	  fprintf(stderr, "ERROR parsing tree, name longer than %d chars\n", k);
+	  return -1;
+	}
 	buffer[k++] = treestr[i++];
       }
       buffer[k] = 0;
-      stack[(*depth)++]=findAlignByName(simaligns, buffer);
+      stack[*depth]=findAlignByName(simaligns, buffer);
+      if (!stack[*depth])
+        return -1;
+      (*depth)++;
       //      printf("pushed: %s\n", stack[*depth-1]->seqs[0]->name);
     }
     else if (treestr[i]==')')
@@ -558,14 +614,12 @@ int treeToRPN(char *treestr, align *stack[MAX_SEQ*2], int *depth) {
     (*depth)++; //null is '+'
     return i+1;
   }
- if (treestr[i] == '\0') { 
-   fprintf(stderr, "ERROR parsing tree, depth %d, %d chars read", *depth, i);
-   exit(1);
- }
+  fprintf(stderr, "ERROR parsing tree, depth %d, %d chars read", *depth, i);
+  return -1;
 }
 
-align* procStack(align* rpntree[MAX_SEQ*2], int length, align *myaligns[]) {
-  align* stack[MAX_SEQ];
+align* procStack(align* rpntree[], int length, align *myaligns[]) {
+  align** stack = (align**) malloc (numseqs * sizeof(align*)), *res;
   int i = 0, sp = 0;
   int index=0;
 
@@ -586,13 +640,16 @@ align* procStack(align* rpntree[MAX_SEQ*2], int length, align *myaligns[]) {
 
     i++;
   }
-  return stack[sp-1];
+  res = stack[sp-1];
+  free (stack);
+  return res;
 }
 
 
-char* buildTree (align *simalign[], float distances[MAX_SEQ][MAX_SEQ]) {
-  char *names[MAX_SEQ];
-  int namelens[MAX_SEQ];
+/* distances[i*numseqs+j] is the similarity of the sequences i < j */
+char* buildTree (align *simalign[], float *distances) {
+  char **names = (char**) malloc (numseqs * sizeof(char*));
+  int *namelens = (int*) malloc (numseqs * sizeof(int));
   float max;
   int mli, mlj;
   int i, j;
@@ -610,8 +667,8 @@ char* buildTree (align *simalign[], float distances[MAX_SEQ][MAX_SEQ]) {
     max = -1;
     for (i=0; i<(numseqs-1); i++) {
       for (j=i+1; j<numseqs; j++) {
-	if (distances[i][j] > max) {
-	  max = distances[i][j];
+	if (distances[i*numseqs+j] > max) {
+	  max = distances[i*numseqs+j];
 	  mli = i;
 	  mlj = j;
 	}
@@ -619,7 +676,7 @@ char* buildTree (align *simalign[], float distances[MAX_SEQ][MAX_SEQ]) {
     }
     if (max < 0)
       break;
-    //    fprintf (stderr, "join! %d %d (score %f)\n", mli, mlj, distances[mli][mlj]);
+    //    fprintf (stderr, "join! %d %d (score %f)\n", mli, mlj, distances[mli*numseqs+mlj]);
     temp = (char*) malloc ((namelens[mli] + namelens[mlj] +4)* sizeof(char));
     sprintf(temp, "(%s %s)", names[mli], names[mlj]);
 
@@ -635,25 +692,25 @@ char* buildTree (align *simalign[], float distances[MAX_SEQ][MAX_SEQ]) {
     names[mlj] = 0;
     names[mli] = result = temp;
     namelens[mli] = namelens[mli] + namelens[mlj] + 3;
-    distances[mli][mlj] = -1;
+    distances[mli*numseqs+mlj] = -1;
     //    fprintf (stderr, "done concat\n");
     for (i=0; i < mli; i++) {
       //      fprintf (stderr, "h1\n");
-      if (distances[i][mli] >= 0)
-	distances[i][mli] = (distances[i][mli] + distances[i][mlj]) / 2;
-      distances[i][mlj] = -1;
+      if (distances[i*numseqs+mli] >= 0)
+	distances[i*numseqs+mli] = (distances[i*numseqs+mli] + distances[i*numseqs+mlj]) / 2;
+      distances[i*numseqs+mlj] = -1;
     }
     for (i=mli+1; i < mlj; i++) {
       //      fprintf (stderr, "h2\n");
-      if (distances[mli][i] >= 0) 
-	distances[mli][i] = (distances[mli][i] + distances[i][mlj]) / 2;
-      distances[i][mlj] = -1;
+      if (distances[mli*numseqs+i] >= 0) 
+	distances[mli*numseqs+i] = (distances[mli*numseqs+i] + distances[i*numseqs+mlj]) / 2;
+      distances[i*numseqs+mlj] = -1;
     }
     for (i=mlj+1; i < numseqs; i++) {
       //      fprintf (stderr, "h3\n");
-      if (distances[mli][i] >= 0) 
-	distances[mli][i] = (distances[mli][i] + distances[mlj][i]) / 2;
-      distances[mlj][i] = -1;
+      if (distances[mli*numseqs+i] >= 0) 
+	distances[mli*numseqs+i] = (distances[mli*numseqs+i] + distances[mlj*numseqs+i]) / 2;
+      distances[mlj*numseqs+i] = -1;
     }
     //    fprintf (stderr, "end of loop\n");
   } while (max >= 0);
@@ -662,21 +719,23 @@ char* buildTree (align *simalign[], float distances[MAX_SEQ][MAX_SEQ]) {
     if (names[i] != result)
       free (names[i]);
   }
+  free (names);
+  free (namelens);
   fprintf (stderr, "We built the tree: \"%s\"\n", result);
   return result;
 }
 
 
 char* graphCollapsal (align *simaligns[]) {
-  float distances[MAX_SEQ][MAX_SEQ];
+  float *distances = (float*) malloc (numseqs * numseqs * sizeof(float));
   int i, j;
   float sum = 0, length = 0;
   float score = 0, count = 0;
   hll* temp;
+  char* res;
 
-  for (i=0; i< MAX_SEQ; i++)
-    for (j=0; j< MAX_SEQ; j++)
-      distances[i][j] = -1;
+  for (i=0; i< numseqs * numseqs; i++)
+    distances[i] = -1;
   
   for (i=0; i<(numseqs-1); i++) {
     for (j=i+1; j<numseqs; j++) {
@@ -691,17 +750,19 @@ char* graphCollapsal (align *simaligns[]) {
 	temp = temp->next;
       }
       if (count != 0 && sum > 0) {
-	//distances[i][j] = score/count;
-	distances[i][j] = sum/length;
+	//distances[i*numseqs+j] = score/count;
+	distances[i*numseqs+j] = sum/length;
 	//MIN2(simaligns[i]->seqs[0]->numsiglets, simaligns[j]->seqs[0]->numsiglets);
 	fprintf (stderr, "Similarity %s and %s = %f\n",
-		 simaligns[i]->seqs[0]->name, simaligns[j]->seqs[0]->name, distances[i][j]);
+		 simaligns[i]->seqs[0]->name, simaligns[j]->seqs[0]->name, distances[i*numseqs+j]);
       }
       else 
-	distances[i][j] = 0;
+	distances[i*numseqs+j] = 0;
     }
   }
-  return buildTree (simaligns, distances);
+  res = buildTree (simaligns, distances);
+  free (distances);
+  return res;
 }
 
 int parseParameters(int argc, char** argv, FileBuffer *files, char **treestr) {
@@ -912,28 +973,42 @@ hll* updateAnchorPos(hll* myhll, FileBuffer f1, FileBuffer f2) {
   return res;
 }
 
-int connectedGraph(hll* graph[MAX_SEQ][MAX_SEQ], int numseqs) {
-  int M[MAX_SEQ][MAX_SEQ];
+/* graph[i*numseqs+j] are the anchors of the sequences i < j */
+int connectedGraph(hll** graph, int numseqs) {
+  char *M = (char*) calloc (numseqs * numseqs, sizeof(char));
   int i, j, k;
 
   for (i = 0; i < numseqs - 1; i++){
     for (j = i + 1; j < numseqs; j++){
-      M[i][j] = M[j][i] = (graph[i][j] != NULL);
+      M[i*numseqs+j] = M[j*numseqs+i] = (graph[i*numseqs+j] != NULL);
     }
   }
 
   for (k = 0; k < numseqs; k++)
     for (i = 0; i < numseqs; i++)
       for (j = 0; j < numseqs; j++)
-	if (M[i][k] && M[k][j]) M[i][j] = 1;
+	if (M[i*numseqs+k] && M[k*numseqs+j]) M[i*numseqs+j] = 1;
 
   k = 1;
   for (i = 0; k && i < numseqs; i++)
-    k = M[0][i];
+    k = M[i];
 
+  free (M);
   return k;
 }
 
+/* Anchors of all the pairs of sequences. The pairs are searched in
+   parallel, except with -fastreject that narrows the shared file bounds. */
+void anchorTable(FileBuffer *files, hll** table) {
+  int k;
+
+#pragma omp parallel for schedule(dynamic) if(!fastreject)
+  for (k = 0; k < numseqs * numseqs; k++) {
+    if (k / numseqs < k % numseqs)
+      table[k] = generateAnchors(files[k / numseqs], files[k % numseqs]);
+  }
+}
+
 
 int main(int argc, char** argv) {
   FileBuffer seqfile;
@@ -942,11 +1017,11 @@ int main(int argc, char** argv) {
   char command[256];
 
   char *treestr = NULL;
-  align *stack[MAX_SEQ*2];
+  align **stack;
   align *final;
-  align *myaligns[MAX_SEQ];
-  hll* table[MAX_SEQ][MAX_SEQ];
-  FileBuffer files[MAX_SEQ];
+  align **myaligns;
+  hll **table;
+  FileBuffer *files;
 
   outfile = stdout;
   lagan_dir = getenv ("LAGAN_DIR");
@@ -955,18 +1030,16 @@ int main(int argc, char** argv) {
     exit(1);
   }
 
-  buildcache();
+  buildcache(0);
   initLib();
 
   seqs = (seq**) malloc((argc-1)*sizeof(seq*));
+  files = (FileBuffer*) malloc((argc-1)*sizeof(FileBuffer));
 
   if (parseParameters(argc, argv, files, &treestr)) return 1;
 
-  for (i=0; i<(numseqs-1); i++) {
-    for (j=i+1; j<numseqs; j++) {
-      table[i][j] = generateAnchors(files[i], files[j]);
-    }
-  }
+  table = (hll**) calloc(numseqs*numseqs, sizeof(hll*));
+  anchorTable(files, table);
 
   if (fastreject && !connectedGraph(table, numseqs)) {
     if (outfile != stdout)
@@ -977,8 +1050,8 @@ int main(int argc, char** argv) {
   if (fastreject) {
     for (i=0; i<numseqs; i++) {
       for (j=i+1; j<numseqs; j++) {
-	if (table[i][j])
-	  table[i][j] = updateAnchorPos(table[i][j], files[i], files[j]);
+	if (table[i*numseqs+j])
+	  table[i*numseqs+j] = updateAnchorPos(table[i*numseqs+j], files[i], files[j]);
 	else
 	  fprintf (stderr, "hmm\n");
       } 
@@ -996,6 +1069,8 @@ int main(int argc, char** argv) {
 
   // Take all sequences and make simple alignments
 
+  myaligns = (align**) malloc(numseqs*sizeof(align*));
+  simaligns = (align**) malloc(numseqs*sizeof(align*));
   for (i=0; i<numseqs; i++) {
     if (fastreject) {
       if (files[i]->startpos > files[i]->endpos) {
@@ -1013,6 +1088,7 @@ int main(int argc, char** argv) {
     seqs[i]->index = i+1;
     myaligns[i]=simaligns[i]=mkSimAlign(seqs[i]);
     simaligns[i]->index = i;
+    simaligns[i]->hlls = (hll**) calloc(numseqs, sizeof(hll*));
   }
 
 
@@ -1020,15 +1096,14 @@ int main(int argc, char** argv) {
 
   for (i=0; i<(numseqs-1); i++) {
     for (j=i+1; j<numseqs; j++) {
-      simaligns[i]->hlls[j]=table[i][j];
+      simaligns[i]->hlls[j]=table[i*numseqs+j];
     }
   }
+  free(table);
 
   //  printf("\n");
 
-  for (i=0; i<MAX_SEQ*2; i++) {
-    stack[i] = NULL;
-  }
+  stack = (align**) calloc(numseqs*2, sizeof(align*));
 
   /*
   for (i=0; i<(numseqs-1); i++) {
@@ -1056,7 +1131,8 @@ int main(int argc, char** argv) {
   //End of remove
 
   i = 0;
-  treeToRPN(treestr, stack, &i);
+  if (treeToRPN(treestr, stack, &i) < 0)
+    exit(1);
   
   final = procStack(stack, i, myaligns);
   
@@ -6,6 +6,7 @@
 #include <assert.h>
 #include "diagmatrix.h"
 #include "multial.h"
+#include "threadlocal.h"
 
 #define INSERTION 1
 #define DELETION 2
@@ -32,42 +33,73 @@
 char* alpha = "ATCG.N";
 char* nucmatrixfile = 0;
 
-int s1start = 0;
-int s1end = 0;
-int s2start = 0;
-int s2end = 0;
+LAGAN_TLS int s1start = 0;
+LAGAN_TLS int s1end = 0;
+LAGAN_TLS int s2start = 0;
+LAGAN_TLS int s2end = 0;
 //int match = 18;
 //int mismatch = -8;
-int gapstart = -50;
-int gapend = -50;
-int gapcont = -5;
-int gapperseq = -1;
-int overlap = 0;
-int glwidth= 15;
-char dobin = 0;
+LAGAN_TLS int gapstart = -50;
+LAGAN_TLS int gapend = -50;
+LAGAN_TLS int gapcont = -5;
+LAGAN_TLS int gapperseq = -1;
+LAGAN_TLS int overlap = 0;
+LAGAN_TLS int glwidth= 15;
+LAGAN_TLS char dobin = 0;
 
-float factor, offset;
-int logs[MAX_SEQ*MAX_SEQ];
+LAGAN_TLS float factor, offset;
 
-FILE* outfile;
+LAGAN_TLS FILE* outfile;
 
 static int substmatrix[256][256];
-static int matchcache[1 << 24], gapcache[1 << 24];
-int *freed = 0, freedsize, freedcap;
-align **freedptr;
+static LAGAN_TLS int *matchcache = 0, *gapcache = 0;
+static LAGAN_TLS int matchbound = -1, gapbound = -1;
+static LAGAN_TLS int cachegs, cachegc, cachege;
+static LAGAN_TLS int usecache = 1;
+LAGAN_TLS int *freed = 0, freedsize, freedcap;
+LAGAN_TLS align **freedptr;
 
-int normf;
-int normprev;
+LAGAN_TLS int normf;
+LAGAN_TLS int normprev;
 
  int ismatch(char a, char b) {
   return (a == b);
 }
 
  int isGap(align* ali, int seqn, int loc) {
-  int i = !((ali->algn[loc] >> seqn) & 1);
+  int i = !((ali->algn[loc * ALGN_WORDS(ali->numseq) + seqn / ALGN_BITS] >> (seqn % ALGN_BITS)) & 1);
   return i;
 }
 
+void setLetter(align* ali, int seqn, int loc) {
+  ali->algn[loc * ALGN_WORDS(ali->numseq) + seqn / ALGN_BITS] |= 1ULL << (seqn % ALGN_BITS);
+}
+
+/* ORs the n bits of the column src into the column dst from bit off on */
+void orColumn(algword* dst, int off, algword* src, int n) {
+  algword w;
+  int i, b;
+  for (i = 0; i < n; i += ALGN_BITS) {
+    w = src[i / ALGN_BITS];
+    if (n - i < ALGN_BITS)
+      w &= (1ULL << (n - i)) - 1;
+    b = (off + i) % ALGN_BITS;
+    dst[(off + i) / ALGN_BITS] |= w << b;
+    if (b && b + MIN2(n - i, ALGN_BITS) > ALGN_BITS)
+      dst[(off + i) / ALGN_BITS + 1] |= w >> (ALGN_BITS - b);
+  }
+}
+
+/* Whether a sequence other than seqn has a letter in the column */
+int hasOthers(align* ali, int seqn, int loc) {
+  int i, words = ALGN_WORDS(ali->numseq);
+  algword* col = ali->algn + loc * words;
+  for (i = 0; i < words; i++)
+    if (col[i] & ~((i == seqn / ALGN_BITS) ? 1ULL << (seqn % ALGN_BITS) : 0))
+      return 1;
+  return 0;
+}
+
  int scoreLocal(int which, align* ali, int loc) {
   int i, lets = 0;
   for (i=0; i < 4; i++)
@@ -81,6 +113,7 @@ int normprev;
     return lets * gapstart;
   if (which == CNTS_GC)
     return lets+ali->cnts[CNTS_GS][loc] * gapcont;
+  return 0;
 }
 
  hll* reverseHLL(hll* tbr) {
@@ -99,7 +132,6 @@ hll* getAnchsFromAlign(align* current, int seqnum, int cutoff) {
   int currscore=0, oldscore, peakscore;
   hll *res = 0, *temp = (hll*) malloc (sizeof(hll));
   int which;
-  long long int mask = ~(1<<seqnum);
   char ingap = 0, isfrst = 1;
   float peakfrac;
 
@@ -134,7 +166,7 @@ hll* getAnchsFromAlign(align* current, int seqnum, int cutoff) {
     }
     if (currscore < 0)
       currscore = 0;
-    if (current->algn[j]&mask)
+    if (hasOthers(current, seqnum, j))
       newj++;
   }
 
@@ -148,7 +180,7 @@ hll* getAnchsFromAlign(align* current, int seqnum, int cutoff) {
   return reverseHLL(res);
 }
 
-int cons_cnt = 0;
+LAGAN_TLS int cons_cnt = 0;
 
 
 seq* mkConsensus(align* ali) {
@@ -171,8 +203,8 @@ seq* mkConsensus(align* ali) {
   return res;
 }
 
- void reverse (long long int* a, int length) {
-  long long int lft;
+ void reverse (algword* a, int length) {
+  algword lft;
   int i;
   for (i=0; i < length/2; i++) {
     lft = a[i];
@@ -183,9 +215,10 @@ seq* mkConsensus(align* ali) {
 
 
 align* unifyAlign(align* ali1, align* ali2, align* uni){
-  char *mat[MAX_SEQ];
+  char **mat;
   int i,j,k, cbc, brcount;
   int s1 = 0, s2 = 0, tgs, tgc;
+  int words, words1 = ALGN_WORDS(ali1->numseq), words2 = ALGN_WORDS(ali2->numseq);
   align *res = (align*) malloc(sizeof(align));
   
   assert (res);
@@ -194,20 +227,22 @@ align* unifyAlign(align* ali1, align* ali2, align* uni){
   res->algnlen = uni->algnlen;
   res->nextalign = 0;
   res->dirty = 0;
+  res->hlls = 0;
+  res->seqs = (seq**) malloc (res->numseq * sizeof (seq*)); assert (res->seqs);
+  mat = (char**) malloc (res->numseq * sizeof (char*)); assert (mat);
+  words = ALGN_WORDS(res->numseq);
 
   // memory allocation and alignment creation
-  res->algn = (long long int*) malloc ((res->algnlen+1) * sizeof (long long int)); assert (res->algn);
-  res->algn[0] = 0;
+  res->algn = (algword*) calloc ((res->algnlen+1) * words, sizeof (algword)); assert (res->algn);
   for (j = 0; j < CNTS_LEN; j++){
-    res->cnts[j] = (char*) malloc((res->algnlen+1) * sizeof(char));
+    res->cnts[j] = (short*) malloc((res->algnlen+1) * sizeof(short));
     assert (res->cnts[j]);
   }
   for (i=0; i<= res->algnlen; i++){
-    res->algn[i] = 0;
     for (j=0; j<CNTS_LEN; j++)
       res->cnts[j][i] = 0; 
-    if (!isGap(uni, 0, i)) res->algn[i] |= ali1->algn[s1++];
-    if (!isGap(uni, 1, i)) res->algn[i] |= (ali2->algn[s2++] << ali1->numseq);
+    if (!isGap(uni, 0, i)) orColumn(res->algn + i * words, 0, ali1->algn + (s1++) * words1, ali1->numseq);
+    if (!isGap(uni, 1, i)) orColumn(res->algn + i * words, ali1->numseq, ali2->algn + (s2++) * words2, ali2->numseq);
   }
 
   for (i = 0; i < res->numseq; i++){
@@ -238,6 +273,7 @@ align* unifyAlign(align* ali1, align* ali2, align* uni){
   }
   
   for (i = 0; i < res->numseq; i++) free (mat[i]);
+  free (mat);
 
   return res;
 }
@@ -246,7 +282,7 @@ align* unifyAlign(align* ali1, align* ali2, align* uni){
 align* getChain(dmat* mydm, int x, int y, int j) {
   int temp;
   align *res = (align*) malloc (sizeof(align)), *help; 
-  long long int* almt = (long long int*) malloc ( sizeof(long long int));
+  algword* almt = (algword*) malloc ( sizeof(algword));
   int i=0, almtsize = 1, which, inrun = j;
   char zz = DMgetPtr(mydm, x, y); 
   assert (res);
@@ -261,6 +297,9 @@ align* getChain(dmat* mydm, int x, int y, int j) {
   res->nextalign = 0;
   res->algn = 0;
   res->algnlen = 0;
+  res->numseq = 2;
+  res->seqs = 0;
+  res->hlls = 0;
 
   res->num = freedsize;
   freed[freedsize] = 0;
@@ -336,7 +375,7 @@ align* getChain(dmat* mydm, int x, int y, int j) {
       printf("a really dumb error %d\n", i);
  
     if (i >= almtsize) {
-      almt = realloc (almt, sizeof(long long int)* (almtsize *= 2));
+      almt = (algword*) realloc (almt, sizeof(algword)* (almtsize *= 2));
     }
     //   printf ("retrace %d %d after %d\n", x, y,i);
 
@@ -379,7 +418,7 @@ void saveNeck(dmat* mydm, int neckdiag) {
 
 void joinAligns (align* a) {
   align *n = a->nextalign, *t;
-  long long int* temp,  *temp2;
+  algword* temp,  *temp2;
   int totsize=0;
   int i =0;
   for (t = a; t; t = t->nextalign) {
@@ -387,14 +426,14 @@ void joinAligns (align* a) {
     i++;
   }
 
-  temp = malloc ((totsize+1)*sizeof(long long int));
+  temp = (algword*) malloc ((totsize+1)*sizeof(algword));
   assert (temp);
   temp[totsize] = 0;
   temp2 = temp + totsize;
   totsize = 0;
   for (t=a; t; t = t->nextalign) {
     totsize += t->algnlen;
-    memcpy(temp2-totsize, t->algn, t->algnlen*sizeof(long long int));
+    memcpy(temp2-totsize, t->algn, t->algnlen*sizeof(algword));
   }
   free (a->algn);
   a->algn = temp;
@@ -497,33 +536,56 @@ void readSubstMatrix (char *filename, int size, int substmatrix[256][256]){
   return substmatrix[a][b];
 }
 
-void buildcache (){
-  int score, i, j;
-  int gs, gc, ge, ns;
+/* Sum of pairs score of a column with num[i] letters lets[i] */
+int scoreMatch (int num[4]){
   char *lets = "ATCG";
+  int score = 0, i, j;
+  for (i = 0; i < 4; i++){
+    score += num[i] * (num[i] - 1) / 2 * chmatchscore ((unsigned char)lets[i], (unsigned char)lets[i], substmatrix);
+    for (j = i + 1; j < 4; j++){
+      score += num[i] * num[j] * chmatchscore ((unsigned char) lets[i], (unsigned char) lets[j], substmatrix);
+    }
+  }
+  return score;
+}
+
+/* Fills the caches for columns of at most numseqs sequences. The match
+   cache only depends on the matrix and the gap cache on the current gap
+   scores, so they are only extended or refreshed when one of these grows
+   or changes. Columns of more than CACHE_SEQ sequences are scored
+   directly. */
+void buildcache (int numseqs){
+  int gs, gc, ge, ns;
   int num[4];
-  int numseqs = MAX_SEQ;
 
   readSubstMatrix (NUC_FILE, NUC_FILE_SIZE, substmatrix);
 
+  usecache = numseqs <= CACHE_SEQ;
+  if (!usecache)
+    return;
+
+  if (!matchcache){
+    matchcache = (int*) calloc (1 << 24, sizeof (int)); assert (matchcache);
+    gapcache = (int*) calloc (1 << 24, sizeof (int)); assert (gapcache);
+  }
+
+  if (numseqs > matchbound){
+  matchbound = numseqs;
   for (num[0] = 0; num[0] <= numseqs; num[0]++){ // A
     for (num[1] = 0; num[1] <= numseqs; num[1]++){ // T
       for (num[2] = 0; num[2] <= numseqs; num[2]++){ // C
 	for (num[3] = 0; num[3] <= numseqs; num[3]++){ // G
-
-	  score = 0;
-	  for (i = 0; i < 4; i++){
-	    score += num[i] * (num[i] - 1) / 2 * chmatchscore ((unsigned char)lets[i], (unsigned char)lets[i], substmatrix);
-	    for (j = i + 1; j < 4; j++){
-	      score += num[i] * num[j] * chmatchscore ((unsigned char) lets[i], (unsigned char) lets[j], substmatrix);
-	    }
-	  }
-	  matchcache[num[0] | (num[1] << 6) | (num[2] << 12) | (num[3] << 18)] = score;
+	  matchcache[num[0] | (num[1] << 6) | (num[2] << 12) | (num[3] << 18)] = scoreMatch (num);
 	}
       }
     }
   }
+  }
 
+  if (numseqs <= gapbound && gapstart == cachegs && gapcont == cachegc && gapend == cachege)
+    return;
+  gapbound = numseqs;
+  cachegs = gapstart; cachegc = gapcont; cachege = gapend;
   for (gs = 0; gs <= numseqs; gs++){
     for (gc = 0; gc <= numseqs; gc++){
       for (ge = 0; ge <= numseqs; ge++){
@@ -540,53 +602,65 @@ void buildcache (){
 }
 
  int v (int y){
-  if (y >= 0 && y <= MAX_SEQ) return y;
+  if (y >= 0 && y <= CACHE_SEQ) return y;
   fprintf(stderr, "Got %d in v\n", y);
   assert (0);
   return 0;
 }
 
+ int matchcount (int na, int nt, int nc, int ng){
+  int num[4];
+  if (usecache)
+    return matchcache[v(na) | (v(nt) << 6) | (v(nc) << 12) | (v(ng) << 18)];
+  num[0] = na; num[1] = nt; num[2] = nc; num[3] = ng;
+  return scoreMatch (num);
+}
+
+ int gapcount (int gs, int gc, int ge, int ns){
+  if (usecache)
+    return gapcache[v(gs) | (v(gc) << 6) | (v(ge) << 12) | (v(ns) << 18)];
+  return scoreGap (gs, gc, ge, ns);
+}
+
  int matchscore (align*a, int ai, align *b, int bi){
   
   return
-    matchcache[v(a->cnts[0][ai] + b->cnts[0][bi]) | 
-	      (v(a->cnts[1][ai] + b->cnts[1][bi]) << 6) |
-	      (v(a->cnts[2][ai] + b->cnts[2][bi]) << 12) |
-	      (v(a->cnts[3][ai] + b->cnts[3][bi]) << 18)] +
-    gapcache[v(a->cnts[CNTS_GS][ai] + b->cnts[CNTS_GS][bi]) |
-	    (v(a->cnts[CNTS_GC][ai] + b->cnts[CNTS_GC][bi]) << 6) |
-	    (v(a->cnts[CNTS_GE][ai] + b->cnts[CNTS_GE][bi]) << 12) |
-	    (v(a->numseq + b->numseq - (a->cnts[CNTS_CB][ai] + b->cnts[CNTS_CB][bi])) << 18)];
+    matchcount(a->cnts[0][ai] + b->cnts[0][bi],
+	       a->cnts[1][ai] + b->cnts[1][bi],
+	       a->cnts[2][ai] + b->cnts[2][bi],
+	       a->cnts[3][ai] + b->cnts[3][bi]) +
+    gapcount(a->cnts[CNTS_GS][ai] + b->cnts[CNTS_GS][bi],
+	     a->cnts[CNTS_GC][ai] + b->cnts[CNTS_GC][bi],
+	     a->cnts[CNTS_GE][ai] + b->cnts[CNTS_GE][bi],
+	     a->numseq + b->numseq - (a->cnts[CNTS_CB][ai] + b->cnts[CNTS_CB][bi]));
 }
 
  int scoreOpp (align *other, int ow, int oppnum){
-  return matchcache[v(other->cnts[0][ow]) | 
-		   (v(other->cnts[1][ow]) << 6) |
-		   (v(other->cnts[2][ow]) << 12) |
-		   (v(other->cnts[3][ow]) << 18)];
+  return matchcount(other->cnts[0][ow], other->cnts[1][ow],
+		    other->cnts[2][ow], other->cnts[3][ow]);
 }
 
  int endGap0 (align* a, int ai, align* b, int bi){
-  return gapcache[(v(a->cnts[CNTS_GE][ai]+b->cnts[CNTS_GE][bi])<<12) | 
-		  (v(a->numseq + b->numseq-(b->cnts[CNTS_CB][bi]+a->cnts[CNTS_CB][ai])) << 18)];
+  return gapcount(0, 0, a->cnts[CNTS_GE][ai]+b->cnts[CNTS_GE][bi],
+		  a->numseq + b->numseq-(b->cnts[CNTS_CB][bi]+a->cnts[CNTS_CB][ai]));
 }
 
  int endGap1 (align* a, int ai, align* b, int bi){
 
-  return gapcache[(v((b->numseq - b->cnts[CNTS_GS][bi] - b->cnts[CNTS_GC][bi]) + a->cnts[CNTS_GE][ai]) << 12) | 
-		  (v(a->numseq + b->numseq - (b->cnts[CNTS_CB][bi]+a->cnts[CNTS_CB][ai])) << 18)];
+  return gapcount(0, 0, (b->numseq - b->cnts[CNTS_GS][bi] - b->cnts[CNTS_GC][bi]) + a->cnts[CNTS_GE][ai],
+		  a->numseq + b->numseq - (b->cnts[CNTS_CB][bi]+a->cnts[CNTS_CB][ai]));
 }
 
  int endGap2 (align* a, int ai, align* b, int bi){
-  return gapcache[(v((a->numseq - a->cnts[CNTS_GS][ai] - a->cnts[CNTS_GC][ai]) + b->cnts[CNTS_GE][bi])<<12) | 
-		  (v(a->numseq + b->numseq - (b->cnts[CNTS_CB][bi]+a->cnts[CNTS_CB][ai])) << 18)];
+  return gapcount(0, 0, (a->numseq - a->cnts[CNTS_GS][ai] - a->cnts[CNTS_GC][ai]) + b->cnts[CNTS_GE][bi],
+		  a->numseq + b->numseq - (b->cnts[CNTS_CB][bi]+a->cnts[CNTS_CB][ai]));
 }
 
  int contGap(align* ali, int myw, align* other, int ow, int *sopp) {
-  return gapcache[(v(other->cnts[CNTS_GS][ow])) |
-		  (v(ali->numseq + other->cnts[CNTS_GC][ow]) << 6) |
-		  (v(other->cnts[CNTS_GE][ow]) << 12) |
-		  (v(ali->numseq + other->numseq - (ali->cnts[CNTS_CB][myw] + other->cnts[CNTS_CB][ow])) << 18)] +
+  return gapcount(other->cnts[CNTS_GS][ow],
+		  ali->numseq + other->cnts[CNTS_GC][ow],
+		  other->cnts[CNTS_GE][ow],
+		  ali->numseq + other->numseq - (ali->cnts[CNTS_CB][myw] + other->cnts[CNTS_CB][ow])) +
     sopp[ow];
 }
 
@@ -600,10 +674,10 @@ void buildcache (){
   //  if (w < ali->algnlen) alopen += ali->cnts[CNTS_GS][w+1];
 
   
-  sav = gapcache[(v(ali->numseq - (alopen + ali->cnts[CNTS_CB][w]) + other->cnts[CNTS_GS][ow])) |
-		 (v(alopen + other->cnts[CNTS_GC][ow]) << 6) |
-		 (v(other->cnts[CNTS_GE][ow]) << 12) |
-		 (v(ali->numseq+other->numseq - (ali->cnts[CNTS_CB][w]+other->cnts[CNTS_CB][ow])) << 18)];
+  sav = gapcount(ali->numseq - (alopen + ali->cnts[CNTS_CB][w]) + other->cnts[CNTS_GS][ow],
+		 alopen + other->cnts[CNTS_GC][ow],
+		 other->cnts[CNTS_GE][ow],
+		 ali->numseq+other->numseq - (ali->cnts[CNTS_CB][w]+other->cnts[CNTS_CB][ow]));
 
   return sav;
 }
@@ -820,7 +894,7 @@ align* doNW(dmat* mydm, align* ali1, align* ali2) {
   curr->M = 0;
   DMsetPtr(mydm, 0, 1, 1);
 
-  buildcache();
+  buildcache(ali1->numseq + ali2->numseq);
 
   sopp1 = (int*) malloc (sizeof (int) * (ali1->algnlen+1));
   sopp2 = (int*) malloc (sizeof (int) * (ali2->algnlen+1));
@@ -959,15 +1033,18 @@ align* mkSimAlign(seq* seq1) {
   res->dirty = 0;
   res->numseq = 1;
   res->algnlen = seq1->numlets;
+  res->seqs = (seq**) malloc (sizeof (seq*));
+  assert (res->seqs);
   res->seqs[0] = seq1;
+  res->hlls = 0;
 
   /**
    * Evidence that you need one more character.
    */
-  res->algn = (long long int*) malloc((res->algnlen+1) * sizeof(long long int));
+  res->algn = (algword*) malloc((res->algnlen+1) * sizeof(algword));
   assert (res->algn);
   for (j=0; j<CNTS_LEN; j++){
-    res->cnts[j] = (char*) malloc((res->algnlen+1) * sizeof(char));    
+    res->cnts[j] = (short*) malloc((res->algnlen+1) * sizeof(short));    
     assert (res->cnts[j]);
   }
   for (i=0; i< res->algnlen;i++) {
@@ -989,26 +1066,31 @@ align* mkSimAlign(seq* seq1) {
 
  
 align* removeSeq(align* ali, int seqnum) {
-  int i,j, k, n, p, bit = (1 << seqnum);
-  int mask = bit - 1, resint, flag = 0;
+  int i,j, k, n, p, resint, flag = 0;
   align* res = (align*) malloc(sizeof(align));
   res->score = 0;
   res->numseq = ali->numseq-1;
+  res->seqs = (seq**) malloc(MAX2(res->numseq, 1) * sizeof(seq*));
+  res->hlls = 0;
   for (i=0; i< seqnum; i++)
     res->seqs[i] = ali->seqs[i];
   for (i++; i< ali->numseq; i++)
     res->seqs[i-1] = ali->seqs[i];
 
-     res->algn = (long long int*) malloc(ali->algnlen * sizeof(long long int));  
+  res->algn = (algword*) calloc((ali->algnlen+1) * ALGN_WORDS(res->numseq), sizeof(algword));
   for (j=0; j<CNTS_LEN; j++)
-    res->cnts[j] = (char*) malloc(ali->algnlen * sizeof(char));    
+    res->cnts[j] = (short*) malloc((ali->algnlen+1) * sizeof(short));    
 
   for (i=0, j=0, n=0; i < ali->algnlen; i++) {
-    resint = (ali->algn[i] & mask) | ((ali->algn[i] & ~(mask|bit)) >> 1);
+    for (p = resint = 0; p < res->numseq; p++) {
+      if (!isGap(ali, (p < seqnum) ? p : p+1, i)) {
+	setLetter(res, p, j);
+	resint = 1;
+      }
+    }
     if (resint) {
       for (k=0; k<CNTS_LEN; k++)
 	res->cnts[k][j] = ali->cnts[k][i]; 
-      res->algn[j] = resint;
       if (!isGap(ali, seqnum, i)) {
 	k=strchr(alpha,ali->seqs[seqnum]->lets[n])-alpha;
 	if (k<5)
@@ -1064,7 +1146,7 @@ align* removeSeqByName(align* ali, char *name) {
   while (strcmp(ali->seqs[i]->name, name)) { i++; }
   removed = ali->seqs[i];
 
-  removeSeq(ali, i);
+  return removeSeq(ali, i);
 }
 
 int getSeqNum(align* ali, seq* trgt) {
@@ -1350,7 +1432,7 @@ int hllUnion(hll *h1, hll *h2) {
 
 hll* hllJoin(hll *h1, hll *h2, int score) {
   int i, j;
-  hll *res = malloc (sizeof(hll));
+  hll *res = (hll*) malloc (sizeof(hll));
 
   
   res->seq1start=MIN2(h1->seq1start, h2->seq1start);
@@ -1480,7 +1562,7 @@ int printTextAlign(FILE* outfile, align* myalign) {
 
       for (k = c; (k < (c + 60)) && (k < myalign->algnlen); k++) {
 
-	if (myalign->algn[k] & (1<<i))
+	if (!isGap(myalign, i, k))
 	  fprintf(outfile, "%c", myalign->seqs[i]->lets[inds[i]++]);
 	else 
 	  fprintf(outfile,"-");
@@ -1518,6 +1600,7 @@ int printTextAlign(FILE* outfile, align* myalign) {
 
   fprintf(outfile,"\n");
   free(inds);
+  return 0;
 }
 
 int printFASTAAlign(FILE* outfile, align* myalign) {
@@ -1535,7 +1618,7 @@ int printFASTAAlign(FILE* outfile, align* myalign) {
     fprintf(outfile, ">%s\n", myalign->seqs[i]->name);
     for (c = 1; c < myalign->algnlen; c = c + 60) {
       for (k = c; (k < (c + 60)) && (k < myalign->algnlen); k++) {
-	if (myalign->algn[k] & (1<<i))
+	if (!isGap(myalign, i, k))
 	  fprintf(outfile, "%c", myalign->seqs[i]->lets[inds[i]++]);
 	else 
 	  fprintf(outfile,"-");
@@ -1546,6 +1629,7 @@ int printFASTAAlign(FILE* outfile, align* myalign) {
   fprintf(outfile,"\n");
 
   free (inds);
+  return 0;
 }
 
 int printXMFAAlign(FILE* outfile, align* myalign) {
@@ -1564,7 +1648,7 @@ int printXMFAAlign(FILE* outfile, align* myalign) {
 	    myalign->seqs[i]->rightbound-1, myalign->seqs[i]->name);
     for (c = 1; c < myalign->algnlen; c = c + 60) {
       for (k = c; (k < (c + 60)) && (k < myalign->algnlen); k++) {
-	if (myalign->algn[k] & (1<<i))
+	if (!isGap(myalign, i, k))
 	  fprintf(outfile, "%c", myalign->seqs[i]->lets[inds[i]++]);
 	else 
 	  fprintf(outfile,"-");
@@ -1576,6 +1660,7 @@ int printXMFAAlign(FILE* outfile, align* myalign) {
   }
 
   free (inds);
+  return 0;
 }
 
 
@@ -1617,18 +1702,20 @@ void freeAlign(align *myAlign) {
   
   if (myAlign->algn){
     free(myAlign->algn);
-    myAlign->algn = (long long int *) 0;
+    myAlign->algn = (algword *) 0;
   }
 
   for (i=0; i<CNTS_LEN; i++) {
     if (myAlign->cnts[i]){
       free(myAlign->cnts[i]);
-      myAlign->cnts[i] = (char *) 0;
+      myAlign->cnts[i] = (short *) 0;
     }
   }
   
   // sequences not freed
   // HLLs not freed
+  free(myAlign->seqs);
+  free(myAlign->hlls);
   if (freed)
     freed[myAlign->num] = 1;
   free(myAlign);
@@ -3,11 +3,11 @@
 
 
 #include <stdio.h>
+#include "threadlocal.h"
 
 #define NUC_FILE "nucmatrix.txt"
 #define NUC_FILE_SIZE 6
 
-#define MAX_SEQ 63
 #define CNTS_LEN 8
 #define CNTS_A 0
 #define CNTS_T 1
@@ -18,6 +18,14 @@
 #define CNTS_GC 6
 #define CNTS_GE 7
 
+/* Columns of an alignment are bit sets with a bit per sequence, spread over
+   as many words as the sequences need */
+#define ALGN_BITS 64
+#define ALGN_WORDS(numseq) (((numseq) + ALGN_BITS - 1) / ALGN_BITS)
+
+/* The score caches pack the counts of a column in 6 bits */
+#define CACHE_SEQ 63
+
 
 typedef struct HitLocationList {
   int seq1start;
@@ -47,16 +55,18 @@ typedef struct Sequence {
   int index;
 } seq;
 
+typedef unsigned long long algword;
+
 typedef struct align_res {
   int num;
   int index;
   int score;
   int algnlen;
   int numseq;
-  seq* seqs[MAX_SEQ];
-  long long int* algn;
-  char* cnts[CNTS_LEN];
-  hll* hlls[MAX_SEQ];
+  seq** seqs;
+  algword* algn;      /* ALGN_WORDS(numseq) words per column */
+  short* cnts[CNTS_LEN];
+  hll** hlls;         /* anchors to the other inputs, set by the drivers */
   int dirty;
   struct align_res* nextalign;
 } align;
@@ -71,10 +81,13 @@ hll* remapHLLs(hll* anchs, int which, align* aln, int seqnum);
 hll* mergeHLLs(hll* anchs1, int wh1, hll* anchs2, int wh2);
 hll* getAnchsFromAlign(align* current, int seqnum, int cutoff);
 int getSeqNum(align* ali, seq* trgt);
+int isGap(align* ali, int seqn, int loc);
+void setLetter(align* ali, int seqn, int loc);
 int printTextAlign(FILE *, align* myalign);
 int printFASTAAlign(FILE *, align* myalign);
+int printXMFAAlign(FILE *, align* myalign);
 void printSeqsNames(align *a);
-void buildcache();
+void buildcache(int numseqs);
 
 void freeHLLs(hll *myHLL);
 void freeSequence(seq *mySequence);
@@ -84,25 +97,24 @@ void setScores(int gapperseqV, int overlapV, int glwidthV);
 
 extern char* alpha;
 
-extern int s1start;
-extern int s1end;
-extern int s2start;
-extern int s2end;
+extern LAGAN_TLS int s1start;
+extern LAGAN_TLS int s1end;
+extern LAGAN_TLS int s2start;
+extern LAGAN_TLS int s2end;
 //int match;
 //int mismatch;
-extern int gapstart;
-extern int gapend;
-extern int gapcont;
-extern int gapperseq;
-extern int overlap;
-extern int glwidth;
-extern char dobin;
+extern LAGAN_TLS int gapstart;
+extern LAGAN_TLS int gapend;
+extern LAGAN_TLS int gapcont;
+extern LAGAN_TLS int gapperseq;
+extern LAGAN_TLS int overlap;
+extern LAGAN_TLS int glwidth;
+extern LAGAN_TLS char dobin;
 extern char* nucmatrixfile;
 
-extern float factor, offset;
-extern int logs[MAX_SEQ*MAX_SEQ];
+extern LAGAN_TLS float factor, offset;
 
-extern FILE* outfile;
+extern LAGAN_TLS FILE* outfile;
 
 #endif
 
@@ -5,6 +5,14 @@
 #include <assert.h>
 #include "diagmatrix.h"
 #include "filebuffer.h"
+#include "threadlocal.h"
+/* The SSE4.1 fill is compiled for every x86 build and chosen at run time,
+   so the binaries still run on processors without SSE4.1 */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ORDER_SSE41 1
+#define SSE41_TARGET __attribute__((target("sse4.1")))
+#include <smmintrin.h>
+#endif
 
 #define NUC_FILE "nucmatrix.txt"
 #define NUC_FILE_SIZE 6
@@ -31,21 +39,21 @@ align* makeAlign(dmat* mydm, char* seq1, char* seq2);
 
 char* alpha = "ATCGN.";
 
-int s1start = 0;
-int s1end = 0;
-int s2start = 0;
-int s2end = 0;
-int gapstart = -1500;
-int gapcont = -50;
+LAGAN_TLS int s1start = 0;
+LAGAN_TLS int s1end = 0;
+LAGAN_TLS int s2start = 0;
+LAGAN_TLS int s2end = 0;
+LAGAN_TLS int gapstart = -1500;
+LAGAN_TLS int gapcont = -50;
 //int match =12;
 //int mismatch = -8;
-int overlap = 0;
-int glwidth= 15;
-char dobin = 0;
-char domfa = 0;
-char doxmfa = 0;
-FILE* ancfile = 0;
-FILE* outfile;
+LAGAN_TLS int overlap = 0;
+LAGAN_TLS int glwidth= 15;
+LAGAN_TLS char dobin = 0;
+LAGAN_TLS char domfa = 0;
+LAGAN_TLS char doxmfa = 0;
+LAGAN_TLS FILE* ancfile = 0;
+LAGAN_TLS FILE* outfile;
 
 int substmatrix[256][256];
 
@@ -221,26 +229,16 @@ void usage() {
   printf("-version = prints the version of this ORDER\n");
 }
 
-hll* readAncFile(seq* seq1, seq* seq2) {
-  hll *myres = 0, *tt;
-  char buff[256];
-  int i=0;
-  
-  while (!feof(ancfile)) {
-    if (!fgets(buff, 256, ancfile)) {
-      break;
-    }
-    tt = (hll*) malloc(sizeof(hll));
-    sscanf(buff, "(%d %d)=(%d %d) %*f", &tt->seq1start, &tt->seq1end,
-	   &tt->seq2start, &tt->seq2end);
-
-    if ((tt->seq1start >= s1start && tt->seq1end <= s1end || s1start == 0 && s1end == 0) &&
-	(tt->seq2start >= s2start && tt->seq2end <= s2end || s2start == 0 && s2end == 0)){
-      
-      if (tt->seq1start <= 0 && tt->seq1end <= 0) continue;
-      if (tt->seq2start <= 0 && tt->seq2end <= 0) continue;
-      if (tt->seq1start > s1start + seq1->numlets && tt->seq1end > s1start + seq1->numlets) continue;
-      if (tt->seq2start > s2start + seq2->numlets && tt->seq2end > s2start + seq2->numlets) continue;
+/* Puts the anchor in front of the list, clipped to the aligned substrings,
+   or frees it if it lies outside of them */
+hll* addAnc(hll* myres, hll* tt, seq* seq1, seq* seq2) {
+  if ((tt->seq1start >= s1start && tt->seq1end <= s1end || s1start == 0 && s1end == 0) &&
+      (tt->seq2start >= s2start && tt->seq2end <= s2end || s2start == 0 && s2end == 0)){
+    
+    if ((tt->seq1start > 0 || tt->seq1end > 0) &&
+	(tt->seq2start > 0 || tt->seq2end > 0) &&
+	(tt->seq1start <= s1start + seq1->numlets || tt->seq1end <= s1start + seq1->numlets) &&
+	(tt->seq2start <= s2start + seq2->numlets || tt->seq2end <= s2start + seq2->numlets)) {
 
       if (s1start > 0){
 	tt->seq1start = MAX2 (tt->seq1start - s1start + 1, 1);
@@ -257,12 +255,29 @@ hll* readAncFile(seq* seq1, seq* seq2) {
       tt->seq2end = MIN2 (tt->seq2end, seq2->numlets);
 
       tt->next = myres;
-      i++;
-      myres = tt;      
-
-
+      return tt;
+    }
+  }
+  free(tt);
+  return myres;
+}
 
+hll* readAncFile(seq* seq1, seq* seq2) {
+  hll *myres = 0, *tt;
+  char buff[256];
+  int i=0;
+  
+  while (!feof(ancfile)) {
+    if (!fgets(buff, 256, ancfile)) {
+      break;
     }
+    tt = (hll*) malloc(sizeof(hll));
+    sscanf(buff, "(%d %d)=(%d %d) %*f", &tt->seq1start, &tt->seq1end,
+	   &tt->seq2start, &tt->seq2end);
+
+    myres = addAnc(myres, tt, seq1, seq2);
+    if (myres == tt)
+      i++;
   }
   fprintf(stderr,"read %d anchs\n", i);
   return myres;
@@ -382,13 +397,9 @@ void doShapes(hll* myres, dmat* mydm, int* starts, int *ends) {
 }
 
 
-void parseAncs(dmat* mydm, seq* seq1, seq* seq2) {
-  int *starts = (int*) malloc(sizeof(int)*(seq1->numlets + seq2->numlets+2));
-  int *ends = (int*) malloc(sizeof(int)*(seq1->numlets + seq2->numlets+2));
-  hll* myres = 0;
-  if (ancfile) {
-    myres = readAncFile(seq1, seq2);
-  }
+void shapeAncs(dmat* mydm, seq* seq1, seq* seq2, hll* myres) {
+  int *starts = (int*) malloc(sizeof(int)*(seq1->numlets + seq2->numlets+3));
+  int *ends = (int*) malloc(sizeof(int)*(seq1->numlets + seq2->numlets+3));
   //  printf("khe0\n");
   doShapes(myres, mydm, starts, ends);
   //  printf("khe1\n");
@@ -398,6 +409,14 @@ void parseAncs(dmat* mydm, seq* seq1, seq* seq2) {
   free(ends);
 }
 
+void parseAncs(dmat* mydm, seq* seq1, seq* seq2) {
+  hll* myres = 0;
+  if (ancfile) {
+    myres = readAncFile(seq1, seq2);
+  }
+  shapeAncs(mydm, seq1, seq2, myres);
+}
+
 void doAlign(dmat* mydm, seq* seq1, seq* seq2) {
   align *a = (align*) makeAlign(mydm, seq1->lets, seq2->lets);
   //  printf("into printing\n");
@@ -502,9 +521,10 @@ align* getChain(dmat* mydm, char* seq1, char* seq2, int x, int y, int inrun) {
     if (which == 0x3) {
       help = DMgetNeck(mydm, x, y,inrun);
       if (!help) {
+	free(almt);
 	return res;
       }
-      help->dirty = 1;
+      help->dirty++;
       res->nextalign = help;
       break;
     }
@@ -577,9 +597,38 @@ void saveNeck(dmat* mydm, char* seq1, char* seq2, int neckdiag) {
   }
 }
 
+/* Frees the chain and the parts of its tail no other chain refers to,
+   dirty counts the chains pointing at an alignment */
 void freeAlign(align* t) {
-  free(t->algn);
-  free(t);
+  align* n;
+  for (; t; t = n) {
+    n = t->nextalign;
+    free(t->algn);
+    free(t);
+    if (n && --n->dirty)
+      break;
+  }
+}
+
+/* Frees the alignments of the last two necks that no chain refers to,
+   the older neck goes first since the newer one points into it */
+void freeNecks(dmat* mydm) {
+  int i, j, k, n, diag, size;
+  int older = mydm->neckdiag[0] > mydm->neckdiag[1];
+  for (n = 0; n < 2; n++) {
+    i = n ? !older : older;
+    diag = mydm->neckdiag[i];
+    size = (diag>0)?mydm->diagend[diag]-mydm->diagstart[diag]+1 +
+      mydm->diagend[diag-1]-mydm->diagstart[diag-1]+1 : 0;
+    for (j = 0; j < 3; j++) {
+      for (k = 0; k < size; k++) {
+	if (mydm->myneck[i][j][k] && !mydm->myneck[i][j][k]->dirty)
+	  freeAlign(mydm->myneck[i][j][k]);
+      }
+      free(mydm->myneck[i][j]);
+      mydm->myneck[i][j] = 0;
+    }
+  }
 }
 
 void joinAligns (align* a) {
@@ -599,22 +648,156 @@ void joinAligns (align* a) {
   free (a->algn);
   a->algn = temp;
   a->algnlen = totsize;
-  for (a = a->nextalign; a;) {
-    t = a;
-    a = a->nextalign;
-    freeAlign(t);
+  if (n && !--n->dirty)
+    freeAlign(n);
+  a->nextalign = 0;
+}
+
+/* One cell of the recurrence, prevx is (x-1, y), prevxy is (x-1, y-1) and
+   prevy is (x, y-1) */
+void fillCell(alel* curr, alel* prevx, alel* prevxy, alel* prevy, char a, char b, char* ptr) {
+  register int s1, s2, s3;
+
+  s1 = prevxy->M;
+  s2 = prevxy->N + ((ISCB(b))?0:gapcont);
+  s3 = prevxy->O + ((ISCB(a))?0:gapcont);
+  curr->M = matchscore (a, b);
+  if (s1 >= s2){
+    if (s1 >= s3){ curr->M += s1; }
+    else         { curr->M += s3; }
+  }
+  else {
+    if (s2 >= s3){ curr->M += s2; }
+    else         { curr->M += s3; }
+  }
+
+  s1 = curr->M + ((ISCB(b))?0:gapstart);
+  s2 = prevx->N + ((ISCB(b))?0:gapcont);
+  if (s1 >= s2){ curr->N = s1; *ptr = 0; }
+  else         { curr->N = s2; *ptr = 4; }
+      
+  s1 = curr->M + ((ISCB(a))?0:gapstart);
+  s2 = prevy->O + ((ISCB(a))?0:gapcont);
+  if (s1 >= s2){ curr->O = s1; }
+  else         { curr->O = s2; *ptr |= 8; }
+
+  if (curr->M >= curr->N){
+    if (curr->M < curr->O)
+      *ptr |= 2;
+  }
+  else {
+    if (curr->N >= curr->O)
+      *ptr |= 1;
+    else
+      *ptr |= 2;
   }
 }
 
+#ifdef ORDER_SSE41
+/* Splits four consecutive cells into the M, N and O scores and back */
+SSE41_TARGET void loadCells(alel* c, __m128i* m, __m128i* n, __m128i* o) {
+  __m128i r0 = _mm_loadu_si128((__m128i*) c);
+  __m128i r1 = _mm_loadu_si128((__m128i*) c + 1);
+  __m128i r2 = _mm_loadu_si128((__m128i*) c + 2);
+  *m = _mm_shuffle_epi32(_mm_blend_epi16(_mm_blend_epi16(r0, r1, 0x30), r2, 0x0c), _MM_SHUFFLE(1,2,3,0));
+  *n = _mm_shuffle_epi32(_mm_blend_epi16(_mm_blend_epi16(r0, r1, 0xc3), r2, 0x30), _MM_SHUFFLE(2,3,0,1));
+  *o = _mm_shuffle_epi32(_mm_blend_epi16(_mm_blend_epi16(r0, r1, 0x0c), r2, 0xc3), _MM_SHUFFLE(3,0,1,2));
+}
+
+SSE41_TARGET void storeCells(alel* c, __m128i m, __m128i n, __m128i o) {
+  m = _mm_shuffle_epi32(m, _MM_SHUFFLE(1,2,3,0));
+  n = _mm_shuffle_epi32(n, _MM_SHUFFLE(2,3,0,1));
+  o = _mm_shuffle_epi32(o, _MM_SHUFFLE(3,0,1,2));
+  _mm_storeu_si128((__m128i*) c, _mm_blend_epi16(_mm_blend_epi16(m, n, 0x0c), o, 0x30));
+  _mm_storeu_si128((__m128i*) c + 1, _mm_blend_epi16(_mm_blend_epi16(n, o, 0x0c), m, 0x30));
+  _mm_storeu_si128((__m128i*) c + 2, _mm_blend_epi16(_mm_blend_epi16(o, m, 0x0c), n, 0x30));
+}
+
+/* fillCell for the four cells starting at (x, y), all their neighbours must
+   be in the band */
+SSE41_TARGET void fillCells4(alel* curr, alel* prevx, alel* prevxy, alel* prevy, char* seq1, char* seq2, int x, int y, char* ptr) {
+  __m128i m, n, o, pm, pn, po, t, s1, s2, ptrs;
+  __m128i dot = _mm_set1_epi32('.'), one = _mm_set1_epi32(1), two = _mm_set1_epi32(2);
+  __m128i cb1 = _mm_cmpeq_epi32(_mm_setr_epi32(seq1[x-1], seq1[x], seq1[x+1], seq1[x+2]), dot);
+  __m128i cb2 = _mm_cmpeq_epi32(_mm_setr_epi32(seq2[y-1], seq2[y-2], seq2[y-3], seq2[y-4]), dot);
+  __m128i gc1 = _mm_andnot_si128(cb1, _mm_set1_epi32(gapcont));
+  __m128i gc2 = _mm_andnot_si128(cb2, _mm_set1_epi32(gapcont));
+  __m128i gs1 = _mm_andnot_si128(cb1, _mm_set1_epi32(gapstart));
+  __m128i gs2 = _mm_andnot_si128(cb2, _mm_set1_epi32(gapstart));
+  int res;
+
+  loadCells(prevxy, &pm, &pn, &po);
+  m = _mm_max_epi32(_mm_max_epi32(pm, _mm_add_epi32(pn, gc2)), _mm_add_epi32(po, gc1));
+  m = _mm_add_epi32(m, _mm_setr_epi32(matchscore(seq1[x-1], seq2[y-1]), matchscore(seq1[x], seq2[y-2]),
+				      matchscore(seq1[x+1], seq2[y-3]), matchscore(seq1[x+2], seq2[y-4])));
+
+  loadCells(prevx, &t, &pn, &t);
+  s1 = _mm_add_epi32(m, gs2);
+  s2 = _mm_add_epi32(pn, gc2);
+  n = _mm_max_epi32(s1, s2);
+  ptrs = _mm_and_si128(_mm_cmpgt_epi32(s2, s1), _mm_set1_epi32(4));
+
+  loadCells(prevy, &t, &t, &po);
+  s1 = _mm_add_epi32(m, gs1);
+  s2 = _mm_add_epi32(po, gc1);
+  o = _mm_max_epi32(s1, s2);
+  ptrs = _mm_or_si128(ptrs, _mm_and_si128(_mm_cmpgt_epi32(s2, s1), _mm_set1_epi32(8)));
+
+  t = _mm_blendv_epi8(_mm_and_si128(_mm_cmpgt_epi32(o, m), two),
+		      _mm_blendv_epi8(one, two, _mm_cmpgt_epi32(o, n)), _mm_cmpgt_epi32(n, m));
+  ptrs = _mm_or_si128(ptrs, t);
+  storeCells(curr, m, n, o);
+
+  ptrs = _mm_packs_epi32(ptrs, ptrs);
+  res = _mm_cvtsi128_si32(_mm_packus_epi16(ptrs, ptrs));
+  memcpy(ptr, &res, 4);
+}
+#endif
+
+/* Fills diagonal dn and its pointers. The cells with all the neighbours
+   inside the band go four at a time when the processor has SSE4.1. */
+void fillDiag(dmat* mydm, char* seq1, char* seq2, int dn, char* ptrs) {
+  int size, x, y, j, lo, hi, sse41 = 0;
+  int offx, firstx, lastx, offxy, firstxy, lastxy, offy, firsty, lasty;
+  alel *curr = DMgetDiagStart(mydm, dn, &size, &x, &y);
+  alel *prevx = DMgetNeighbours(mydm, dn, 1, 0, &offx, &firstx, &lastx);
+  alel *prevxy = DMgetNeighbours(mydm, dn, 1, 1, &offxy, &firstxy, &lastxy);
+  alel *prevy = DMgetNeighbours(mydm, dn, 0, 1, &offy, &firsty, &lasty);
+
+  lo = MAX3(firstx, firstxy, firsty);
+  hi = MIN2(MIN2(lastx, lastxy), lasty) + 1;
+#ifdef ORDER_SSE41
+  sse41 = __builtin_cpu_supports("sse4.1");
+#endif
+  for (j = 0; j < size; j++) {
+#ifdef ORDER_SSE41
+    if (sse41 && j >= lo && j + 4 <= hi) {
+      fillCells4(curr + j, prevx + j + offx, prevxy + j + offxy, prevy + j + offy,
+		 seq1, seq2, x + j, y - j, ptrs + j);
+      j += 3;
+      continue;
+    }
+#endif
+    fillCell(curr + j,
+	     (j >= firstx && j <= lastx) ? prevx + j + offx : &dummy,
+	     (j >= firstxy && j <= lastxy) ? prevxy + j + offxy : &dummy,
+	     (j >= firsty && j <= lasty) ? prevy + j + offy : &dummy,
+	     seq1[x+j-1], seq2[y-j-1], ptrs + j);
+  }
+  DMsetPtrs(mydm, dn, ptrs);
+}
+
 align* makeAlign(dmat* mydm, char* seq1, char* seq2) {
-  int i, j;
-  int x, y, size;
-  alel *curr, *pasts0, *pasts1, *pasts2;
+  int i;
+  int x, y, size, maxsize = 0;
+  alel *curr;
   align* a;
-  char isneck;
+  char isneck, *ptrs;
   int ndiags = mydm->d1 + mydm->d2 -1;
-  register int s1, s2, s3;
-  register char ptr;
+
+  for (i = 1; i <= ndiags; i++)
+    maxsize = MAX2(maxsize, mydm->diagend[i] - mydm->diagstart[i] + 1);
+  ptrs = (char*) malloc (maxsize + 1);
 
   isneck = DMnextDiag(mydm);
   curr = DMgetDiagStart(mydm, 1, &size, &x, &y);
@@ -626,80 +809,18 @@ align* makeAlign(dmat* mydm, char* seq1, char* seq2) {
     isneck = DMnextDiag(mydm);
     if (!(i%10000))
       fprintf(stderr, "WORKING %d/%d\n", i/10000, ndiags/10000);
-    curr = DMgetDiagStart(mydm, i, &size, &x, &y);
-
-    pasts2 = DMgetElem(mydm, x-1, y);
-    pasts1 = DMgetElem(mydm, x-1, y-1);
-    for (j = 0; j < size; j++) {
-
-      /***************************************************/
-      pasts0 = pasts2;
-      pasts2 = DMgetElem2(mydm, x, y-1, pasts2);
-
-      s1 = pasts1->M;
-      s2 = pasts1->N + ((ISCB(seq2[y-1]))?0:gapcont);
-      s3 = pasts1->O + ((ISCB(seq1[x-1]))?0:gapcont);
-      curr->M = matchscore (seq1[x-1], seq2[y-1]);
-      if (s1 >= s2){
-	if (s1 >= s3){ curr->M += s1; /*ptr = 0;*/ }
-	else         { curr->M += s3; /*ptr = 2;*/ }
-      }
-      else {
-	if (s2 >= s3){ curr->M += s2; /*ptr = 1;*/ }
-	else         { curr->M += s3; /*ptr = 2;*/ }
-      }
-
-      s1 = curr->M + ((ISCB(seq2[y-1]))?0:gapstart);
-      s2 = pasts0->N + ((ISCB(seq2[y-1]))?0:gapcont);
-      if (s1 >= s2){ curr->N = s1; ptr = 0; }
-      else         { curr->N = s2; ptr = 4; }
-      
-      s1 = curr->M + ((ISCB(seq1[x-1]))?0:gapstart);
-      s2 = pasts2->O + ((ISCB(seq1[x-1]))?0:gapcont);
-      if (s1 >= s2){ curr->O = s1; }
-      else         { curr->O = s2; ptr |= 8; }
-      
-      s1 = curr->M;
-      s2 = curr->N;
-      s3 = curr->O;
-      if (curr->M >= curr->N){
-	if (curr->M < curr->O)
-	  ptr |= 2;
-      }
-      else {
-	if (curr->N >= curr->O)
-	  ptr |= 1;
-	else
-	  ptr |= 2;
-      }
-      //ptr |= WEQ3(curr->M, curr->N, curr->O, MAX3(curr->M, curr->N, curr->O));
-      //ptr = ptr | (WEQ2(curr->M+gapstart, pasts0->N+gapcont, curr->N) << 2); 
-      //ptr = ptr | (WEQ2(curr->M+gapstart, pasts0->O+gapcont, curr->O) << 3);
-      /***************************************************/
-      /*
-	curr->M = MAX3(pasts[1]->M, pasts[1]->N+gapcont, pasts[1]->O+gapcont); 
-	curr->M += matchscore(seq1[x-1], seq2[y-1]);
-	curr->N = MAX2(curr->M+gapstart, pasts[0]->N+gapcont); 
-	curr->O = MAX2(curr->M+gapstart, pasts[2]->O+gapcont); 
-	ptr = WEQ3(curr->M, curr->N, curr->O, MAX3(curr->M, curr->N, curr->O));
-	ptr = ptr | (WEQ2(curr->M+gapstart, pasts[0]->N+gapcont, curr->N) << 2); 
-	ptr = ptr | (WEQ2(curr->M+gapstart, pasts[0]->O+gapcont, curr->O) << 3);
-      */
-
-      DMsetPtr(mydm, ptr, x, y);
-      curr++; x++; y--;
-
-      pasts1 = DMgetElem2(mydm, x-1, y-1, pasts1);
-    }
+    fillDiag(mydm, seq1, seq2, i, ptrs);
     if ((i < ndiags - 2) && isneck) {
       saveNeck(mydm, seq1, seq2, i);
     }
   }
+  free(ptrs);
   mydm->currneck++;
   a = getChain(mydm, seq1, seq2, mydm->d1, mydm->d2, 0);
-  curr--;
+  curr = DMgetDiagStart(mydm, ndiags, &size, &x, &y) + size - 1;
   a->score = MAX3(curr->M, curr->N, curr->O);
   //  printf("here! %d\n", a);
+  freeNecks(mydm);
   joinAligns(a);
   return a;
 }
@@ -722,6 +843,7 @@ int printBinAlign(char* seq1, char* seq2, align* myalign) {
     putc(right, outfile);
   }
   fclose(outfile);
+  return 0;
 }
 
 int printTextAlign(char* seq1, char* seq2, align* myalign) {
@@ -766,6 +888,7 @@ int printTextAlign(char* seq1, char* seq2, align* myalign) {
   fprintf(outfile,"score = %d, nmatches = %d, nga=%d, ngb=%d nletters=%d, perc = %f\n",
 	 myalign->score,nm,nga,ngb,nlets,(float)nm/(float)nlets);
   fprintf(outfile,"\n");
+  return 0;
 }
 
 int printMFAAlign(char* seq1, char* seq2, align* myalign, char* n1, char* n2) {
@@ -798,6 +921,7 @@ int printMFAAlign(char* seq1, char* seq2, align* myalign, char* n1, char* n2) {
     } 
     fprintf(outfile, "\n");
   }
+  return 0;
 }
 
 int printXMFAAlign(char* seq1, char* seq2, align* myalign, char* n1, char* n2) {
@@ -830,6 +954,7 @@ int printXMFAAlign(char* seq1, char* seq2, align* myalign, char* n1, char* n2) {
     } 
     fprintf(outfile, "\n");
   }
+  return 0;
 }
 
 
@@ -18,6 +18,8 @@ int printAlign(char* seq1, char* seq2, align* myalign);
 void freeAlign(align* t);
 int printBinAlign(char* seq1, char* seq2, align* myalign);
 int printTextAlign(char* seq1, char* seq2, align* myalign);
+int printMFAAlign(char* seq1, char* seq2, align* myalign, char* n1, char* n2);
+int printXMFAAlign(char* seq1, char* seq2, align* myalign, char* n1, char* n2);
 
 #endif
 
@@ -8,6 +8,7 @@
 #include "skiplist.h"
 #include "multial.h"
 #include "filebuffer.h"
+#include "rechaos.h"
 
 #define VER_NUM "1.1"
 #define MIN2(x,y)   ( (x) >= (y) ? (y) : (x) )
@@ -28,7 +29,7 @@ static int extend = 1;
 static int fastreject = 0;
 static int gapfreechunks = 0;
 
-static align *simaligns[MAX_SEQ];
+static align **simaligns;
 static char* lagan_dir;
 
 static align *profile1 = 0;
@@ -51,8 +52,7 @@ static int hptrcomp (const void *p1, const void *p2) {
 
 
 void usage(void) {
-  printf("mlagan seqfile_1 seqfile_2 [... seqfile_%d] [-parameters]\n\n",
-	 MAX_SEQ);
+  printf("mlagan seqfile_1 seqfile_2 [... seqfile_n] [-parameters]\n\n");
   printf("-lazy : uses lazy mode\n");
   printf("-translate : use translated anchors\n");
   //  printf("-ext : extend the anchors\n");   This is now default
@@ -159,16 +159,16 @@ int getSeqNumber(align* res, seq* replacer) {
   return -1;
 }
 
-void appendAlignProfile(align *res, seq* seqwgaps) {
+void appendAlignProfile(align *res, int seqnum) {
   int i,j,k;
-  res->seqs[res->numseq] = seqwgaps;
+  seq* seqwgaps = res->seqs[seqnum];
   for (i=1; i < res->algnlen; i++) {
     if (seqwgaps->lets[i] != '-') {
       k=strchr(alpha,seqwgaps->lets[i])-alpha;
       if (k < 4) {
 	res->cnts[k][i]++;
       }
-      res->algn[i] |= (1 << res->numseq);
+      setLetter(res, seqnum, i);
       if (i > 0 && seqwgaps->lets[i-1] == '-')
 	res->cnts[CNTS_GE][i]++;
     }
@@ -178,10 +178,8 @@ void appendAlignProfile(align *res, seq* seqwgaps) {
       }
       else 
 	res->cnts[CNTS_GC][i]++;      
-      res->algn[i] |= (0 << res->numseq);
     }
   }
-  res->numseq++;
 }
 
 align* readProfile(FileBuffer with_gaps) {
@@ -194,29 +192,30 @@ align* readProfile(FileBuffer with_gaps) {
   res->numseq = 0;
   res->algnlen = -1;
   res->index = 32;
+  res->seqs = 0;
+  res->hlls = 0;
   
   while ( myseq = FileRead( with_gaps,0,0,VER_MLAGAN )) {
     //    fprintf(stdout, "seq: %s\n", myseq->lets);
-    if (res->algnlen < 0) {
+    if (res->algnlen < 0)
       res->algnlen = myseq->numlets;
-      res->algn = (long long int*) malloc((res->algnlen+1) * sizeof(long long int));
-      assert (res->algn);
-      for (j=0; j<CNTS_LEN; j++) {
-	res->cnts[j] = (char*) malloc((res->algnlen+1) * sizeof(char));    
-	assert (res->cnts[j]);
-      }
-      for (i=0; i<= res->algnlen;i++) {
-	for (j=0; j<CNTS_LEN; j++)
-	  res->cnts[j][i] = 0; 
-	res->algn[i] = 0;
-      }
-    }
     if ( res->algnlen != myseq->numlets) {
       fprintf (stderr, "Lengths screwed up!!!\n");
       exit(1);
     }
-    appendAlignProfile(res, myseq);
+    res->seqs = (seq**) realloc (res->seqs, (res->numseq+1) * sizeof(seq*));
+    res->seqs[res->numseq++] = myseq;
   }
+
+  // the width of the columns is known once all the rows are read
+  res->algn = (algword*) calloc((res->algnlen+1) * ALGN_WORDS(res->numseq), sizeof(algword));
+  assert (res->algn);
+  for (j=0; j<CNTS_LEN; j++) {
+    res->cnts[j] = (short*) calloc(res->algnlen+1, sizeof(short));    
+    assert (res->cnts[j]);
+  }
+  for (i=0; i < res->numseq; i++)
+    appendAlignProfile(res, i);
   if (verbose) {
     fprintf(stdout, "LOADED RES\n");
     printTextAlign(stdout,res);
@@ -287,6 +286,37 @@ hll* getAnchsFromFile(char *fname, FileBuffer f1, FileBuffer f2) {
 
 
 
+/* Runs the rechaos.pl search in this process, so no temporary files are
+   written. Returns 0 with *done unset for options only the script has. */
+hll* getAnchsInProcess(FileBuffer f1, FileBuffer f2, int *done) {
+  LaganAnchor *anchs;
+  hll *myres = 0, *tt;
+  int i, numanchs;
+
+  *done = 0;
+  if (!extend || translate || fastreject || lazy) {
+    return 0;
+  }
+  numanchs = rechaosAnchors(f1->filename, f2->filename, gapfreechunks, &anchs);
+  if (numanchs < 0) {
+    return 0;
+  }
+  for (i = 0; i < numanchs; i++) {
+    tt = (hll*) malloc(sizeof(hll));
+    tt->seq1start = anchs[i].start1;
+    tt->seq1end = anchs[i].end1;
+    tt->seq2start = anchs[i].start2;
+    tt->seq2end = anchs[i].end2;
+    tt->score = anchs[i].score;
+    tt->next = myres;
+    myres = tt;
+  }
+  free(anchs);
+  fprintf(stderr,"read %d anchs\n", numanchs);
+  *done = 1;
+  return myres;
+}
+
 hll* generateAnchors( FileBuffer a1, FileBuffer a2) {
   char buff[256];
   char fname[80];
@@ -296,7 +326,12 @@ hll* generateAnchors( FileBuffer a1, FileBuffer a2) {
   align* temp;
   hll* res;
   char flip = 0;
-  int retstat;
+  int retstat, done;
+
+  res = getAnchsInProcess(a1, a2, &done);
+  if (done) {
+    return res;
+  }
 
   name1 = strrchr (a1->filename, '/');
   if (!name1) name1 = a1->filename;
@@ -384,6 +419,7 @@ hll* findBestChain(hptr* array, int arrsize) {
   }
   t= (hll*)SLgetLast(skipper)->myelem;
   delSkLst(skipper);
+  free(skipper);
   return t;
 }
 
@@ -546,6 +582,8 @@ align* processAnchors(align *aligns[], align *a1, align *a2, int *index) {
   result->algnlen = -1;
   result->nextalign = 0;
   result->dirty = 0;
+  result->seqs = 0;
+  result->hlls = 0;
 
   orderAligns(a1, a2, &first, &second, index, &hllindex);
 
@@ -625,7 +663,7 @@ align* iterativeImprovement (align *current, align *rpntree[], int length) {
 
 
 
-int treeToRPN(char *treestr, align *stack[MAX_SEQ*2], int *depth) {
+int treeToRPN(char *treestr, align *stack[], int *depth) {
 
   int i=0; int j, k; 
   char buffer[256];
@@ -666,8 +704,8 @@ int treeToRPN(char *treestr, align *stack[MAX_SEQ*2], int *depth) {
  }
 }
 
-align* procStack(align* rpntree[MAX_SEQ*2], int length, align *myaligns[]) {
-  align* stack[MAX_SEQ];
+align* procStack(align* rpntree[], int length, align *myaligns[]) {
+  align** stack = (align**) malloc (numseqs * sizeof(align*)), *final;
   int i = 0, sp = 0;
   int index=0;
 
@@ -692,7 +730,9 @@ align* procStack(align* rpntree[MAX_SEQ*2], int length, align *myaligns[]) {
     if(verbose) printTextAlign(stdout, stack[sp-1]);  
   }
 
-  return stack[sp-1];
+  final = stack[sp-1];
+  free (stack);
+  return final;
 }
 
 
@@ -927,25 +967,27 @@ hll* updateAnchorPos(hll* myhll, FileBuffer f1, FileBuffer f2) {
   return res;
 }
 
-int connectedGraph(hll* graph[MAX_SEQ][MAX_SEQ], int numseqs) {
-  int M[MAX_SEQ][MAX_SEQ];
+/* graph[i*numseqs+j] are the anchors of the sequences i < j */
+int connectedGraph(hll** graph, int numseqs) {
+  char *M = (char*) calloc (numseqs * numseqs, sizeof(char));
   int i, j, k;
 
   for (i = 0; i < numseqs - 1; i++){
     for (j = i + 1; j < numseqs; j++){
-      M[i][j] = M[j][i] = (graph[i][j] != NULL);
+      M[i*numseqs+j] = M[j*numseqs+i] = (graph[i*numseqs+j] != NULL);
     }
   }
 
   for (k = 0; k < numseqs; k++)
     for (i = 0; i < numseqs; i++)
       for (j = 0; j < numseqs; j++)
-	if (M[i][k] && M[k][j]) M[i][j] = 1;
+	if (M[i*numseqs+k] && M[k*numseqs+j]) M[i*numseqs+j] = 1;
 
   k = 1;
   for (i = 0; k && i < numseqs; i++)
-    k = M[0][i];
+    k = M[i];
 
+  free (M);
   return k;
 }
 
@@ -955,16 +997,15 @@ int main(int argc, char** argv) {
   seq **seqs;
   int i = 1, j = 1, x, y;
   int pro1cnt=0, pro2cnt=0;
-  int pro1lst[MAX_SEQ], pro2lst[MAX_SEQ];
-  int pro1ptr[MAX_SEQ], pro2ptr[MAX_SEQ];
+  int *pro1lst, *pro2lst;
+  int *pro1ptr, *pro2ptr;
   char command[256];
 
   char *treestr = NULL;
-  align *stack[MAX_SEQ*2];
+  align **stack;
   align *final;
-  align *myaligns[MAX_SEQ];
-  hll* table[MAX_SEQ][MAX_SEQ];
-  FileBuffer files[MAX_SEQ];
+  align **myaligns;
+  FileBuffer *files;
 
   outfile = stdout;
   lagan_dir = getenv ("LAGAN_DIR");
@@ -973,10 +1014,11 @@ int main(int argc, char** argv) {
     exit(1);
   }
 
-  buildcache();
+  buildcache(0);
   initLib();
 
   seqs = (seq**) malloc((argc-1)*sizeof(seq*));
+  files = (FileBuffer*) malloc((argc-1)*sizeof(FileBuffer));
 
 
   if (parseParameters(argc, argv, files, &treestr)) return 1;
@@ -986,11 +1028,18 @@ int main(int argc, char** argv) {
 
   // Take all sequences and make simple alignments
 
+  pro1lst = (int*) malloc(numseqs*sizeof(int));
+  pro2lst = (int*) malloc(numseqs*sizeof(int));
+  pro1ptr = (int*) malloc(numseqs*sizeof(int));
+  pro2ptr = (int*) malloc(numseqs*sizeof(int));
+  myaligns = (align**) malloc(numseqs*sizeof(align*));
+  simaligns = (align**) malloc(numseqs*sizeof(align*));
   for (i=0; i<numseqs; i++) {
     seqs[i] = FileRead(files[i], 0, 0, VER_MLAGAN);
     seqs[i]->index = i+1;
     myaligns[i]=simaligns[i]=mkSimAlign(seqs[i]);
     simaligns[i]->index = i;
+    simaligns[i]->hlls = (hll**) calloc(numseqs, sizeof(hll*));
     x = getSeqNumber(profile1, seqs[i]);
     y = getSeqNumber(profile2, seqs[i]);
     if (x < 0 && y < 0) {
@@ -1024,11 +1073,8 @@ int main(int argc, char** argv) {
 
   // Find all pairwise anchors.
   fprintf(stderr,"pro1cnt = %d, pro2cnt = %d\n", pro1cnt, pro2cnt);
-  for (i=0; i<(numseqs-1); i++) {
-    for (j=i+1; j<numseqs; j++) {
-      simaligns[i]->hlls[j]=0;
-    }
-  }
+  // the pairs are independent, except with -fastreject that narrows the file bounds
+#pragma omp parallel for private(j) schedule(dynamic) if(!fastreject)
   for (i=0; i< pro1cnt; i++) {
     for (j=0; j< pro2cnt; j++) {
       if (pro1lst[i] < pro2lst[j]) {
@@ -1050,9 +1096,7 @@ int main(int argc, char** argv) {
 
   //  printf("\n");
 
-  for (i=0; i<MAX_SEQ*2; i++) {
-    stack[i] = NULL;
-  }
+  stack = (align**) calloc(numseqs*2, sizeof(align*));
 
 
   /*
@@ -0,0 +1,26 @@
+#ifndef __RECHAOS_H
+#define __RECHAOS_H
+
+/* In-process anchor generation for the C programs, see librechaos.cpp. */
+
+typedef struct LaganAnchorImplementation {
+  int start1, end1;
+  int start2, end2;
+  float score;
+} LaganAnchor;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Anchors of "rechaos.pl file1 file2 -ext [-gfc]" in the order the script
+   prints them. The array is malloc'ed and stored in *anchor, the number of
+   anchors is returned. Returns -1 if a file can't be read or has a masked
+   version (file.masked), the script has to be run then. */
+int rechaosAnchors (const char *file1, const char *file2, int gfc, LaganAnchor **anchor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
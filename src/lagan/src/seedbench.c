@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "fchaos.h"
+#include "skiplist.h"
+#include "thrtrie.h"
+#include "kmerindex.h"
+#include "filebuffer.h"
+
+/* Times the seeding stage of CHAOS: building the index of the query and
+   looking up the words of every dbase sequence, with the threaded trie and
+   with the flat k-mer index. */
+
+LAGAN_TLS int wordlen = 10;
+LAGAN_TLS int ndegen = 1;
+
+typedef struct SeedStats {
+  double build, lookup;
+  long words, locations;
+} stats;
+
+double seconds(clock_t from) {
+  return (double)(clock() - from) / CLOCKS_PER_SEC;
+}
+
+void count(LList* res, stats* st) {
+  LList* next;
+  while (res) {
+    st->words++;
+    st->locations += res->myloc->numlocs;
+    next = res->next;
+    free(res);
+    res = next;
+  }
+}
+
+void benchTrie(seq* query, seq** dbase, int numdbase, stats* st) {
+  clock_t start = clock();
+  TNode* root = makeTrie(wordlen, "ATCG");
+  char* currword;
+  int i;
+  insertString(root, query->lets);
+  st->build = seconds(start);
+  start = clock();
+  for (i = 0; i < numdbase; i++) {
+    for (currword = dbase[i]->lets; *currword; currword++)
+      count(getNextWords(root, currword, ndegen), st);
+    cleanJobQueue();
+  }
+  st->lookup = seconds(start);
+  freeTrie(root);
+}
+
+void benchFlat(seq* query, seq** dbase, int numdbase, stats* st) {
+  clock_t start = clock();
+  KIndex* index = makeKmerIndex(query->lets, wordlen);
+  LList* res[KI_BATCH];
+  int i, j, from, looked;
+  st->build = seconds(start);
+  start = clock();
+  for (i = 0; i < numdbase; i++) {
+    for (from = 0; (looked = getNextWordsBatch(index, dbase[i]->lets, from, KI_BATCH, ndegen, res)); from += looked)
+      for (j = 0; j < looked; j++)
+	count(res[j], st);
+  }
+  st->lookup = seconds(start);
+  freeKmerIndex(index);
+}
+
+void report(char* name, stats* st) {
+  printf("%s: build %.3f s, lookup %.3f s, %ld words, %ld locations\n",
+	 name, st->build, st->lookup, st->words, st->locations);
+}
+
+int main(int argc, char** argv) {
+  FileBuffer query, dbase;
+  seq *currquery, **dbaseseqs = 0;
+  stats trie = {0, 0, 0, 0}, flat = {0, 0, 0, 0};
+  int numdbase = 0, i;
+
+  if (argc < 3) {
+    printf("usage: \nseedbench queryfile dbasefile [-wl #] [-nd #]\n");
+    return 1;
+  }
+  if (!(query = FileOpen(argv[1])) || !(dbase = FileOpen(argv[2]))) {
+    printf("couldnt open %s or %s\n", argv[1], argv[2]);
+    return 2;
+  }
+  for (i = 3; i < argc; i++) {
+    if (!strcmp(argv[i], "-wl") && i + 1 < argc)
+      wordlen = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "-nd") && i + 1 < argc)
+      ndegen = atoi(argv[++i]);
+  }
+  if (wordlen < 1 || wordlen > KI_MAX_WORDLEN || ndegen < 0 || ndegen > MAX_DEGEN) {
+    printf("word length must be in [1, %d] and degeneracy in [0, %d]\n", KI_MAX_WORDLEN, MAX_DEGEN);
+    return 1;
+  }
+
+  currquery = FileRead(query, 0, 0, VER_FCHAOS);
+  while ((dbaseseqs = (seq**) realloc(dbaseseqs, sizeof(seq*) * (numdbase + 1))) &&
+	 (dbaseseqs[numdbase] = FileRead(dbase, 0, 0, VER_FCHAOS)))
+    numdbase++;
+  printf("query %d letters, dbase %d sequences, word length %d, degeneracy %d\n",
+	 currquery->numlets, numdbase, wordlen, ndegen);
+
+  benchTrie(currquery, dbaseseqs, numdbase, &trie);
+  report("trie", &trie);
+  benchFlat(currquery, dbaseseqs, numdbase, &flat);
+  report("flat", &flat);
+  if (trie.words != flat.words || trie.locations != flat.locations)
+    printf("the trie misses or repeats some degenerate words, the flat index has each of them once\n");
+  return 0;
+}
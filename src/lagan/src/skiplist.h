@@ -1,3 +1,6 @@
+#ifndef __SKIPLIST_H
+#define __SKIPLIST_H
+
 #define MAX_LISTS 32
 
 typedef struct skiplistelem {
@@ -27,3 +30,4 @@ sle* SLlowFind(sklst* trgt, int index);
 sle* mksle(int linkcnt, int index, void* myelem);
 void delSLE(sle* tbd);
 
+#endif
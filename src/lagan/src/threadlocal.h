@@ -0,0 +1,11 @@
+#ifndef __THREADLOCAL_H
+#define __THREADLOCAL_H
+
+/* Storage class of the mutable globals. The stand-alone programs leave it
+   empty; the in-process library (liblagan.h) defines it as thread-local so
+   that several alignments can run at the same time. */
+#ifndef LAGAN_TLS
+#define LAGAN_TLS
+#endif
+
+#endif
@@ -4,17 +4,18 @@
 #include "skiplist.h"
 #include "thrtrie.h"
 #include <assert.h>
-int triealphasize=0;
-int nnodes=0;
+LAGAN_TLS int indeces[256];
+LAGAN_TLS int triealphasize=0;
+LAGAN_TLS int nnodes=0;
 
 
 #define DEBUG 1
 #define JQ_SIZE 1024
 #include "mempage.c"
 
-TJob* jobqueue=0;
-int jqsize = 1;
-int numjobs = 0;
+LAGAN_TLS TJob* jobqueue=0;
+LAGAN_TLS int jqsize = 1;
+LAGAN_TLS int numjobs = 0;
 
 void makeAlpha(char* alpha) {
   int i;
@@ -57,7 +58,7 @@ void junker (TNode** m){
   
 }
 
-int tccc = 0;
+LAGAN_TLS int tccc = 0;
 
 void freeTrie (TNode* trgt) {
   /*
@@ -209,7 +210,7 @@ void addjob(TNode* tn, char *thisdeg, char dirty, int oldindex) {
   else {
     jobqueue[numjobs].numdeg = 0;
   }
-  if (thisdeg>0) {
+  if (thisdeg) {
     jobqueue[numjobs].degloc[jobqueue[numjobs].numdeg++] = thisdeg;
   }
   numjobs++;
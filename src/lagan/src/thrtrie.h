@@ -1,8 +1,12 @@
+#ifndef __THRTRIE_H
+#define __THRTRIE_H
+
 #include "fchaos.h"
+#include "threadlocal.h"
 #define MAX_DEGEN 2
 
 
-int indeces[256];
+extern LAGAN_TLS int indeces[256];
 
 typedef struct PrevHits {
   int* inds1;
@@ -65,3 +69,4 @@ void cleanJobQueue();
 LList* getNextWords(TNode* root, char* word, int ndegen);
 void insertString(TNode* root, char* tbi);
 
+#endif
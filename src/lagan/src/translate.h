@@ -1,3 +1,7 @@
+#ifndef __TRANSLATE_H
+#define __TRANSLATE_H
 
 seq* transSeq(seq*, int);
 char toPeptide (char* dnaword, char revcomp);
+
+#endif
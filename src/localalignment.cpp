@@ -0,0 +1,270 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+#pragma GCC diagnostic ignored "-Wpragmas"
+#pragma GCC diagnostic ignored "-Wc++11-extensions"
+
+#include <seqan/align.h>
+#undef min
+#undef max
+#include "localalignment.h"
+
+#if defined(__SSE4_1__)
+	#include <smmintrin.h>
+#elif defined(__SSE2__)
+	#include <emmintrin.h>
+#endif
+
+namespace SyntenyFinder
+{
+	namespace
+	{
+		typedef unsigned short Cell;
+		const Cell MAX_CELL = 0xFFFF;
+
+		//Saturating unsigned arithmetic keeps the scores clamped at zero for free
+	#if defined(__SSE2__)
+		typedef __m128i Vector;
+		inline Vector Broadcast(Cell value) { return _mm_set1_epi16(static_cast<short>(value)); }
+		inline Vector Load(const Cell * ptr) { return _mm_loadu_si128(reinterpret_cast<const Vector*>(ptr)); }
+		inline void Store(Cell * ptr, Vector value) { _mm_storeu_si128(reinterpret_cast<Vector*>(ptr), value); }
+		inline Vector AddSat(Vector a, Vector b) { return _mm_adds_epu16(a, b); }
+		inline Vector SubSat(Vector a, Vector b) { return _mm_subs_epu16(a, b); }
+	#if defined(__SSE4_1__)
+		inline Vector Max(Vector a, Vector b) { return _mm_max_epu16(a, b); }
+	#else
+		inline Vector Max(Vector a, Vector b) { return _mm_adds_epu16(_mm_subs_epu16(a, b), b); }
+	#endif
+		inline bool AnyGreater(Vector a, Vector b) { return _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_subs_epu16(a, b), _mm_setzero_si128())) != 0xFFFF; }
+		//Moves every lane one position up, the first lane becomes zero
+		inline Vector ShiftLanes(Vector a) { return _mm_slli_si128(a, sizeof(Cell)); }
+	#else
+		typedef Cell Vector;
+		inline Vector Broadcast(Cell value) { return value; }
+		inline Vector Load(const Cell * ptr) { return *ptr; }
+		inline void Store(Cell * ptr, Vector value) { *ptr = value; }
+		inline Vector AddSat(Vector a, Vector b) { return static_cast<Cell>(std::min(static_cast<size_t>(a) + b, static_cast<size_t>(MAX_CELL))); }
+		inline Vector SubSat(Vector a, Vector b) { return a > b ? a - b : 0; }
+		inline Vector Max(Vector a, Vector b) { return std::max(a, b); }
+		inline bool AnyGreater(Vector a, Vector b) { return a > b; }
+		inline Vector ShiftLanes(Vector) { return 0; }
+	#endif
+
+		const size_t LANES = sizeof(Vector) / sizeof(Cell);
+
+		//Seqan fills the matrix from the ends of the sequences: cell (i, j) is the best
+		//score of an alignment that starts at sequence1[i] and sequence2[j]. Here the
+		//same matrix is computed column by column for j = n - 1 .. 0, and every column
+		//is stored in the striped order: cell i lives in the lane (m - 1 - i) / segments
+		//of the segment (m - 1 - i) % segments.
+		class StripedMatrix
+		{
+		public:
+			StripedMatrix(const std::string & sequence1, const std::string & sequence2, int match, int mismatch, int gap):
+				sequence1_(sequence1), sequence2_(sequence2), segments_((sequence1.size() + LANES - 1) / LANES),
+				bestScore_(0), bestColumn_(0), bestRow_(0)
+			{
+				cell_.assign((sequence2.size() + 1) * segments_ * LANES, 0);
+				BuildProfile(match, mismatch);
+				Fill(static_cast<Cell>(-gap));
+			}
+
+			Cell Score() const
+			{
+				return bestScore_;
+			}
+
+			std::pair<size_t, size_t> BestCell() const
+			{
+				return std::make_pair(bestRow_, bestColumn_);
+			}
+
+			Cell operator () (size_t i, size_t j) const
+			{
+				if(i >= sequence1_.size() || j >= sequence2_.size())
+				{
+					return 0;
+				}
+
+				size_t pos = sequence1_.size() - 1 - i;
+				return cell_[(sequence2_.size() - j) * segments_ * LANES + (pos % segments_) * LANES + pos / segments_];
+			}
+
+		private:
+			const std::string & sequence1_;
+			const std::string & sequence2_;
+			size_t segments_;
+			Cell bestScore_;
+			size_t bestColumn_;
+			size_t bestRow_;
+			std::vector<Cell> cell_;
+			std::vector<Cell> profile_;
+			std::vector<size_t> profileId_;
+
+			void BuildProfile(int match, int mismatch)
+			{
+				const size_t NO_PROFILE = -1;
+				size_t profileSize = 2 * segments_ * LANES;
+				profileId_.assign(1 << (sizeof(char) * 8), NO_PROFILE);
+				for(size_t j = 0; j < sequence2_.size(); j++)
+				{
+					unsigned char ch = static_cast<unsigned char>(sequence2_[j]);
+					if(profileId_[ch] != NO_PROFILE)
+					{
+						continue;
+					}
+
+					//For every segment, the bonus vector is followed by the penalty vector
+					profileId_[ch] = profile_.size() / profileSize;
+					profile_.resize(profile_.size() + profileSize);
+					Cell * bonus = &profile_[profile_.size() - profileSize];
+					for(size_t segment = 0; segment < segments_; segment++, bonus += 2 * LANES)
+					{
+						for(size_t lane = 0; lane < LANES; lane++)
+						{
+							size_t pos = lane * segments_ + segment;
+							if(pos >= sequence1_.size())
+							{
+								bonus[lane] = 0;
+								bonus[lane + LANES] = MAX_CELL;
+							}
+							else
+							{
+								bool equal = sequence1_[sequence1_.size() - 1 - pos] == sequence2_[j];
+								bonus[lane] = equal ? static_cast<Cell>(match) : 0;
+								bonus[lane + LANES] = equal ? 0 : static_cast<Cell>(-mismatch);
+							}
+						}
+					}
+				}
+			}
+
+			void Fill(Cell gap)
+			{
+				Vector gapVector = Broadcast(gap);
+				size_t columnSize = segments_ * LANES;
+				for(size_t column = 1; column <= sequence2_.size(); column++)
+				{
+					const Cell * profile = &profile_[profileId_[static_cast<unsigned char>(sequence2_[sequence2_.size() - column])] * 2 * columnSize];
+					const Cell * prev = &cell_[(column - 1) * columnSize];
+					Cell * now = &cell_[column * columnSize];
+					Vector vMax = Broadcast(0);
+					Vector vF = Broadcast(0);
+					Vector vH = ShiftLanes(Load(prev + columnSize - LANES));
+					for(size_t segment = 0; segment < segments_; segment++)
+					{
+						vH = SubSat(AddSat(vH, Load(profile + 2 * segment * LANES)), Load(profile + (2 * segment + 1) * LANES));
+						vH = Max(vH, SubSat(Load(prev + segment * LANES), gapVector));
+						vH = Max(vH, vF);
+						vMax = Max(vMax, vH);
+						Store(now + segment * LANES, vH);
+						vF = SubSat(vH, gapVector);
+						vH = Load(prev + segment * LANES);
+					}
+
+					//Gaps that cross the lane boundaries, they never raise the column maximum
+					vF = ShiftLanes(vF);
+					for(size_t segment = 0; AnyGreater(vF, Load(now + segment * LANES)); )
+					{
+						Store(now + segment * LANES, Max(vF, Load(now + segment * LANES)));
+						vF = SubSat(vF, gapVector);
+						if(++segment == segments_)
+						{
+							segment = 0;
+							vF = ShiftLanes(vF);
+						}
+					}
+
+					//Seqan keeps the first maximum it meets, i.e. the largest j and then the largest i
+					if(AnyGreater(vMax, Broadcast(bestScore_)))
+					{
+						Cell buf[LANES];
+						Store(buf, vMax);
+						bestScore_ = *std::max_element(buf, buf + LANES);
+						bestColumn_ = sequence2_.size() - column;
+					}
+				}
+
+				for(size_t i = sequence1_.size(); bestScore_ > 0 && i > 0; i--)
+				{
+					if((*this)(i - 1, bestColumn_) == bestScore_)
+					{
+						bestRow_ = i - 1;
+						break;
+					}
+				}
+			}
+		};
+	}
+
+	void SeqanLocalAlignment(const std::string & sequence1, const std::string & sequence2, int match, int mismatch, int gap,
+		std::pair<size_t, size_t> & coord1, std::pair<size_t, size_t> & coord2)
+	{
+		using namespace seqan;
+		typedef String<char>				TSequence;	// sequence type
+		typedef Align<TSequence, ArrayGaps>	TAlign;		// align type
+
+		TSequence seq1 = sequence1;
+		TSequence seq2 = sequence2;
+		TAlign align;
+		resize(rows(align), 2);
+		assignSource(row(align, 0), seq1);
+		assignSource(row(align, 1), seq2);
+		localAlignment(align, Score<int>(match, mismatch, gap));
+		coord1.first = clippedBeginPosition(row(align, 0));
+		coord1.second = clippedEndPosition(row(align, 0));
+		coord2.first = clippedBeginPosition(row(align, 1));
+		coord2.second = clippedEndPosition(row(align, 1));
+	}
+
+	void StripedLocalAlignment(const std::string & sequence1, const std::string & sequence2, int match, int mismatch, int gap,
+		std::pair<size_t, size_t> & coord1, std::pair<size_t, size_t> & coord2)
+	{
+		assert(match > 0 && mismatch <= 0 && gap <= 0);
+		if(static_cast<size_t>(match) * std::min(sequence1.size(), sequence2.size()) >= MAX_CELL || -mismatch >= MAX_CELL || -gap >= MAX_CELL)
+		{
+			SeqanLocalAlignment(sequence1, sequence2, match, mismatch, gap, coord1, coord2);
+			return;
+		}
+
+		coord1 = std::make_pair(0, sequence1.size());
+		coord2 = std::make_pair(0, sequence2.size());
+		if(sequence1.empty() || sequence2.empty())
+		{
+			return;
+		}
+
+		StripedMatrix matrix(sequence1, sequence2, match, mismatch, gap);
+		if(matrix.Score() == 0)
+		{
+			return;
+		}
+
+		//The same traceback as the one seqan performs
+		size_t i = matrix.BestCell().first;
+		size_t j = matrix.BestCell().second;
+		coord1.first = i;
+		coord2.first = j;
+		while(matrix(i, j) != 0 && i < sequence1.size() && j < sequence2.size())
+		{
+			bool goFirst = true;
+			bool goSecond = true;
+			if(sequence1[i] != sequence2[j])
+			{
+				int v = matrix(i + 1, j) + gap;
+				int d = matrix(i + 1, j + 1) + mismatch;
+				int h = matrix(i, j + 1) + gap;
+				goFirst = v >= h || d >= h;
+				goSecond = h > v || d >= v;
+			}
+
+			i += goFirst ? 1 : 0;
+			j += goSecond ? 1 : 0;
+		}
+
+		coord1.second = i;
+		coord2.second = j;
+	}
+}
@@ -0,0 +1,23 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#ifndef _LOCAL_ALIGNMENT_H_
+#define _LOCAL_ALIGNMENT_H_
+
+#include "common.h"
+
+namespace SyntenyFinder
+{
+	//Smith-Waterman alignment with linear gap costs (mismatch and gap are negative).
+	//Aligned regions are returned as half-open intervals of the sequences.
+	void SeqanLocalAlignment(const std::string & sequence1, const std::string & sequence2, int match, int mismatch, int gap,
+		std::pair<size_t, size_t> & coord1, std::pair<size_t, size_t> & coord2);
+	//Striped (Farrar) implementation, returns exactly the same alignment as the seqan one
+	void StripedLocalAlignment(const std::string & sequence1, const std::string & sequence2, int match, int mismatch, int gap,
+		std::pair<size_t, size_t> & coord1, std::pair<size_t, size_t> & coord2);
+}
+
+#endif
@@ -7,21 +7,14 @@
 #pragma GCC diagnostic ignored "-Wc++11-extensions"
 
 #include "outputgenerator.h"
+#include "blockcoords.h"
+#include "sequencewriter.h"
 #include "platform.h"
 
 namespace SyntenyFinder
 {
 	namespace
 	{
-		const char COVERED = 1;
-		typedef std::pair<size_t, std::vector<BlockInstance> > GroupedBlock;
-		typedef std::vector<GroupedBlock> GroupedBlockList;		
-
-		bool ByFirstElement(const GroupedBlock & a, const GroupedBlock & b)
-		{
-			return a.first < b.first;
-		}
-
 		std::string IntToStr(size_t x)
 		{
 			std::stringstream ss;
@@ -43,6 +36,15 @@ namespace SyntenyFinder
 				return ss.str();
 			}
 
+		template<class T>
+			void WriteColumn(std::ostream & out, const std::vector<T> & column)
+			{
+				if(!column.empty())
+				{
+					out.write(reinterpret_cast<const char*>(&column[0]), column.size() * sizeof(T));
+				}
+			}
+
 		std::string OutputIndex(const BlockInstance & block)
 		{
 			std::stringstream out;
@@ -51,24 +53,52 @@ namespace SyntenyFinder
 			return out.str();
 		}
 
-		void OutputBlocks(const std::vector<BlockInstance>& block, std::ofstream& out)
+		void OutputBlocks(const GroupedBlockList & block, std::ofstream& out)
 		{
-			std::vector<IndexPair> group;
-			std::vector<BlockInstance> blockList = block;
-			GroupBy(blockList, compareById, std::back_inserter(group));
-			for(std::vector<IndexPair>::iterator it = group.begin(); it != group.end(); ++it)
+			const std::vector<IndexPair> & group = block.GetGroups();
+			std::vector<BlockInstance> blockList = block.GetBlocks();
+			for(std::vector<IndexPair>::const_iterator it = group.begin(); it != group.end(); ++it)
 			{
 				size_t length = it->second - it->first;
 				std::sort(blockList.begin() + it->first, blockList.begin() + it->second, compareByChrId);
-				out << "Block #" << blockList[it->first].GetBlockId() << std::endl;
-				out << "Seq_id\tStrand\tStart\tEnd\tLength" << std::endl;
+				out << "Block #" << blockList[it->first].GetBlockId() << '\n';
+				out << "Seq_id\tStrand\tStart\tEnd\tLength" << '\n';
 				CopyN(CFancyIterator(blockList.begin() + it->first, OutputIndex, std::string()),
 						length, std::ostream_iterator<std::string>(out, "\n"));
-				out << DELIMITER << std::endl;
+				out << DELIMITER << '\n';
 			}
 		}
 
 
+		//An alignment block of MAF, reverse strand starts are counted from the chromosome end
+		void OutputAlignmentMAF(std::ofstream & out, const BlockAligner::Block & block, const BlockAligner::Alignment & alignment)
+		{
+			out << "a\n";
+			for(size_t i = 0; i < alignment.row.size(); i++)
+			{
+				const BlockInstance & instance = block.instance[alignment.order[i]];
+				size_t chrSize = instance.GetChrInstance().GetSequence().size();
+				size_t start = instance.GetDirection() == DNASequence::positive ? instance.GetStart() : chrSize - instance.GetEnd();
+				out << "s " << instance.GetChrInstance().GetDescription() << ' ' << start << ' ' << instance.GetLength() << ' ';
+				out << (instance.GetSignedBlockId() > 0 ? '+' : '-') << ' ' << chrSize << ' ' << alignment.row[i] << '\n';
+			}
+
+			out << '\n';
+		}
+
+		void PassAlignment(std::ofstream * maf, VariantCaller * variantCaller, const BlockAligner::Block & block, const BlockAligner::Alignment & alignment)
+		{
+			if(maf != 0)
+			{
+				OutputAlignmentMAF(*maf, block, alignment);
+			}
+
+			if(variantCaller != 0)
+			{
+				variantCaller->AddAlignment(block, alignment);
+			}
+		}
+
 		// function to sort blocks in one chromosome by starting position (it's sorted lexicographically by D3)
 		std::string OutputD3BlockID(const BlockInstance & block)
 		{
@@ -86,63 +116,74 @@ namespace SyntenyFinder
 			return out.str();
 		}
 
-		void OutputLink(std::vector<BlockInstance>::iterator block, int color, int fillLength,
-						int linkId, std::ostream& stream)
+		//Keeps the blocks with the largest total length, at most maxInstances instances
+		void SelectLargestBlocks(std::vector<BlockInstance> & blockList, size_t maxInstances)
 		{
-			size_t start = block->GetConventionalStart();
-			size_t end = block->GetConventionalEnd();
-			if (start > end) std::swap(start, end);
-
-			stream << "block_" << std::setw(fillLength) << std::setfill('0') << linkId << " ";
-			stream << "seq" << block->GetChrId() + 1 << " ";
-			stream << start << " " << end;
-			stream << " color=chr" << color << "_a2" << std::endl;
-		}
-
-		template<class Iterator>
-			void OutputLines(Iterator start, size_t length, std::ostream & out)
+			std::vector<IndexPair> group;
+			GroupBy(blockList, compareById, std::back_inserter(group));
+			std::vector<std::pair<size_t, size_t> > blockLength;
+			for(size_t i = 0; i < group.size(); i++)
 			{
-				for(size_t i = 1; i <= length; i++, ++start)
+				size_t length = 0;
+				for(size_t j = group[i].first; j < group[i].second; j++)
 				{
-					out << *start;
-					if(i % 80 == 0 && i != length)
-					{
-						out << std::endl;
-					}
+					length += blockList[j].GetLength();
 				}
+
+				blockLength.push_back(std::make_pair(length, i));
 			}
 
-		std::vector<double> CalculateCoverage(const ChrList & chrList, GroupedBlockList::const_iterator start, GroupedBlockList::const_iterator end)
-		{
-			std::vector<double> ret;
-			std::vector<char> cover;
-			double totalBp = 0;
-			double totalCoveredBp = 0;
-			for(size_t chr = 0; chr < chrList.size(); chr++)
+			std::sort(blockLength.begin(), blockLength.end(), std::greater<std::pair<size_t, size_t> >());
+			std::vector<BlockInstance> selected;
+			for(size_t i = 0; i < blockLength.size(); i++)
 			{
-				totalBp += chrList[chr].GetSequence().size();
-				cover.assign(chrList[chr].GetSequence().size(), 0);
-				for(GroupedBlockList::const_iterator it = start; it != end; ++it)
+				const IndexPair & now = group[blockLength[i].second];
+				if(selected.size() + (now.second - now.first) <= maxInstances)
 				{
-					for(size_t i = 0; i < it->second.size(); i++)
-					{
-						if(it->second[i].GetChrInstance().GetId() == chr)
-						{
-							std::fill(cover.begin() + it->second[i].GetStart(), cover.begin() + it->second[i].GetEnd(), COVERED);
-						}
-					}
+					selected.insert(selected.end(), blockList.begin() + now.first, blockList.begin() + now.second);
 				}
+			}
 
-				double nowCoveredBp = static_cast<double>(std::count(cover.begin(), cover.end(), COVERED));
-				ret.push_back(nowCoveredBp / cover.size() * 100);
-				totalCoveredBp += nowCoveredBp;
+			blockList.swap(selected);
+		}
+
+		void CollectChr(const std::vector<BlockInstance> & blockList, std::set<size_t> & chrToShow)
+		{
+			for(std::vector<BlockInstance>::const_iterator it = blockList.begin(); it != blockList.end(); ++it)
+			{
+				chrToShow.insert(it->GetChrId());
 			}
+		}
 
-			ret.insert(ret.begin(), totalCoveredBp / totalBp * 100);
-			return ret;
+		void OutputLink(std::vector<BlockInstance>::const_iterator block, int color, int fillLength,
+						int linkId, std::ostream& stream)
+		{
+			size_t start = block->GetConventionalStart();
+			size_t end = block->GetConventionalEnd();
+			if (start > end) std::swap(start, end);
+
+			stream << "block_" << std::setw(fillLength) << std::setfill('0') << linkId << " ";
+			stream << "seq" << block->GetChrId() + 1 << " ";
+			stream << start << " " << end;
+			stream << " color=chr" << color << "_a2" << '\n';
 		}
 	}
 
+	GroupedBlockList::GroupedBlockList(const std::vector<BlockInstance> & blockList): block_(blockList)
+	{
+		GroupBy(block_, compareById, std::back_inserter(group_));
+	}
+
+	const std::vector<BlockInstance> & GroupedBlockList::GetBlocks() const
+	{
+		return block_;
+	}
+
+	const std::vector<IndexPair> & GroupedBlockList::GetGroups() const
+	{
+		return group_;
+	}
+
 	const int OutputGenerator::CIRCOS_MAX_COLOR = 25;
 	const int OutputGenerator::CIRCOS_DEFAULT_RADIUS = 1500;
 	const int OutputGenerator::CIRCOS_RESERVED_FOR_LABEL = 500;
@@ -163,15 +204,7 @@ namespace SyntenyFinder
 	{
 		std::ofstream out;
 		TryOpenFile(fileName, out);
-		GroupedBlockList sepBlock;
-		std::vector<IndexPair> group;
-		BlockList blockList = block;
-		GroupBy(blockList, compareById, std::back_inserter(group));
-		for(std::vector<IndexPair>::iterator it = group.begin(); it != group.end(); ++it)
-		{
-			sepBlock.push_back(std::make_pair(it->second - it->first, std::vector<BlockInstance>(blockList.begin() + it->first, blockList.begin() + it->second)));
-		}
-
+		BlockCoverage coverage(chrList_, block);
 		ListChrs(out);
 		out << "Degree\tCount\tTotal";
 		for(size_t i = 0; i < chrList_.size(); i++)
@@ -180,30 +213,57 @@ namespace SyntenyFinder
 		}
 
 		out << std::endl;
-		group.clear();
-		GroupBy(sepBlock, ByFirstElement, std::back_inserter(group));
-		group.push_back(IndexPair(0, sepBlock.size()));
-		for(std::vector<IndexPair>::iterator it = group.begin(); it != group.end(); ++it)
+		double totalBp = 0;
+		for(size_t chr = 0; chr < chrList_.size(); chr++)
 		{
-			if(it != group.end() - 1)
+			totalBp += chrList_[chr].GetSequence().size();
+		}
+
+		const std::vector<size_t> & degree = coverage.GetDegrees();
+		for(size_t i = 0; i <= degree.size(); i++)
+		{
+			bool all = i == degree.size();
+			if(!all)
 			{
-				out << sepBlock[it->first].first << '\t' << it->second - it->first << '\t';
+				out << degree[i] << '\t' << coverage.GetBlockCount(degree[i]) << '\t';
 			}
 			else
 			{
-				out << "All\t" << it->second - it->first << "\t";
+				size_t count = 0;
+				for(size_t j = 0; j < degree.size(); j++)
+				{
+					count += coverage.GetBlockCount(degree[j]);
+				}
+
+				out << "All\t" << count << "\t";
 			}
 
 			out.precision(2);
 			out.setf(std::ostream::fixed);
-			std::vector<double> coverage = CalculateCoverage(chrList_, sepBlock.begin() + it->first, sepBlock.begin() + it->second);
-			std::copy(coverage.begin(), coverage.end(), std::ostream_iterator<double>(out, "%\t"));
+			double totalCoveredBp = 0;
+			std::vector<double> percent;
+			for(size_t chr = 0; chr < chrList_.size(); chr++)
+			{
+				double nowCoveredBp = static_cast<double>(all ? coverage.GetCoveredBp(chr) : coverage.GetCoveredBp(chr, degree[i]));
+				percent.push_back(nowCoveredBp / chrList_[chr].GetSequence().size() * 100);
+				totalCoveredBp += nowCoveredBp;
+			}
+
+			percent.insert(percent.begin(), totalCoveredBp / totalBp * 100);
+			std::copy(percent.begin(), percent.end(), std::ostream_iterator<double>(out, "%\t"));
 			out << std::endl;
 		}
 
 		out << DELIMITER << std::endl;
 	}
 
+	void OutputGenerator::GenerateBedGraph(const BlockList & block, const std::string & fileName) const
+	{
+		std::ofstream out;
+		TryOpenFile(fileName, out);
+		BlockCoverage(chrList_, block).WriteBedGraph(out);
+	}
+
 	void OutputGenerator::ListChromosomesAsPermutations(const BlockList & block, const std::string & fileName) const
 	{
 		std::ofstream out;
@@ -233,7 +293,7 @@ namespace SyntenyFinder
 		}
 	}
 
-	void OutputGenerator::ListBlocksIndices(const BlockList & block, const std::string & fileName) const
+	void OutputGenerator::ListBlocksIndices(const GroupedBlockList & block, const std::string & fileName) const
 	{
 		std::ofstream out;
 		TryOpenFile(fileName, out);
@@ -242,36 +302,110 @@ namespace SyntenyFinder
 	}
 
 	
-	void OutputGenerator::OutputTree(const std::vector<BlockList> & history, const std::string & fileName) const
+	void OutputGenerator::OutputTree(const BlockHierarchy & hierarchy, const std::string & fileName) const
 	{
 		std::ofstream out;
 		TryOpenFile(fileName, out);
-		for (size_t i = history.size() - 1; i > 0; --i)
+		for (size_t i = hierarchy.GetStageCount() - 1; i > 0; --i)
 		{
 			out << "\n================== ITERATION " << i + 1 << "===================\nBlk\tChr\tChld\n";
+			const BlockList & stage = hierarchy.GetStage(i);
+			const BlockList & child = hierarchy.GetStage(i - 1);
+			std::vector<std::pair<int, size_t> > order;
+			for (size_t j = 0; j < stage.size(); ++j)
+			{
+				order.push_back(std::make_pair(stage[j].GetBlockId(), j));
+			}
 
-			std::vector<IndexPair> group;
-			std::vector<BlockInstance> blockList = history[i];
-			GroupBy(blockList, compareById, std::back_inserter(group));
-			for(std::vector<IndexPair>::iterator it = group.begin(); it != group.end(); ++it)
+			std::sort(order.begin(), order.end());
+			for (std::vector<std::pair<int, size_t> >::iterator it = order.begin(); it != order.end(); ++it)
 			{
-				std::vector<BlockInstance> childBlocks = history[i - 1];
-				std::sort(childBlocks.begin(), childBlocks.end(), compareByStart);
-				for (size_t blockId = it->first; blockId != it->second; ++blockId)
+				out << it->first << "\t" << stage[it->second].GetChrId() + 1 << "\t(";
+				const std::vector<size_t> & children = hierarchy.GetChildren(i, it->second);
+				for (std::vector<size_t>::const_iterator jt = children.begin(); jt != children.end(); ++jt)
 				{
-					out << blockList[blockId].GetBlockId() << "\t" << blockList[blockId].GetChrId() + 1 << "\t(";
-					for (size_t j = 0; j < childBlocks.size(); ++j)
-					{
-						if (childBlocks[j].GetEnd() < blockList[blockId].GetStart()) continue;
-						if (childBlocks[j].GetStart() > blockList[blockId].GetEnd()) break;
-						out << j << ",";
-					}
-					out << ")\n";
+					out << child[*jt].GetSignedBlockId() << ",";
 				}
+
+				out << ")\n";
 			}
 		}
 	}
 
+	void OutputGenerator::ListBlocksIndicesBinary(const std::vector<BlockList> & history, const std::string & fileName) const
+	{
+		//(chr, start, stage, block id), index of the instance in the stage
+		typedef std::pair<std::pair<std::pair<size_t, size_t>, std::pair<size_t, int> >, size_t> Entry;
+		std::vector<Entry> entry;
+		for(size_t stage = 0; stage < history.size(); stage++)
+		{
+			for(size_t i = 0; i < history[stage].size(); i++)
+			{
+				const BlockInstance & b = history[stage][i];
+				entry.push_back(Entry(std::make_pair(std::make_pair(b.GetChrId(), b.GetStart()), std::make_pair(stage, b.GetBlockId())), i));
+			}
+		}
+
+		std::sort(entry.begin(), entry.end());
+		size_t instances = entry.size();
+		std::vector<boost::uint64_t> length;
+		std::vector<boost::uint64_t> chrIndex(1, 0);
+		std::vector<boost::uint64_t> nameIndex(1, 0);
+		std::string names;
+		for(size_t chr = 0, now = 0; chr < chrList_.size(); chr++)
+		{
+			for(; now < instances && entry[now].first.first.first == chr; now++);
+			length.push_back(chrList_[chr].GetSequence().size());
+			chrIndex.push_back(now);
+			names += chrList_[chr].GetDescription();
+			nameIndex.push_back(names.size());
+		}
+
+		std::vector<boost::uint64_t> start(instances);
+		std::vector<boost::uint64_t> end(instances);
+		std::vector<boost::uint64_t> maxEnd(instances);
+		std::vector<boost::uint32_t> blockId(instances);
+		std::vector<boost::uint32_t> chrId(instances);
+		std::vector<boost::uint32_t> stage(instances);
+		std::vector<boost::int8_t> strand(instances);
+		for(size_t i = 0; i < instances; i++)
+		{
+			const BlockInstance & b = history[entry[i].first.second.first][entry[i].second];
+			start[i] = b.GetStart();
+			end[i] = b.GetEnd();
+			maxEnd[i] = i > 0 && chrId[i - 1] == b.GetChrId() ? std::max(maxEnd[i - 1], end[i]) : end[i];
+			blockId[i] = b.GetBlockId();
+			chrId[i] = static_cast<boost::uint32_t>(b.GetChrId());
+			stage[i] = static_cast<boost::uint32_t>(entry[i].first.second.first);
+			strand[i] = b.GetDirection() == DNASequence::positive ? 1 : -1;
+		}
+
+		std::ofstream out(fileName.c_str(), std::ios::binary);
+		if(!out)
+		{
+			throw std::runtime_error(("Cannot open file " + fileName).c_str());
+		}
+
+		boost::uint64_t header[BlockCoords::HEADER_FIELDS] = {BlockCoords::VERSION, instances, chrList_.size(), history.size(), names.size()};
+		out.write(BlockCoords::MAGIC, sizeof(BlockCoords::MAGIC));
+		out.write(reinterpret_cast<const char*>(header), sizeof(header));
+		WriteColumn(out, length);
+		WriteColumn(out, chrIndex);
+		WriteColumn(out, nameIndex);
+		WriteColumn(out, start);
+		WriteColumn(out, end);
+		WriteColumn(out, maxEnd);
+		WriteColumn(out, blockId);
+		WriteColumn(out, chrId);
+		WriteColumn(out, stage);
+		WriteColumn(out, strand);
+		out.write(names.data(), names.size());
+		if(!out)
+		{
+			throw std::runtime_error(("Cannot write file " + fileName).c_str());
+		}
+	}
+
 	void OutputGenerator::ListBlocksIndicesHeirarchy(const std::vector<BlockList> & history, const std::string & fileName) const
 	{
 		std::ofstream out;
@@ -280,39 +414,121 @@ namespace SyntenyFinder
 		for (size_t i = 0; i < history.size(); ++i)
 		{
 			out << "\n================== ITERATION " << i + 1 << "===================\nBlk\tChr\tChld\n";
-			OutputBlocks(history[i], out);
+			OutputBlocks(GroupedBlockList(history[i]), out);
 		}
 	}
 
-	void OutputGenerator::ListBlocksSequences(const BlockList & block, const std::string & fileName) const
+	void OutputGenerator::ListBlocksSequences(const GroupedBlockList & block, const std::string & fileName, bool bgzf) const
 	{
-		std::ofstream out;
-		TryOpenFile(fileName, out);
-		std::vector<IndexPair> group;
-		BlockList blockList = block;
-		GroupBy(blockList, compareById, std::back_inserter(group));
-		for(std::vector<IndexPair>::iterator it = group.begin(); it != group.end(); ++it)
+		//Records are handed to the writer in batches, so only a part of the output is kept in memory
+		const size_t BATCH_SIZE = 1 << 24;
+		SequenceWriter writer(fileName, bgzf);
+		const BlockList & blockList = block.GetBlocks();
+		std::vector<SequenceWriter::Record> batch;
+		size_t batchSize = 0;
+		for(size_t i = 0; i < blockList.size(); i++)
 		{
-			for(size_t block = it->first; block < it->second; block++)
+			std::stringstream header;
+			char strand = blockList[i].GetSignedBlockId() > 0 ? '+' : '-';
+			const FASTARecord & chr = blockList[i].GetChrInstance();
+			header << "Seq=\"" << chr.GetDescription() << "\",Strand='" << strand << "',";
+			header << "Block_id=" << blockList[i].GetBlockId() << ",Start=" ;
+			header << blockList[i].GetConventionalStart() << ",End=" << blockList[i].GetConventionalEnd();
+			batch.push_back(SequenceWriter::Record(header.str(), chr.GetSequence().data() + blockList[i].GetStart(), blockList[i].GetLength(), strand == '-'));
+			batchSize += blockList[i].GetLength();
+			if(batchSize >= BATCH_SIZE || i + 1 == blockList.size())
 			{
-				size_t length = blockList[block].GetLength();
-				char strand = blockList[block].GetSignedBlockId() > 0 ? '+' : '-';
-				const FASTARecord & chr = blockList[block].GetChrInstance();
-				out << ">Seq=\"" << chr.GetDescription() << "\",Strand='" << strand << "',";
-				out << "Block_id=" << blockList[block].GetBlockId() << ",Start=" ;
-				out << blockList[block].GetConventionalStart() << ",End=" << blockList[block].GetConventionalEnd() << std::endl;
+				writer.Write(batch);
+				batch.clear();
+				batchSize = 0;
+			}
+		}
 
-				if(blockList[block].GetSignedBlockId() > 0)
-				{
-					OutputLines(chr.GetSequence().begin() + blockList[block].GetStart(), length, out);
-				}
-				else
+		writer.Close();
+	}
+
+	void OutputGenerator::GenerateAlignments(const GroupedBlockList & block, const std::set<size_t> & referenceChrId, size_t minBlockSize, const std::string & mafFileName,
+		VariantCaller * variantCaller, const AlignmentCache * cache) const
+	{
+		//Instances go in the order of the coordinates file. Like in C-Sibelia, a block
+		//made of a long enough reference instance and an assembly one is aligned pairwise
+		const std::vector<IndexPair> & group = block.GetGroups();
+		std::vector<BlockInstance> blockList = block.GetBlocks();
+		std::vector<BlockAligner::Block> job(group.size());
+		for(size_t i = 0; i < group.size(); i++)
+		{
+			std::sort(blockList.begin() + group[i].first, blockList.begin() + group[i].second, compareByChrId);
+			std::vector<BlockInstance> & instance = job[i].instance;
+			instance.assign(blockList.begin() + group[i].first, blockList.begin() + group[i].second);
+			if(instance.size() == 2 && referenceChrId.count(instance[0].GetChrId()) != referenceChrId.count(instance[1].GetChrId()) &&
+				instance[0].GetLength() >= minBlockSize && instance[1].GetLength() >= minBlockSize)
+			{
+				job[i].pairwise = true;
+				if(referenceChrId.count(instance[1].GetChrId()) > 0)
 				{
-					std::string::const_reverse_iterator it(chr.GetSequence().begin() + blockList[block].GetEnd());
-					OutputLines(CFancyIterator(it, DNASequence::Translate, ' '), length, out);
+					std::swap(instance[0], instance[1]);
 				}
+			}
+		}
+
+		std::ofstream out;
+		if(!mafFileName.empty())
+		{
+			TryOpenFile(mafFileName, out);
+			out << "##maf version=1\n\n";
+		}
+
+		BlockAligner::AlignBlocks(job, boost::bind(PassAlignment, mafFileName.empty() ? 0 : &out, variantCaller, _1, _2), cache);
+	}
+
+	void OutputGenerator::ListVariantsVCF(const VariantCaller & variantCaller, const std::string & fileName, bool unmappedInsertions) const
+	{
+		//Unmapped insertions can't be placed on the reference, they are given as imprecise
+		//breakends that may be anywhere in the first reference sequence
+		std::ofstream out;
+		TryOpenFile(fileName, out);
+		const FASTARecord & reference = chrList_.front();
+		std::string referenceChr = VariantCaller::StripChrId(reference.GetDescription());
+		out << "##fileformat=VCFv4.1\n##source=Sibelia " << VERSION << "\n##reference=" << referenceChr << '\n';
+		out << "##INFO=<ID=SVTYPE,Number=1,Type=String,Description=\"Type of structural variant\">\n";
+		out << "##INFO=<ID=IMPRECISE,Number=0,Type=Flag,Description=\"Imprecise structural variation\">\n";
+		out << "##INFO=<ID=CIPOS,Number=2,Type=Integer,Description=\"Confidence interval around POS for imprecise variants\">\n";
+		out << "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\n";
+		const std::vector<VariantCaller::Variant> & insertion = variantCaller.GetUnmappedInsertions();
+		for(size_t i = 0; i < insertion.size() && unmappedInsertions; i++)
+		{
+			char base = reference.GetSequence()[0];
+			const std::string & contig = chrList_[insertion[i].contig].GetDescription();
+			size_t start = insertion[i].contigPos + 1;
+			size_t end = start + insertion[i].assemblyAllele.size();
+			out << referenceChr << "\t1\tbnd_" << i * 2 << '\t' << base << '\t' << base << '[' << contig << ':' << start << '[';
+			out << "\t.\t.\tIMPRECISE;SVTYPE=BND;CIPOS=0," << reference.GetSequence().size() << '\n';
+			out << referenceChr << "\t1\tbnd_" << i * 2 + 1 << '\t' << base << "\t]" << contig << ':' << end << ']' << base;
+			out << "\t.\t.\tIMPRECISE;SVTYPE=BND;CIPOS=0," << reference.GetSequence().size() << '\n';
+		}
 
-				out << std::endl;
+		const std::vector<VariantCaller::Variant> & variant = variantCaller.GetVariants();
+		for(size_t i = 0; i < variant.size(); i++)
+		{
+			out << VariantCaller::StripChrId(chrList_[variant[i].chr].GetDescription()) << '\t' << variant[i].pos << "\t.\t";
+			out << variant[i].referenceAllele << '\t' << variant[i].assemblyAllele << "\t.\t.\t.\n";
+		}
+	}
+
+	void OutputGenerator::ListUnmappedInsertions(const VariantCaller & variantCaller, const std::string & fileName) const
+	{
+		const size_t LINE_LENGTH = 60;
+		std::ofstream out;
+		TryOpenFile(fileName, out);
+		const std::vector<VariantCaller::Variant> & insertion = variantCaller.GetUnmappedInsertions();
+		for(size_t i = 0; i < insertion.size(); i++)
+		{
+			const std::string & allele = insertion[i].assemblyAllele;
+			out << ">Seq=\"" << chrList_[insertion[i].contig].GetDescription() << "\",Start=" << insertion[i].contigPos + 1;
+			out << "\",End=" << insertion[i].contigPos + allele.size() << '\n';
+			for(size_t pos = 0; pos < allele.size(); pos += LINE_LENGTH)
+			{
+				out << allele.substr(pos, LINE_LENGTH) << '\n';
 			}
 		}
 	}
@@ -325,22 +541,62 @@ namespace SyntenyFinder
 		imageConfig << "radius = " << r << "p" << std::endl;
 	}
 
-	void OutputGenerator::GenerateHierarchyCircosOutput(const std::vector<BlockList> & history, const std::string & outFile, const std::string & outDir) const
+	void OutputGenerator::GenerateHierarchyCircosOutput(const BlockHierarchy & hierarchy, const std::string & outFile, const std::string & outDir) const
 	{
 		int r = 100;
 		std::ofstream config;
 		CreateOutDirectory(outDir);
 		TryOpenFile(outFile, config);
-		config << circosTemplate;		
-		WriteCircosLinks(outDir, "circos.segdup.txt", history.back());
-		WriteCircosKaryoType(outDir, "circos.sequences.txt", history);
+		config << circosTemplate;
+		size_t top = hierarchy.GetStageCount() - 1;
+		GroupedBlockList last(hierarchy.GetStage(top));
+		std::set<size_t> chrToShow;
+		for(size_t i = 0; i <= top; i++)
+		{
+			CollectChr(hierarchy.GetStage(i), chrToShow);
+		}
+
+		WriteCircosLinks(outDir, "circos.segdup.txt", last);
+		WriteCircosKaryoType(outDir, "circos.sequences.txt", chrToShow);
 		config << "<highlights>\n\tfill_color = green" << std::endl;		
-		WriteCircosHighlight(outDir, "circos.highlight.txt", history.back(), 0, 0, true, config);		
-		for(std::vector<BlockList>::const_reverse_iterator it = ++history.rbegin(); it != history.rend(); ++it)
-		{			
+		WriteCircosHighlight(outDir, "circos.highlight.txt", last, 0, 0, true, config);
+
+		//Blocks of the last stage are colored as on the links, an instance of an earlier
+		//stage takes the color of its parent, instances without a parent keep the color of the ring
+		std::vector<int> blockId;
+		const BlockList & topStage = hierarchy.GetStage(top);
+		for(BlockList::const_iterator it = topStage.begin(); it != topStage.end(); ++it)
+		{
+			blockId.push_back(it->GetBlockId());
+		}
+
+		std::sort(blockId.begin(), blockId.end());
+		blockId.erase(std::unique(blockId.begin(), blockId.end()), blockId.end());
+		std::vector<int> color(topStage.size());
+		for(size_t i = 0; i < topStage.size(); i++)
+		{
+			color[i] = static_cast<int>(std::lower_bound(blockId.begin(), blockId.end(), topStage[i].GetBlockId()) - blockId.begin()) % CIRCOS_MAX_COLOR;
+		}
+
+		for(size_t stage = top; stage > 0; --stage)
+		{
+			std::vector<int> childColor(hierarchy.GetStage(stage - 1).size(), -1);
+			for(size_t i = 0; i < color.size(); i++)
+			{
+				const std::vector<size_t> & children = hierarchy.GetChildren(stage, i);
+				for(std::vector<size_t>::const_iterator it = children.begin(); it != children.end(); ++it)
+				{
+					if(childColor[*it] == -1)
+					{
+						childColor[*it] = color[i];
+					}
+				}
+			}
+
+			color.swap(childColor);
 			std::stringstream ss;
-			ss << "circos.highlight" << it - history.rbegin() << ".txt";
-			WriteCircosHighlight(outDir, ss.str(), *it, r, r + CIRCOS_HIGHLIGHT_THICKNESS, false, config);			
+			ss << "circos.highlight" << top - stage + 1 << ".txt";
+			WriteCircosStageHighlight(outDir, ss.str(), hierarchy.GetStage(stage - 1), color, r, r + CIRCOS_HIGHLIGHT_THICKNESS, config);
 			r += static_cast<int>(CIRCOS_HIGHLIGHT_THICKNESS * 1.5);
 		}
 
@@ -351,14 +607,16 @@ namespace SyntenyFinder
 		WriteCircosImageConfig(outDir, "circos.image.conf", CIRCOS_DEFAULT_RADIUS + CIRCOS_RESERVED_FOR_LABEL + r);
 	}
 
-	void OutputGenerator::GenerateCircosOutput(const BlockList & blockList, const std::string & outFile, const std::string & outDir) const
+	void OutputGenerator::GenerateCircosOutput(const GroupedBlockList & blockList, const std::string & outFile, const std::string & outDir) const
 	{		
 		std::ofstream config;
 		CreateOutDirectory(outDir);
 		TryOpenFile(outFile, config);
 		config << circosTemplate;		
+		std::set<size_t> chrToShow;
+		CollectChr(blockList.GetBlocks(), chrToShow);
 		WriteCircosLinks(outDir, "circos.segdup.txt", blockList);		
-		WriteCircosKaryoType(outDir, "circos.sequences.txt", std::vector<BlockList>(1, blockList));
+		WriteCircosKaryoType(outDir, "circos.sequences.txt", chrToShow);
 		config << "<highlights>\n\tfill_color = green" << std::endl;		
 		WriteCircosHighlight(outDir, "circos.highlight.txt", blockList, 0, 0, true, config);
 		config << "</highlights>" << std::endl;
@@ -366,22 +624,20 @@ namespace SyntenyFinder
 		WriteCircosImageConfig(outDir, "circos.image.conf", CIRCOS_DEFAULT_RADIUS);
 	}
 
-	void OutputGenerator::WriteCircosLinks(const std::string & outDir, const std::string & fileName, const BlockList & block) const
+	void OutputGenerator::WriteCircosLinks(const std::string & outDir, const std::string & fileName, const GroupedBlockList & block) const
 	{
-		//blocks must be sorted by id
-		BlockList sortedBlocks = block;
-		std::sort(sortedBlocks.begin(), sortedBlocks.end(), compareById);
+		const BlockList & sortedBlocks = block.GetBlocks();
 
 		//write link and highlights file
 		int idLength = static_cast<int>(log10(static_cast<double>(sortedBlocks.size()))) + 1;
 		int lastId = 0;
 		int linkCount = 0;
-		BlockList blocksToLink;
+		std::vector<BlockList::const_iterator> blocksToLink;
 		std::ofstream linksFile;
 		TryOpenFile(outDir + "/" + fileName, linksFile);
 
 		int color = 0;
-		for(BlockList::iterator itBlock = sortedBlocks.begin(); itBlock != sortedBlocks.end(); ++itBlock)
+		for(BlockList::const_iterator itBlock = sortedBlocks.begin(); itBlock != sortedBlocks.end(); ++itBlock)
 		{
 			if (itBlock->GetBlockId() != lastId)
 			{
@@ -389,29 +645,27 @@ namespace SyntenyFinder
 				lastId = itBlock->GetBlockId();
 			}
 
-			for (BlockList::iterator itPair = blocksToLink.begin(); itPair != blocksToLink.end(); ++itPair)
+			for (std::vector<BlockList::const_iterator>::iterator itPair = blocksToLink.begin(); itPair != blocksToLink.end(); ++itPair)
 			{
 				color = (color + 1) % CIRCOS_MAX_COLOR;
 				//link start
 				OutputLink(itBlock, color, idLength, linkCount, linksFile);
 				//link end
-				OutputLink(itPair, color, idLength, linkCount, linksFile);
+				OutputLink(*itPair, color, idLength, linkCount, linksFile);
 				++linkCount;
 			}
 
-			blocksToLink.push_back(*itBlock);
+			blocksToLink.push_back(itBlock);
 		}
 	}
 
-	void OutputGenerator::WriteCircosHighlight(const std::string & outDir, const std::string & fileName, const BlockList & block, int r0, int r1, bool ideogram, std::ofstream & config) const
+	void OutputGenerator::WriteCircosHighlight(const std::string & outDir, const std::string & fileName, const GroupedBlockList & block, int r0, int r1, bool ideogram, std::ofstream & config) const
 	{
 		int color = 0;
-		BlockList sortedBlocks = block;
-		std::sort(sortedBlocks.begin(), sortedBlocks.end(), compareById);
-		BlockList blocksToLink;		
+		const BlockList & sortedBlocks = block.GetBlocks();
 		std::ofstream highlightFile;		
 		TryOpenFile(outDir + "/" + fileName, highlightFile);
-		for(BlockList::iterator itBlock = sortedBlocks.begin(); itBlock != sortedBlocks.end(); ++itBlock)
+		for(BlockList::const_iterator itBlock = sortedBlocks.begin(); itBlock != sortedBlocks.end(); ++itBlock)
 		{
 			highlightFile << "seq" << itBlock->GetChrInstance().GetConventionalId() << " ";
 			size_t blockStart = itBlock->GetConventionalStart();
@@ -436,9 +690,39 @@ namespace SyntenyFinder
 				highlightFile << " fill_color=" << (itBlock->GetDirection() == DNASequence::positive ? "green" : "red")  << "_a0";
 			}
 
-			highlightFile << std::endl;
+			highlightFile << '\n';
 		}
 
+		WriteCircosHighlightConfig(fileName, r0, r1, ideogram, config);
+	}
+
+	void OutputGenerator::WriteCircosStageHighlight(const std::string & outDir, const std::string & fileName, const BlockList & stage, const std::vector<int> & color, int r0, int r1, std::ofstream & config) const
+	{
+		std::ofstream highlightFile;
+		TryOpenFile(outDir + "/" + fileName, highlightFile);
+		for(size_t i = 0; i < stage.size(); i++)
+		{
+			size_t blockStart = stage[i].GetConventionalStart();
+			size_t blockEnd = stage[i].GetConventionalEnd();
+			if (blockStart > blockEnd)
+			{
+				std::swap(blockStart, blockEnd);
+			}
+
+			highlightFile << "seq" << stage[i].GetChrInstance().GetConventionalId() << " " << blockStart << " " << blockEnd;
+			if(color[i] != -1)
+			{
+				highlightFile << " fill_color=chr" << color[i] << "_a0";
+			}
+
+			highlightFile << '\n';
+		}
+
+		WriteCircosHighlightConfig(fileName, r0, r1, false, config);
+	}
+
+	void OutputGenerator::WriteCircosHighlightConfig(const std::string & fileName, int r0, int r1, bool ideogram, std::ofstream & config) const
+	{
 		std::string prefix = "\t\t";
 		config << "\t<highlight>" << std::endl;
 		config << prefix << "file = " << fileName << std::endl;
@@ -455,19 +739,10 @@ namespace SyntenyFinder
 		config << "\t</highlight>" << std::endl;
 	}
 
-	void OutputGenerator::WriteCircosKaryoType(const std::string & outDir, const std::string & fileName, const std::vector<BlockList> & history) const
+	void OutputGenerator::WriteCircosKaryoType(const std::string & outDir, const std::string & fileName, const std::set<size_t> & chrToShow) const
 	{
 		std::ofstream karFile;		
 		TryOpenFile(outDir + "/" + fileName, karFile);
-		std::set<size_t> chrToShow;
-		for(std::vector<BlockList>::const_iterator jt = history.begin(); jt != history.end(); ++jt)
-		{
-			for(BlockList::const_iterator it = jt->begin(); it != jt->end(); ++it)
-			{
-				chrToShow.insert(it->GetChrId());
-			}
-		}
-
 		for (size_t i = 0; i < chrList_.size(); ++i)
 		{
 			if(chrToShow.count(chrList_[i].GetId()))
@@ -480,7 +755,7 @@ namespace SyntenyFinder
 		}
 	}
 
-	void OutputGenerator::GenerateD3Output(const BlockList & blockList, const std::string & outFile) const
+	void OutputGenerator::GenerateD3Output(const BlockList & blockList, const std::string & outFile, size_t maxInstances) const
 	{
 		std::istringstream htmlTemplate(d3Template);
 
@@ -506,41 +781,56 @@ namespace SyntenyFinder
 
 		//blocks must be sorted by start
 		BlockList sortedBlocks = blockList;
+		if(maxInstances > 0 && sortedBlocks.size() > maxInstances)
+		{
+			SelectLargestBlocks(sortedBlocks, maxInstances);
+		}
+
 		std::sort(sortedBlocks.begin(), sortedBlocks.end(), compareByStart);
+		int maxId = 0;
+		std::vector<std::string> name(sortedBlocks.size());
+		for(size_t i = 0; i < sortedBlocks.size(); i++)
+		{
+			name[i] = OutputD3BlockID(sortedBlocks[i]);
+			maxId = std::max(maxId, sortedBlocks[i].GetBlockId());
+		}
+
+		std::vector<std::vector<size_t> > instance(maxId + 1);
+		for(size_t i = 0; i < sortedBlocks.size(); i++)
+		{
+			instance[sortedBlocks[i].GetBlockId()].push_back(i);
+		}
 
 		// write to output file
-		int lastId = 0;
-		bool first_line = true;
-		for(BlockList::iterator itBlock = sortedBlocks.begin(); itBlock != sortedBlocks.end(); ++itBlock) // O(N^2) by number of blocks, can be optimized
+		for(size_t i = 0; i < sortedBlocks.size(); i++)
 		{
-			if (!first_line)
+			if (i > 0)
 				out << ",";
-			else
-				first_line = false;
 			out << "    {";
-			out << "\"name\":\"" << OutputD3BlockID(*itBlock) << "\",";
-			out << "\"size\":" << itBlock->GetLength() << ",";
+			out << "\"name\":\"" << name[i] << "\",";
+			out << "\"size\":" << sortedBlocks[i].GetLength() << ",";
 			out << "\"imports\":[";
 			bool first = true;
-			for (BlockList::iterator itPair = sortedBlocks.begin(); itPair != sortedBlocks.end(); ++itPair)
+			const std::vector<size_t> & pair = instance[sortedBlocks[i].GetBlockId()];
+			for (std::vector<size_t>::const_iterator it = pair.begin(); it != pair.end(); ++it)
 			{
-				if (itPair->GetBlockId() == itBlock->GetBlockId() && itPair != itBlock)
+				if (*it != i)
 				{
 					if (!first)
 						out << ",";
 					else
 						first = false;
-					out << "\"" << OutputD3BlockID(*itPair) << "\"";
+					out << "\"" << name[*it] << "\"";
 				}
 			}
 			out << "]";
-			out << "}" << std::endl;
+			out << "}" << '\n';
 		}
 		out << "];" << std::endl;
 
 		// making data for chart legend
 		out << "chart_legend = [" << std::endl;
-		first_line = true;
+		bool first_line = true;
 		for(size_t i = 0; i < chrList_.size(); i++)
 		{
 			if (!first_line)
@@ -595,12 +885,11 @@ namespace SyntenyFinder
 		std::copy(block, block + blockSize, std::ostream_iterator<std::string>(ss, "\n"));
 	}
 
-	void OutputGenerator::ListBlocksIndicesGFF(const BlockList & blockList, const std::string & fileName) const
+	void OutputGenerator::ListBlocksIndicesGFF(const GroupedBlockList & blockList, const std::string & fileName) const
 	{
 		std::ofstream out;
 		TryOpenFile(fileName, out);
-		BlockList block(blockList);
-		std::sort(block.begin(), block.end(), compareById);
+		const BlockList & block = blockList.GetBlocks();
 		const std::string header[] =
 		{
 			"##gff-version 2",
@@ -626,7 +915,7 @@ namespace SyntenyFinder
 				IntToStr(static_cast<size_t>(it->GetBlockId()))
 			};
 
-			out << Join(record, record + sizeof(record) / sizeof(record[0]), "\t") << std::endl;
+			out << Join(record, record + sizeof(record) / sizeof(record[0]), "\t") << '\n';
 		}
 	}
 
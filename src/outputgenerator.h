@@ -9,24 +9,50 @@
 
 #include "util.h"
 #include "resource.h"
+#include "coverage.h"
 #include "blockfinder.h"
+#include "hierarchy.h"
+#include "variantcaller.h"
+#include "alignmentcache.h"
 
 namespace SyntenyFinder
 {	
+	//Instances sorted by block id and split into blocks, built once and shared
+	//by the writers that list the instances block by block
+	class GroupedBlockList
+	{
+	public:
+		explicit GroupedBlockList(const std::vector<BlockInstance> & blockList);
+		const std::vector<BlockInstance> & GetBlocks() const;
+		const std::vector<IndexPair> & GetGroups() const;
+	private:
+		std::vector<BlockInstance> block_;
+		std::vector<IndexPair> group_;
+	};
+
 	class OutputGenerator
 	{
 	public:
 		typedef std::vector<BlockInstance> BlockList;
 		OutputGenerator(const ChrList & chrList): chrList_(chrList) {}
 		void GenerateReport(const BlockList & blockList, const std::string & fileName) const;		
-		void GenerateCircosOutput(const BlockList & blockList, const std::string & outFile, const std::string & outDir) const;
-		void GenerateHierarchyCircosOutput(const std::vector<BlockList> & history, const std::string & outFile, const std::string & outDir) const;
-		void GenerateD3Output(const BlockList & blockList, const std::string & outFile) const;		
-		void ListBlocksIndices(const BlockList & blockList, const std::string & fileName) const;
-		void ListBlocksIndicesGFF(const BlockList & blockList, const std::string & fileName) const;
+		void GenerateBedGraph(const BlockList & blockList, const std::string & fileName) const;
+		void GenerateCircosOutput(const GroupedBlockList & blockList, const std::string & outFile, const std::string & outDir) const;
+		//Rings of the stages, an instance has the color of the last stage block it lies in
+		void GenerateHierarchyCircosOutput(const BlockHierarchy & hierarchy, const std::string & outFile, const std::string & outDir) const;
+		void GenerateD3Output(const BlockList & blockList, const std::string & outFile, size_t maxInstances = 0) const;		
+		void ListBlocksIndices(const GroupedBlockList & blockList, const std::string & fileName) const;
+		void ListBlocksIndicesGFF(const GroupedBlockList & blockList, const std::string & fileName) const;
+		void ListBlocksIndicesBinary(const std::vector<BlockList> & history, const std::string & fileName) const;
 		void ListBlocksIndicesHeirarchy(const std::vector<BlockList> & history, const std::string & fileName) const;
-		void OutputTree(const std::vector<BlockList> & history, const std::string & fileName) const;
-		void ListBlocksSequences(const BlockList & blockList, const std::string & fileName) const;		
+		void OutputTree(const BlockHierarchy & hierarchy, const std::string & fileName) const;
+		void ListBlocksSequences(const GroupedBlockList & blockList, const std::string & fileName, bool bgzf = false) const;		
+		//Aligns the blocks, the alignments are written in MAF unless the file name is empty
+		//and passed to the variant caller if it is given. Alignments found in the cache are reused
+		void GenerateAlignments(const GroupedBlockList & blockList, const std::set<size_t> & referenceChrId, size_t minBlockSize, const std::string & mafFileName,
+			VariantCaller * variantCaller = 0, const AlignmentCache * cache = 0) const;
+		void ListVariantsVCF(const VariantCaller & variantCaller, const std::string & fileName, bool unmappedInsertions = true) const;
+		void ListUnmappedInsertions(const VariantCaller & variantCaller, const std::string & fileName) const;
 		void ListChromosomesAsPermutations(const BlockList & blockList, const std::string & fileName) const;
 		void RearrangementScenario(const std::vector<std::string> & steps, const std::string & fileName) const;
 		void OutputBuffer(const std::string & fileName, const std::string & buffer) const;	
@@ -42,9 +68,11 @@ namespace SyntenyFinder
 		void TryOpenFile(const std::string & fileName, std::ofstream & stream) const;
 		void TryOpenResourceFile(const std::string & fileName, std::ifstream & stream) const;				
 		void WriteCircosImageConfig(const std::string & outDir, const std::string & fileName, int r) const;
-		void WriteCircosLinks(const std::string & outDir, const std::string & fileName, const BlockList & block) const;
-		void WriteCircosKaryoType(const std::string & outDir, const std::string & fileName, const std::vector<BlockList> & blockList) const;
-		void WriteCircosHighlight(const std::string & outDir, const std::string & fileName, const BlockList & block, int r0, int r1, bool ideogram, std::ofstream & config) const;		
+		void WriteCircosLinks(const std::string & outDir, const std::string & fileName, const GroupedBlockList & block) const;
+		void WriteCircosKaryoType(const std::string & outDir, const std::string & fileName, const std::set<size_t> & chrToShow) const;
+		void WriteCircosHighlight(const std::string & outDir, const std::string & fileName, const GroupedBlockList & block, int r0, int r1, bool ideogram, std::ofstream & config) const;		
+		void WriteCircosStageHighlight(const std::string & outDir, const std::string & fileName, const BlockList & stage, const std::vector<int> & color, int r0, int r1, std::ofstream & config) const;
+		void WriteCircosHighlightConfig(const std::string & fileName, int r0, int r1, bool ideogram, std::ofstream & config) const;
 	};
 }
 
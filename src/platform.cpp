@@ -6,6 +6,22 @@
 
 #include "platform.h"
 
+#ifdef _WIN32
+	#define NOMINMAX
+	#include <io.h>
+	#include <process.h>
+	#include <sys/utime.h>
+	#include <windows.h>
+	#include <psapi.h>
+	#pragma comment(lib, "psapi.lib")
+#else
+	#include <dirent.h>
+	#include <utime.h>
+	#include <sys/time.h>
+	#include <sys/resource.h>
+	#include <unistd.h>
+#endif
+
 namespace SyntenyFinder
 {
 	std::vector<std::string> GetResourceDirs()
@@ -41,6 +57,148 @@ namespace SyntenyFinder
 		}
 	}
 
+	void ListFiles(const std::string & directory, const std::string & suffix, std::vector<FileStatus> & file)
+	{
+		std::vector<std::string> name;
+	#ifdef _WIN32
+		struct _finddata_t entry;
+		intptr_t handle = _findfirst((directory + "/*" + suffix).c_str(), &entry);
+		for(int found = static_cast<int>(handle); found != -1; found = _findnext(handle, &entry))
+		{
+			name.push_back(entry.name);
+		}
+
+		if(handle != -1)
+		{
+			_findclose(handle);
+		}
+	#else
+		DIR * dir = opendir(directory.c_str());
+		if(dir == 0)
+		{
+			throw std::runtime_error(("Cannot read dir " + directory).c_str());
+		}
+
+		for(struct dirent * entry = readdir(dir); entry != 0; entry = readdir(dir))
+		{
+			std::string now = entry->d_name;
+			if(now.size() >= suffix.size() && now.compare(now.size() - suffix.size(), suffix.size(), suffix) == 0)
+			{
+				name.push_back(now);
+			}
+		}
+
+		closedir(dir);
+	#endif
+		file.clear();
+		for(size_t i = 0; i < name.size(); i++)
+		{
+			FileStatus now;
+			now.path = directory + "/" + name[i];
+		#ifdef _WIN32
+			struct __stat64 buf;
+			int res = _stat64(now.path.c_str(), &buf);
+			bool regular = res == 0 && (buf.st_mode & _S_IFREG) != 0;
+		#else
+			struct stat buf;
+			int res = stat(now.path.c_str(), &buf);
+			bool regular = res == 0 && S_ISREG(buf.st_mode);
+		#endif
+			if(regular)
+			{
+				now.size = buf.st_size;
+				now.modified = buf.st_mtime;
+				file.push_back(now);
+			}
+		}
+	}
+
+	void TouchFile(const std::string & path)
+	{
+	#ifdef _WIN32
+		_utime(path.c_str(), 0);
+	#else
+		utime(path.c_str(), 0);
+	#endif
+	}
+
+	double GetWallClock()
+	{
+	#ifdef _WIN32
+		LARGE_INTEGER count;
+		LARGE_INTEGER frequency;
+		QueryPerformanceCounter(&count);
+		QueryPerformanceFrequency(&frequency);
+		return double(count.QuadPart) / frequency.QuadPart;
+	#else
+		struct timeval now;
+		gettimeofday(&now, 0);
+		return now.tv_sec + now.tv_usec * 1e-6;
+	#endif
+	}
+
+	double GetThreadCpuTime()
+	{
+	#ifdef _WIN32
+		FILETIME creation;
+		FILETIME exit;
+		FILETIME kernel;
+		FILETIME user;
+		if(!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+		{
+			return 0;
+		}
+		//Both are in 100 ns units
+		ULARGE_INTEGER kernelTime;
+		ULARGE_INTEGER userTime;
+		kernelTime.LowPart = kernel.dwLowDateTime;
+		kernelTime.HighPart = kernel.dwHighDateTime;
+		userTime.LowPart = user.dwLowDateTime;
+		userTime.HighPart = user.dwHighDateTime;
+		return double(kernelTime.QuadPart + userTime.QuadPart) * 1e-7;
+	#elif defined(CLOCK_THREAD_CPUTIME_ID)
+		struct timespec now;
+		if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0)
+		{
+			return 0;
+		}
+
+		return now.tv_sec + now.tv_nsec * 1e-9;
+	#else
+		//No clock of the thread, the process is measured instead
+		return double(clock()) / CLOCKS_PER_SEC;
+	#endif
+	}
+
+	uint64_t GetPeakMemoryUsage()
+	{
+	#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters;
+		return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? counters.PeakWorkingSetSize : 0;
+	#else
+		struct rusage usage;
+		if(getrusage(RUSAGE_SELF, &usage) != 0)
+		{
+			return 0;
+		}
+		//Linux reports kilobytes, Mac OS X bytes
+	#ifdef __APPLE__
+		return usage.ru_maxrss;
+	#else
+		return static_cast<uint64_t>(usage.ru_maxrss) << 10;
+	#endif
+	#endif
+	}
+
+	unsigned long GetPid()
+	{
+	#ifdef _WIN32
+		return static_cast<unsigned long>(_getpid());
+	#else
+		return static_cast<unsigned long>(getpid());
+	#endif
+	}
+
 	std::map<std::string, FILE*> TempFile::register_;
 
 	TempFile::TempFile()
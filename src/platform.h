@@ -14,6 +14,26 @@ namespace SyntenyFinder
 	std::vector<std::string> GetResourceDirs();
 	void CreateOutDirectory(const std::string & path);
 
+	struct FileStatus
+	{
+		std::string path;
+		uint64_t size;
+		time_t modified;
+	};
+
+	//Regular files of the directory whose names end with the suffix
+	void ListFiles(const std::string & directory, const std::string & suffix, std::vector<FileStatus> & file);
+	//Sets the modification time of an existing file to now
+	void TouchFile(const std::string & path);
+	//Seconds since an arbitrary moment, for measuring intervals
+	double GetWallClock();
+	//CPU seconds used by the calling thread alone
+	double GetThreadCpuTime();
+	//The largest resident set size of the process so far, in bytes
+	uint64_t GetPeakMemoryUsage();
+	//Id of the process, distinguishes files written by concurrent runs
+	unsigned long GetPid();
+
 	class TempFile
 	{
 	public:
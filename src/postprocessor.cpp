@@ -13,18 +13,11 @@ namespace SyntenyFinder
 	namespace
 	{
 		const size_t MAX_CORRECTION_RANGE = 1 << 10;
+		const int ALIGNMENT_MATCH = 25;
+		const int ALIGNMENT_MISMATCH = -75;
+		const int ALIGNMENT_GAP = -75;
 
-		struct Stripe
-		{
-			int firstBlock;
-			int secondBlock;
-			Stripe() {}
-			Stripe(int firstBlock, int secondBlock): firstBlock(firstBlock), secondBlock(secondBlock) {}
-			bool operator < (const Stripe & toCompare) const
-			{
-				return firstBlock < toCompare.firstBlock;
-			}
-		};
+		const size_t NO_NEIGHBOUR = -1;
 
 		std::string ReadInReverseDirection(const std::string & str)
 		{
@@ -42,104 +35,92 @@ namespace SyntenyFinder
 			perm[block[i].GetChrId()].push_back(block[i]);
 		}
 
+		int maxId = 0;
+		std::vector<BlockInstance> instance;
+		std::vector<size_t> prev;
+		std::vector<size_t> next;
 		for(size_t i = 0; i < perm.size(); i++)
 		{
 			std::sort(perm[i].begin(), perm[i].end(), compareByStart);
+			for(size_t j = 0; j < perm[i].size(); j++)
+			{
+				prev.push_back(j > 0 ? instance.size() - 1 : NO_NEIGHBOUR);
+				next.push_back(j + 1 < perm[i].size() ? instance.size() + 1 : NO_NEIGHBOUR);
+				instance.push_back(perm[i][j]);
+				maxId = std::max(maxId, perm[i][j].GetBlockId());
+			}
+		}
+
+		std::vector<char> alive(instance.size(), true);
+		std::vector<std::vector<size_t> > occurrence(maxId + 1);
+		for(size_t i = 0; i < instance.size(); i++)
+		{
+			occurrence[instance[i].GetBlockId()].push_back(i);
 		}
 
-		int sentinel = INT_MAX >> 1;
-		bool glue = false;
-		do
+		//Stripes are glued one at a time, always the one with the smallest block id, as
+		//the rescanning algorithm did. A glue changes only the glued block and the blocks
+		//adjacent to the merged instances, so only these are put back to the worklist.
+		std::set<int> candidate;
+		for(int bid = 1; bid <= maxId; bid++)
 		{
-			std::vector<Stripe> stripe;
-			for(size_t chr = 0; chr < perm.size(); chr++)
+			if(!occurrence[bid].empty())
 			{
-				for(size_t i = 0; i < perm[chr].size(); i++)
-				{
-					int bid = perm[chr][i].GetSignedBlockId();
-					if(bid > 0)
-					{
-						int nextBid = i < perm[chr].size() - 1 ? perm[chr][i + 1].GetSignedBlockId() : sentinel;
-						stripe.push_back(Stripe(bid, nextBid));
-					}
-					else
-					{
-						int prevBid = i > 0 ? perm[chr][i - 1].GetSignedBlockId() : -sentinel;
-						stripe.push_back(Stripe(-bid, -prevBid));
-					}
-				}
+				candidate.insert(bid);
 			}
+		}
 
-			size_t now = 0;
-			size_t next = 0;
-			std::sort(stripe.begin(), stripe.end());
-			for(; now < stripe.size(); now = next)
+		while(!candidate.empty())
+		{
+			int glueBid = *candidate.begin();
+			candidate.erase(candidate.begin());
+			int partner = StripePartner(glueBid, instance, prev, next, occurrence);
+			if(partner == 0)
 			{
-				glue = true;
-				for(; next < stripe.size() && stripe[next].firstBlock == stripe[now].firstBlock; next++)
+				continue;
+			}
+
+			for(size_t i = 0; i < occurrence[glueBid].size(); i++)
+			{
+				size_t now = occurrence[glueBid][i];
+				BlockInstance & a = instance[now];
+				bool positive = a.GetSignedBlockId() > 0;
+				size_t glued = positive ? next[now] : prev[now];
+				BlockInstance & b = instance[glued];
+				size_t start = positive ? a.GetStart() : b.GetStart();
+				size_t end = positive ? b.GetEnd() : a.GetEnd();
+				a = BlockInstance(a.GetSignedBlockId(), &a.GetChrInstance(), start, end);
+				alive[glued] = false;
+				if(prev[glued] != NO_NEIGHBOUR)
 				{
-					if(stripe[next].secondBlock != stripe[now].secondBlock || stripe[next].secondBlock == sentinel || Abs(stripe[next].secondBlock) == stripe[next].firstBlock)
-					{
-						glue = false;
-					}
+					next[prev[glued]] = next[glued];
 				}
 
-				if(glue)
+				if(next[glued] != NO_NEIGHBOUR)
 				{
-					typedef std::vector<Stripe>::iterator It;
-					std::pair<It, It> range = std::equal_range(stripe.begin(), stripe.end(), Stripe(Abs(stripe[now].secondBlock), 0));
-					if(range.second - range.first != next - now)
-					{
-						glue = false;
-					}
-					else
-					{
-						break;
-					}
+					prev[next[glued]] = prev[glued];
 				}
-			}
 
-			if(glue)
-			{
-				assert(next - now > 1);
-				int glueBid = stripe[now].firstBlock;
-				for(size_t chr = 0; chr < perm.size(); chr++)
+				size_t affected = positive ? next[now] : prev[now];
+				if(affected != NO_NEIGHBOUR)
 				{
-					for(size_t i = 0; i < perm[chr].size(); i++)
-					{
-						int bid = perm[chr][i].GetBlockId();
-						if(bid == glueBid)
-						{
-							bid = perm[chr][i].GetSignedBlockId();
-							if(bid > 0)
-							{
-								BlockInstance & a = perm[chr][i];
-								BlockInstance & b = perm[chr][i + 1];
-								a = BlockInstance(a.GetSignedBlockId(), &a.GetChrInstance(), a.GetStart(), b.GetEnd());
-								perm[chr].erase(perm[chr].begin() + i + 1);
-							}
-							else
-							{
-								BlockInstance & a = perm[chr][--i];
-								BlockInstance & b = perm[chr][i + 1];
-								a = BlockInstance(b.GetSignedBlockId(), &a.GetChrInstance(), a.GetStart(), b.GetEnd());
-								perm[chr].erase(perm[chr].begin() + i + 1);
-							}
-						}
-					}
+					candidate.insert(instance[affected].GetBlockId());
 				}
 			}
+
+			occurrence[partner].clear();
+			candidate.erase(partner);
+			candidate.insert(glueBid);
 		}
-		while(glue);
 
 		block.clear();
 		std::vector<int> oldId;
-		for(size_t chr = 0; chr < perm.size(); chr++)
+		for(size_t i = 0; i < instance.size(); i++)
 		{
-			for(size_t i = 0; i < perm[chr].size(); i++)
+			if(alive[i])
 			{
-				block.push_back(perm[chr][i]);
-				oldId.push_back(perm[chr][i].GetBlockId());
+				block.push_back(instance[i]);
+				oldId.push_back(instance[i].GetBlockId());
 			}
 		}
 
@@ -153,6 +134,39 @@ namespace SyntenyFinder
 		}
 	}
 
+	int Postprocessor::StripePartner(int bid, const std::vector<BlockInstance> & instance, const std::vector<size_t> & prev, const std::vector<size_t> & next, const std::vector<std::vector<size_t> > & occurrence)
+	{
+		const int sentinel = INT_MAX >> 1;
+		int secondBlock = 0;
+		for(size_t i = 0; i < occurrence[bid].size(); i++)
+		{
+			size_t now = occurrence[bid][i];
+			int nowSecondBlock;
+			if(instance[now].GetSignedBlockId() > 0)
+			{
+				nowSecondBlock = next[now] != NO_NEIGHBOUR ? instance[next[now]].GetSignedBlockId() : sentinel;
+			}
+			else
+			{
+				nowSecondBlock = prev[now] != NO_NEIGHBOUR ? -instance[prev[now]].GetSignedBlockId() : sentinel;
+			}
+
+			if((i > 0 && nowSecondBlock != secondBlock) || nowSecondBlock == sentinel || Abs(nowSecondBlock) == bid)
+			{
+				return 0;
+			}
+
+			secondBlock = nowSecondBlock;
+		}
+
+		if(secondBlock == 0 || occurrence[Abs(secondBlock)].size() != occurrence[bid].size())
+		{
+			return 0;
+		}
+
+		return Abs(secondBlock);
+	}
+
 	typedef std::vector<BlockInstance>::const_iterator BLCIterator;
 
 	Postprocessor::Postprocessor(const std::vector<FASTARecord> & chr, size_t minBlockSize):
@@ -160,40 +174,62 @@ namespace SyntenyFinder
 	{
 	}
 
-	const BlockInstance* Postprocessor::PreviousBlock(const BlockInstance & block, const std::vector<BlockInstance> & blockList)
+	void Postprocessor::BuildBlockIndex(const std::vector<BlockInstance> & blockList)
 	{
-		const BlockInstance* ret = 0;
-		size_t start = block.GetStart();
+		startIndex_.assign(chr_->size(), CoordinateIndex());
+		endIndex_.assign(chr_->size(), CoordinateIndex());
 		for(size_t i = 0; i < blockList.size(); i++)
 		{
-			if(blockList[i] != block && blockList[i].GetChrId() == block.GetChrId() && blockList[i].GetEnd() <= start)
+			InsertIntoIndex(blockList[i], i);
+		}
+	}
+
+	void Postprocessor::InsertIntoIndex(const BlockInstance & block, size_t index)
+	{
+		startIndex_[block.GetChrId()].insert(IndexPair(block.GetStart(), index));
+		endIndex_[block.GetChrId()].insert(IndexPair(block.GetEnd(), index));
+	}
+
+	void Postprocessor::EraseFromIndex(const BlockInstance & block, size_t index)
+	{
+		startIndex_[block.GetChrId()].erase(IndexPair(block.GetStart(), index));
+		endIndex_[block.GetChrId()].erase(IndexPair(block.GetEnd(), index));
+	}
+
+	const BlockInstance* Postprocessor::PreviousBlock(const BlockInstance & block, const std::vector<BlockInstance> & blockList)
+	{
+		//Closest end to the left, ties are resolved in favor of the smallest index in the list
+		const CoordinateIndex & index = endIndex_[block.GetChrId()];
+		CoordinateIndex::const_iterator it = index.upper_bound(IndexPair(block.GetStart(), static_cast<size_t>(-1)));
+		while(it != index.begin())
+		{
+			size_t end = (--it)->first;
+			for(it = index.lower_bound(IndexPair(end, 0)); it != index.end() && it->first == end; ++it)
 			{
-				if(ret == 0 || start - blockList[i].GetEnd() < start - ret->GetEnd())
+				if(blockList[it->second] != block)
 				{
-					ret = &blockList[i];
+					return &blockList[it->second];
 				}
 			}
+
+			it = index.lower_bound(IndexPair(end, 0));
 		}
 
-		return ret;
+		return 0;
 	}
 
 	const BlockInstance* Postprocessor::NextBlock(const BlockInstance & block, const std::vector<BlockInstance> & blockList)
 	{
-		const BlockInstance* ret = 0;
-		size_t end = block.GetEnd();
-		for(size_t i = 0; i < blockList.size(); i++)
+		const CoordinateIndex & index = startIndex_[block.GetChrId()];
+		for(CoordinateIndex::const_iterator it = index.lower_bound(IndexPair(block.GetEnd(), 0)); it != index.end(); ++it)
 		{
-			if(blockList[i] != block && blockList[i].GetChrId() == block.GetChrId() && blockList[i].GetStart() >= end)
+			if(blockList[it->second] != block)
 			{
-				if(ret == 0 || blockList[i].GetStart() - end < ret->GetStart() - end)
-				{
-					ret = &blockList[i];
-				}
+				return &blockList[it->second];
 			}
 		}
 
-		return ret;
+		return 0;
 	}
 	
 	std::pair<size_t, size_t> Postprocessor::DetermineLeftProbableBoundaries(std::vector<BlockInstance> & blockList, size_t blockid)
@@ -256,24 +292,7 @@ namespace SyntenyFinder
 
 	void Postprocessor::LocalAlignment(const std::string & sequence1, const std::string & sequence2, std::pair<size_t, size_t> & coord1, std::pair<size_t, size_t> & coord2)
 	{
-		using namespace seqan;
-		typedef String<char>				TSequence;	// sequence type
-		typedef Align<TSequence, ArrayGaps>	TAlign;		// align type
-		typedef Row<TAlign>::Type			TRow;
-		typedef Iterator<TRow>::Type		TIterator;
-		typedef Position<TAlign>::Type		TPosition;
-		
-		TSequence seq1 = sequence1;
-		TSequence seq2 = sequence2;
-		TAlign align;
-		resize(rows(align), 2); 
-		assignSource(row(align, 0), seq1);
-		assignSource(row(align, 1), seq2);
-		localAlignment(align, Score<int>(25, -75, -75));
-		coord1.first = clippedBeginPosition(row(align, 0));
-		coord1.second = clippedEndPosition(row(align, 0));
-		coord2.first = clippedBeginPosition(row(align, 1));
-		coord2.second = clippedEndPosition(row(align, 1));
+		StripedLocalAlignment(sequence1, sequence2, ALIGNMENT_MATCH, ALIGNMENT_MISMATCH, ALIGNMENT_GAP, coord1, coord2);
 	}
 
 	void Postprocessor::UpdateBlockBoundaries(BlockInstance & block, std::pair<size_t, size_t> leftBoundaries, std::pair<size_t, size_t> rightBoundaries, std::pair<size_t, size_t> startAlignmentCoords, std::pair<size_t, size_t> endAlignmentCoords)
@@ -292,33 +311,52 @@ namespace SyntenyFinder
 		}
 	}
 
-	void Postprocessor::CorrectBlocksBoundaries(std::vector<BlockInstance> & blockList, size_t referenceBlock, size_t assemblyBlock)
-	{		
-		std::pair<size_t, size_t> referenceStartCoord;
-		std::pair<size_t, size_t> referenceEndCoord;
-		std::pair<size_t, size_t> assemblyStartCoord;
-		std::pair<size_t, size_t> assemblyEndCoord;
+	void Postprocessor::DetermineBoundaries(std::vector<BlockInstance> & blockList, size_t referenceBlock, size_t assemblyBlock, BoundaryAlignment & alignment)
+	{
+		alignment.referenceLeftBoundaries = DetermineLeftProbableBoundaries(blockList, referenceBlock);
+		alignment.referenceRightBoundaries = DetermineRightProbableBoundaries(blockList, referenceBlock);
+		alignment.assemblyLeftBoundaries = DetermineLeftProbableBoundaries(blockList, assemblyBlock);
+		alignment.assemblyRightBoundaries = DetermineRightProbableBoundaries(blockList, assemblyBlock);
+	}
+
+	void Postprocessor::AlignBoundaries(std::vector<BlockInstance> & blockList, size_t referenceBlock, size_t assemblyBlock, BoundaryAlignment & alignment)
+	{
 		std::string referenceStart;
 		std::string referenceEnd;
 		std::string assemblyStart;
 		std::string assemblyEnd;
-		std::pair<size_t, size_t> referenceLeftBoundaries = DetermineLeftProbableBoundaries(blockList, referenceBlock);
-		std::pair<size_t, size_t> referenceRightBoundaries = DetermineRightProbableBoundaries(blockList, referenceBlock);
-		std::pair<size_t, size_t> assemblyLeftBoundaries = DetermineLeftProbableBoundaries(blockList, assemblyBlock);
-		std::pair<size_t, size_t> assemblyRightBoundaries = DetermineRightProbableBoundaries(blockList, assemblyBlock);
-		GetBoundariesSequence(blockList[referenceBlock], referenceLeftBoundaries, referenceRightBoundaries, referenceStart, referenceEnd);
-		GetBoundariesSequence(blockList[assemblyBlock], assemblyLeftBoundaries, assemblyRightBoundaries, assemblyStart, assemblyEnd);		
-		LocalAlignment(referenceStart, assemblyStart, referenceStartCoord, assemblyStartCoord);
-		LocalAlignment(referenceEnd, assemblyEnd, referenceEndCoord, assemblyEndCoord);
-		UpdateBlockBoundaries(blockList[referenceBlock], referenceLeftBoundaries, referenceRightBoundaries, referenceStartCoord, referenceEndCoord);
-		UpdateBlockBoundaries(blockList[assemblyBlock], assemblyLeftBoundaries, assemblyRightBoundaries, assemblyStartCoord, assemblyEndCoord);
+		GetBoundariesSequence(blockList[referenceBlock], alignment.referenceLeftBoundaries, alignment.referenceRightBoundaries, referenceStart, referenceEnd);
+		GetBoundariesSequence(blockList[assemblyBlock], alignment.assemblyLeftBoundaries, alignment.assemblyRightBoundaries, assemblyStart, assemblyEnd);
+		LocalAlignment(referenceStart, assemblyStart, alignment.referenceStartCoord, alignment.assemblyStartCoord);
+		LocalAlignment(referenceEnd, assemblyEnd, alignment.referenceEndCoord, alignment.assemblyEndCoord);
+	}
+
+	void Postprocessor::CorrectBlocksBoundaries(std::vector<BlockInstance> & blockList, size_t referenceBlock, size_t assemblyBlock, const BoundaryAlignment & precomputed)
+	{
+		//The precomputed alignment is valid unless a previous correction moved the neighbours
+		BoundaryAlignment alignment = precomputed;
+		DetermineBoundaries(blockList, referenceBlock, assemblyBlock, alignment);
+		if(alignment.referenceLeftBoundaries != precomputed.referenceLeftBoundaries || alignment.referenceRightBoundaries != precomputed.referenceRightBoundaries ||
+			alignment.assemblyLeftBoundaries != precomputed.assemblyLeftBoundaries || alignment.assemblyRightBoundaries != precomputed.assemblyRightBoundaries)
+		{
+			AlignBoundaries(blockList, referenceBlock, assemblyBlock, alignment);
+		}
+
+		EraseFromIndex(blockList[referenceBlock], referenceBlock);
+		EraseFromIndex(blockList[assemblyBlock], assemblyBlock);
+		UpdateBlockBoundaries(blockList[referenceBlock], alignment.referenceLeftBoundaries, alignment.referenceRightBoundaries, alignment.referenceStartCoord, alignment.referenceEndCoord);
+		UpdateBlockBoundaries(blockList[assemblyBlock], alignment.assemblyLeftBoundaries, alignment.assemblyRightBoundaries, alignment.assemblyStartCoord, alignment.assemblyEndCoord);
+		InsertIntoIndex(blockList[referenceBlock], referenceBlock);
+		InsertIntoIndex(blockList[assemblyBlock], assemblyBlock);
 	}
 
 	void Postprocessor::ImproveBlockBoundaries(std::vector<BlockInstance> & blockList, const std::set<size_t> & referenceSequenceId)
 	{
 		referenceSequenceId_ = referenceSequenceId;
 		std::vector<IndexPair> group;
+		std::vector<size_t> pairStart;
 		GroupBy(blockList, compareById, std::back_inserter(group));
+		BuildBlockIndex(blockList);
 		for(std::vector<IndexPair>::iterator it = group.begin(); it != group.end(); ++it)
 		{
 			size_t inReference = 0;
@@ -333,7 +371,11 @@ namespace SyntenyFinder
 			{
 				if(referenceSequenceId_.count(blockList[it->first].GetChrId()) == 0)
 				{
+					EraseFromIndex(blockList[it->first], it->first);
+					EraseFromIndex(blockList[it->first + 1], it->first + 1);
 					std::swap(blockList[it->first], blockList[it->first + 1]);
+					InsertIntoIndex(blockList[it->first], it->first);
+					InsertIntoIndex(blockList[it->first + 1], it->first + 1);
 				}
 
 				if(blockList[it->first].GetDirection() != DNASequence::positive)
@@ -341,10 +383,25 @@ namespace SyntenyFinder
 					blockList[it->first].Reverse();
 					blockList[it->first + 1].Reverse();
 				}
-								
-				CorrectBlocksBoundaries(blockList, it->first, it->first + 1);				
+
+				pairStart.push_back(it->first);
 			}
 		}
+
+		//Alignments are computed concurrently against the initial boundaries and
+		//then applied one by one in the same order as before
+		std::vector<BoundaryAlignment> alignment(pairStart.size());
+		#pragma omp parallel for schedule(dynamic)
+		for(int i = 0; i < static_cast<int>(pairStart.size()); i++)
+		{
+			DetermineBoundaries(blockList, pairStart[i], pairStart[i] + 1, alignment[i]);
+			AlignBoundaries(blockList, pairStart[i], pairStart[i] + 1, alignment[i]);
+		}
+
+		for(size_t i = 0; i < pairStart.size(); i++)
+		{
+			CorrectBlocksBoundaries(blockList, pairStart[i], pairStart[i] + 1, alignment[i]);
+		}
 	}
 
 	void Postprocessor::MatchRepeats(std::vector<BlockInstance> & blockList, const std::set<size_t> & referenceSequenceId)
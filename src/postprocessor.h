@@ -7,11 +7,9 @@
 #ifndef _POSTPROCESSOR_H_
 #define _POSTPROCESSOR_H_
 
-#include <seqan/align.h>
-#undef min
-#undef max
 #include "fasta.h"
 #include "blockinstance.h"
+#include "localalignment.h"
 
 namespace SyntenyFinder
 {
@@ -29,11 +27,32 @@ namespace SyntenyFinder
 		std::vector<std::vector<BlockInstance> > history_;
 		size_t minBlockSize_;
 		size_t correctionRange_;
+		static int StripePartner(int bid, const std::vector<BlockInstance> & instance, const std::vector<size_t> & prev, const std::vector<size_t> & next, const std::vector<std::vector<size_t> > & occurrence);
+		typedef std::set<IndexPair> CoordinateIndex;
+		std::vector<CoordinateIndex> startIndex_;
+		std::vector<CoordinateIndex> endIndex_;
+		void BuildBlockIndex(const std::vector<BlockInstance> & blockList);
+		void InsertIntoIndex(const BlockInstance & block, size_t index);
+		void EraseFromIndex(const BlockInstance & block, size_t index);
 		const BlockInstance* PreviousBlock(const BlockInstance & block, const std::vector<BlockInstance> & blockList);
 		const BlockInstance* NextBlock(const BlockInstance & block, const std::vector<BlockInstance> & blockList);
 		std::pair<size_t, size_t> DetermineLeftProbableBoundaries(std::vector<BlockInstance> & blockList, size_t block);
 		std::pair<size_t, size_t> DetermineRightProbableBoundaries(std::vector<BlockInstance> & blockList, size_t block);
-		void CorrectBlocksBoundaries(std::vector<BlockInstance> & blockList, size_t referenceBlock, size_t assemblyBlock);
+		struct BoundaryAlignment
+		{
+			std::pair<size_t, size_t> referenceLeftBoundaries;
+			std::pair<size_t, size_t> referenceRightBoundaries;
+			std::pair<size_t, size_t> assemblyLeftBoundaries;
+			std::pair<size_t, size_t> assemblyRightBoundaries;
+			std::pair<size_t, size_t> referenceStartCoord;
+			std::pair<size_t, size_t> referenceEndCoord;
+			std::pair<size_t, size_t> assemblyStartCoord;
+			std::pair<size_t, size_t> assemblyEndCoord;
+		};
+
+		void DetermineBoundaries(std::vector<BlockInstance> & blockList, size_t referenceBlock, size_t assemblyBlock, BoundaryAlignment & alignment);
+		void AlignBoundaries(std::vector<BlockInstance> & blockList, size_t referenceBlock, size_t assemblyBlock, BoundaryAlignment & alignment);
+		void CorrectBlocksBoundaries(std::vector<BlockInstance> & blockList, size_t referenceBlock, size_t assemblyBlock, const BoundaryAlignment & precomputed);
 		void UpdateBlockBoundaries(BlockInstance & block, std::pair<size_t, size_t> leftBoundaries, std::pair<size_t, size_t> rightBoundaries, std::pair<size_t, size_t> startAlignmentCoords, std::pair<size_t, size_t> endAlignmentCoords);
 		void LocalAlignment(const std::string & sequence1, const std::string & sequence2, std::pair<size_t, size_t> & coord1, std::pair<size_t, size_t> & coord2);
 		void GetBoundariesSequence(const BlockInstance & block, std::pair<size_t, size_t> leftBoundaries, std::pair<size_t, size_t> rightBoundaries, std::string & start, std::string & end);
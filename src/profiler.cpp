@@ -0,0 +1,362 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#include <new>
+#include "profiler.h"
+
+#ifdef _OPENMP
+	#include <omp.h>
+#endif
+
+#if __cplusplus < 201103L
+	#define THROWS_BAD_ALLOC throw(std::bad_alloc)
+	#define THROWS_NOTHING throw()
+#else
+	#define THROWS_BAD_ALLOC
+	#define THROWS_NOTHING noexcept
+#endif
+
+#ifdef _MSC_VER
+	#define THREAD_LOCAL __declspec(thread)
+	#define NO_INLINE __declspec(noinline)
+#else
+	#define THREAD_LOCAL __thread
+	#define NO_INLINE __attribute__((noinline))
+#endif
+
+namespace
+{
+	//Kept out of line: once operator delete is inlined where operator new was, gcc
+	//sees free take memory of operator new and warns about a mismatched pair
+	NO_INLINE void Release(void * ptr)
+	{
+		free(ptr);
+	}
+}
+
+//The allocations of the C++ code are counted here, LAGAN's mallocs are not
+void * operator new(std::size_t size) THROWS_BAD_ALLOC
+{
+	SyntenyFinder::Profiler::CountAllocation(size);
+	void * ret;
+	while((ret = malloc(size == 0 ? 1 : size)) == 0)
+	{
+		std::new_handler handler = std::set_new_handler(0);
+		std::set_new_handler(handler);
+		if(handler == 0)
+		{
+			throw std::bad_alloc();
+		}
+
+		handler();
+	}
+
+	return ret;
+}
+
+void operator delete(void * ptr) THROWS_NOTHING
+{
+	Release(ptr);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void * ptr, std::size_t) THROWS_NOTHING
+{
+	Release(ptr);
+}
+#endif
+
+namespace SyntenyFinder
+{
+	namespace
+	{
+		//Allocations of the calling thread, for the scopes opened by worker threads
+		THREAD_LOCAL uint64_t threadAllocations = 0;
+		THREAD_LOCAL uint64_t threadAllocatedBytes = 0;
+
+		bool InParallel()
+		{
+		#ifdef _OPENMP
+			return omp_in_parallel() != 0;
+		#else
+			return false;
+		#endif
+		}
+
+		int MaxThreads()
+		{
+		#ifdef _OPENMP
+			return omp_get_max_threads();
+		#else
+			return 1;
+		#endif
+		}
+
+		double CpuSeconds(clock_t cpu)
+		{
+			return double(cpu) / CLOCKS_PER_SEC;
+		}
+
+		double CpuClock(bool thread)
+		{
+			return thread ? GetThreadCpuTime() : CpuSeconds(clock());
+		}
+
+		std::string JsonString(const std::string & str)
+		{
+			std::stringstream ss;
+			ss << '"';
+			for(size_t i = 0; i < str.size(); i++)
+			{
+				unsigned char ch = static_cast<unsigned char>(str[i]);
+				if(ch == '"' || ch == '\\')
+				{
+					ss << '\\' << str[i];
+				}
+				else if(ch < 0x20)
+				{
+					ss << "\\u" << std::hex << std::setfill('0') << std::setw(4) << static_cast<int>(ch) << std::dec;
+				}
+				else
+				{
+					ss << str[i];
+				}
+			}
+
+			ss << '"';
+			return ss.str();
+		}
+	}
+
+	const size_t Profiler::NO_PHASE = -1;
+	bool Profiler::enabled_ = false;
+	double Profiler::startWall_ = 0;
+	clock_t Profiler::startCpu_ = 0;
+	uint64_t Profiler::allocations_ = 0;
+	uint64_t Profiler::allocatedBytes_ = 0;
+	std::vector<Profiler::Phase> Profiler::phase_;
+	std::vector<size_t> Profiler::open_;
+
+	Profiler::Phase::Phase(const std::string & name, size_t parent): name(name), parent(parent), calls(0), wall(0), cpu(0),
+		peakMemory(0), allocations(0), allocatedBytes(0)
+	{
+	}
+
+	Profiler::Scope::Scope(const char * name): phase_(NO_PHASE)
+	{
+		if(enabled_)
+		{
+			Start(name);
+		}
+	}
+
+	Profiler::Scope::Scope(const std::string & name): phase_(NO_PHASE)
+	{
+		if(enabled_)
+		{
+			Start(name);
+		}
+	}
+
+	Profiler::Scope::Scope(const char * name, size_t number): phase_(NO_PHASE)
+	{
+		if(enabled_)
+		{
+			std::stringstream ss;
+			ss << name << ' ' << number;
+			Start(ss.str());
+		}
+	}
+
+	Profiler::Scope::~Scope()
+	{
+		Stop();
+	}
+
+	void Profiler::Scope::Start(const std::string & name)
+	{
+		phase_ = Open(name);
+		parallel_ = InParallel();
+		allocations_ = parallel_ ? threadAllocations : Profiler::allocations_;
+		allocatedBytes_ = parallel_ ? threadAllocatedBytes : Profiler::allocatedBytes_;
+		cpu_ = CpuClock(parallel_);
+		wall_ = GetWallClock();
+	}
+
+	void Profiler::Scope::Stop()
+	{
+		if(phase_ != NO_PHASE)
+		{
+			uint64_t allocations = (parallel_ ? threadAllocations : Profiler::allocations_) - allocations_;
+			uint64_t allocatedBytes = (parallel_ ? threadAllocatedBytes : Profiler::allocatedBytes_) - allocatedBytes_;
+			Close(phase_, GetWallClock() - wall_, CpuClock(parallel_) - cpu_, allocations, allocatedBytes);
+			phase_ = NO_PHASE;
+		}
+	}
+
+	void Profiler::Enable()
+	{
+		phase_.assign(1, Phase("run", NO_PHASE));
+		open_.assign(1, 0);
+		startCpu_ = clock();
+		startWall_ = GetWallClock();
+		enabled_ = true;
+	}
+
+	void Profiler::CountAllocation(size_t size)
+	{
+		if(enabled_)
+		{
+			uint64_t bytes = size;
+			threadAllocations++;
+			threadAllocatedBytes += bytes;
+			#pragma omp atomic
+			allocations_++;
+			#pragma omp atomic
+			allocatedBytes_ += bytes;
+		}
+	}
+
+	size_t Profiler::Open(const std::string & name)
+	{
+		size_t ret = NO_PHASE;
+		#pragma omp critical(Profiler)
+		{
+			size_t parent = open_.back();
+			for(size_t i = 0; i < phase_[parent].child.size() && ret == NO_PHASE; i++)
+			{
+				if(phase_[phase_[parent].child[i]].name == name)
+				{
+					ret = phase_[parent].child[i];
+				}
+			}
+
+			if(ret == NO_PHASE)
+			{
+				ret = phase_.size();
+				phase_.push_back(Phase(name, parent));
+				phase_[parent].child.push_back(ret);
+			}
+
+			if(!InParallel())
+			{
+				open_.push_back(ret);
+			}
+		}
+
+		return ret;
+	}
+
+	void Profiler::Close(size_t phase, double wall, double cpu, uint64_t allocations, uint64_t allocatedBytes)
+	{
+		uint64_t peakMemory = GetPeakMemoryUsage();
+		#pragma omp critical(Profiler)
+		{
+			Phase & now = phase_[phase];
+			now.calls++;
+			now.wall += wall;
+			now.cpu += cpu;
+			now.allocations += allocations;
+			now.allocatedBytes += allocatedBytes;
+			now.peakMemory = std::max(now.peakMemory, peakMemory);
+			if(!InParallel() && open_.size() > 1 && open_.back() == phase)
+			{
+				open_.pop_back();
+			}
+		}
+	}
+
+	void Profiler::AddCount(const char * counter, uint64_t value)
+	{
+		#pragma omp critical(Profiler)
+		{
+			std::vector<std::pair<std::string, uint64_t> > & now = phase_[open_.back()].counter;
+			size_t i = 0;
+			for(; i < now.size() && now[i].first != counter; i++);
+			if(i == now.size())
+			{
+				now.push_back(std::make_pair(std::string(counter), uint64_t(0)));
+			}
+
+			now[i].second += value;
+		}
+	}
+
+	void Profiler::RunTask(const std::string & name, const boost::function<void()> & task)
+	{
+		Scope scope(name);
+		task();
+	}
+
+	boost::function<void()> Profiler::Wrap(const std::string & name, const boost::function<void()> & task)
+	{
+		return boost::bind(&Profiler::RunTask, name, task);
+	}
+
+	void Profiler::WritePhase(std::ostream & out, size_t phase, const std::string & indent)
+	{
+		const Phase & now = phase_[phase];
+		out << indent << "{" << std::endl;
+		out << indent << "\t\"name\": " << JsonString(now.name) << "," << std::endl;
+		out << indent << "\t\"calls\": " << now.calls << "," << std::endl;
+		out << indent << "\t\"wallSeconds\": " << now.wall << "," << std::endl;
+		out << indent << "\t\"cpuSeconds\": " << now.cpu << "," << std::endl;
+		out << indent << "\t\"peakMemoryBytes\": " << now.peakMemory << "," << std::endl;
+		out << indent << "\t\"allocations\": " << now.allocations << "," << std::endl;
+		out << indent << "\t\"allocatedBytes\": " << now.allocatedBytes << "," << std::endl;
+		out << indent << "\t\"counters\": {";
+		for(size_t i = 0; i < now.counter.size(); i++)
+		{
+			out << (i > 0 ? ", " : "") << JsonString(now.counter[i].first) << ": " << now.counter[i].second;
+		}
+
+		out << "}," << std::endl;
+		out << indent << "\t\"phases\": [";
+		for(size_t i = 0; i < now.child.size(); i++)
+		{
+			out << (i > 0 ? "," : "") << std::endl;
+			WritePhase(out, now.child[i], indent + "\t\t");
+		}
+
+		out << (now.child.empty() ? "" : "\n" + indent + "\t") << "]" << std::endl;
+		out << indent << "}";
+	}
+
+	void Profiler::WriteReport(const std::string & fileName, const std::string & command)
+	{
+		if(!enabled_)
+		{
+			return;
+		}
+
+		Phase & root = phase_[0];
+		root.calls = 1;
+		root.wall = GetWallClock() - startWall_;
+		root.cpu = CpuSeconds(clock() - startCpu_);
+		root.peakMemory = GetPeakMemoryUsage();
+		root.allocations = allocations_;
+		root.allocatedBytes = allocatedBytes_;
+		std::ofstream out(fileName.c_str());
+		if(!out)
+		{
+			throw std::runtime_error(("Cannot open file " + fileName).c_str());
+		}
+
+		out.setf(std::ios::fixed);
+		out.precision(6);
+		out << "{" << std::endl;
+		out << "\t\"version\": " << JsonString(VERSION) << "," << std::endl;
+		out << "\t\"command\": " << JsonString(command) << "," << std::endl;
+		out << "\t\"threads\": " << MaxThreads() << "," << std::endl;
+		out << "\t\"run\":" << std::endl;
+		WritePhase(out, 0, "\t");
+		out << std::endl << "}" << std::endl;
+		if(!out)
+		{
+			throw std::runtime_error(("Error while writing to " + fileName).c_str());
+		}
+	}
+}
@@ -0,0 +1,94 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include "platform.h"
+
+namespace SyntenyFinder
+{
+	//Wall and CPU time, peak memory, allocations and counters of the phases of a run.
+	//Phases nest as their scopes do and scopes of the same name under the same parent
+	//add up. Scopes opened by worker threads go under the phase open in the serial
+	//code and count the CPU time and the allocations of their own thread, scopes of
+	//the serial code count those of the whole process. Until Enable is called a scope
+	//or a counter costs a test of a flag
+	class Profiler
+	{
+	public:
+		class Scope
+		{
+		public:
+			explicit Scope(const char * name);
+			explicit Scope(const std::string & name);
+			//Names the phase "name number", e.g. an iteration of a loop
+			Scope(const char * name, size_t number);
+			~Scope();
+			void Stop();
+		private:
+			DISALLOW_COPY_AND_ASSIGN(Scope);
+			void Start(const std::string & name);
+			size_t phase_;
+			bool parallel_;
+			double wall_;
+			double cpu_;
+			uint64_t allocations_;
+			uint64_t allocatedBytes_;
+		};
+
+		static void Enable();
+		static bool Enabled()
+		{
+			return enabled_;
+		}
+
+		//Adds the value to a counter of the innermost open phase
+		static void Count(const char * counter, uint64_t value)
+		{
+			if(enabled_)
+			{
+				AddCount(counter, value);
+			}
+		}
+
+		static void CountAllocation(size_t size);
+		//Runs the task inside a phase, for tasks run concurrently
+		static void RunTask(const std::string & name, const boost::function<void()> & task);
+		static boost::function<void()> Wrap(const std::string & name, const boost::function<void()> & task);
+		static void WriteReport(const std::string & fileName, const std::string & command);
+	private:
+		struct Phase
+		{
+			Phase(const std::string & name, size_t parent);
+			std::string name;
+			size_t parent;
+			size_t calls;
+			double wall;
+			double cpu;
+			uint64_t peakMemory;
+			uint64_t allocations;
+			uint64_t allocatedBytes;
+			std::vector<size_t> child;
+			std::vector<std::pair<std::string, uint64_t> > counter;
+		};
+
+		static const size_t NO_PHASE;
+		static bool enabled_;
+		static double startWall_;
+		static clock_t startCpu_;
+		static uint64_t allocations_;
+		static uint64_t allocatedBytes_;
+		static std::vector<Phase> phase_;
+		static std::vector<size_t> open_;
+		static size_t Open(const std::string & name);
+		static void Close(size_t phase, double wall, double cpu, uint64_t allocations, uint64_t allocatedBytes);
+		static void AddCount(const char * counter, uint64_t value);
+		static void WritePhase(std::ostream & out, size_t phase, const std::string & indent);
+	};
+}
+
+#endif
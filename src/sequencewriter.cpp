@@ -0,0 +1,277 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#include "sequencewriter.h"
+#include "dnasequence.h"
+#ifdef SIBELIA_USE_ZLIB
+	#include <zlib.h>
+#endif
+#ifdef __SSE2__
+	#include <emmintrin.h>
+#endif
+
+namespace SyntenyFinder
+{
+	namespace
+	{
+		//Uncompressed size of a BGZF block, the same as the one bgzip uses
+		const size_t BGZF_BLOCK_SIZE = 0xff00;
+		const size_t BGZF_MAX_BLOCK_SIZE = 0x10000;
+		const size_t BGZF_HEADER_SIZE = 18;
+		const size_t BGZF_FOOTER_SIZE = 8;
+		const unsigned char BGZF_EOF[] = {0x1f, 0x8b, 0x08, 0x04, 0, 0, 0, 0, 0, 0xff, 0x06, 0, 0x42, 0x43, 0x02, 0, 0x1b, 0, 0x03, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+		void PutLittleEndian(char * out, boost::uint64_t value, size_t bytes)
+		{
+			for(size_t i = 0; i < bytes; i++, value >>= 8)
+			{
+				out[i] = static_cast<char>(value & 0xff);
+			}
+		}
+
+		size_t FormattedSize(const SequenceWriter::Record & record)
+		{
+			size_t lines = (record.length + SequenceWriter::LINE_LENGTH - 1) / SequenceWriter::LINE_LENGTH;
+			return record.header.size() + record.length + std::max(lines, static_cast<size_t>(1)) + 2;
+		}
+
+		void Format(const SequenceWriter::Record & record, char * out)
+		{
+			*out++ = '>';
+			out = std::copy(record.header.begin(), record.header.end(), out);
+			*out++ = '\n';
+			for(size_t pos = 0; pos < record.length; pos += SequenceWriter::LINE_LENGTH)
+			{
+				size_t line = std::min(SequenceWriter::LINE_LENGTH, record.length - pos);
+				if(record.reverse)
+				{
+					const char * end = record.sequence + record.length - pos;
+					ReverseComplement(end - line, end, out);
+				}
+				else
+				{
+					std::copy(record.sequence + pos, record.sequence + pos + line, out);
+				}
+
+				out += line;
+				if(pos + line < record.length)
+				{
+					*out++ = '\n';
+				}
+			}
+
+			*out++ = '\n';
+		}
+
+	#ifdef SIBELIA_USE_ZLIB
+		bool CompressBlock(const char * data, size_t size, std::string & block)
+		{
+			block.assign(BGZF_MAX_BLOCK_SIZE, 0);
+			for(int level = Z_DEFAULT_COMPRESSION; ; level = Z_NO_COMPRESSION)
+			{
+				z_stream stream;
+				memset(&stream, 0, sizeof(stream));
+				if(deflateInit2(&stream, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+				{
+					return false;
+				}
+
+				stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+				stream.avail_in = static_cast<uInt>(size);
+				stream.next_out = reinterpret_cast<Bytef*>(&block[BGZF_HEADER_SIZE]);
+				stream.avail_out = static_cast<uInt>(BGZF_MAX_BLOCK_SIZE - BGZF_HEADER_SIZE - BGZF_FOOTER_SIZE);
+				int ret = deflate(&stream, Z_FINISH);
+				size_t compressed = stream.total_out;
+				deflateEnd(&stream);
+				if(ret == Z_STREAM_END)
+				{
+					size_t total = BGZF_HEADER_SIZE + compressed + BGZF_FOOTER_SIZE;
+					std::copy(BGZF_EOF, BGZF_EOF + BGZF_HEADER_SIZE - 2, block.begin());
+					PutLittleEndian(&block[BGZF_HEADER_SIZE - 2], total - 1, 2);
+					uLong crc = crc32(crc32(0, 0, 0), reinterpret_cast<const Bytef*>(data), static_cast<uInt>(size));
+					PutLittleEndian(&block[BGZF_HEADER_SIZE + compressed], crc, 4);
+					PutLittleEndian(&block[BGZF_HEADER_SIZE + compressed + 4], size, 4);
+					block.resize(total);
+					return true;
+				}
+
+				//Incompressible data is stored, it always fits
+				if(level == Z_NO_COMPRESSION)
+				{
+					return false;
+				}
+			}
+		}
+	#endif
+	}
+
+	const size_t SequenceWriter::LINE_LENGTH = 80;
+
+	void ReverseComplement(const char * begin, const char * end, char * out)
+	{
+	#ifdef __SSE2__
+		//Complementary bases differ by a constant mask in both cases: A ^ T and C ^ G
+		const __m128i caseBit = _mm_set1_epi8(0x20);
+		const __m128i a = _mm_set1_epi8('a');
+		const __m128i c = _mm_set1_epi8('c');
+		const __m128i g = _mm_set1_epi8('g');
+		const __m128i t = _mm_set1_epi8('t');
+		const __m128i atMask = _mm_set1_epi8('A' ^ 'T');
+		const __m128i cgMask = _mm_set1_epi8('C' ^ 'G');
+		for(; end - begin >= 16; end -= 16, out += 16)
+		{
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(end - 16));
+			v = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+			v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+			v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+			v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+			__m128i lower = _mm_or_si128(v, caseBit);
+			__m128i at = _mm_and_si128(_mm_or_si128(_mm_cmpeq_epi8(lower, a), _mm_cmpeq_epi8(lower, t)), atMask);
+			__m128i cg = _mm_and_si128(_mm_or_si128(_mm_cmpeq_epi8(lower, c), _mm_cmpeq_epi8(lower, g)), cgMask);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_xor_si128(v, _mm_or_si128(at, cg)));
+		}
+	#endif
+		while(end != begin)
+		{
+			*out++ = DNASequence::Translate(*--end);
+		}
+	}
+
+	SequenceWriter::SequenceWriter(const std::string & fileName, bool bgzf): fileName_(fileName), bgzf_(bgzf), closed_(false), written_(0), compressed_(0)
+	{
+	#ifndef SIBELIA_USE_ZLIB
+		if(bgzf)
+		{
+			throw std::runtime_error(("Cannot write " + fileName + ": Sibelia is built without gzip support").c_str());
+		}
+	#endif
+		out_.open(fileName.c_str(), bgzf ? std::ios::binary : std::ios::out);
+		if(bgzf)
+		{
+			fai_.open((fileName + ".fai").c_str());
+		}
+
+		if(!out_ || (bgzf && !fai_))
+		{
+			throw std::runtime_error(("Cannot open file " + fileName).c_str());
+		}
+	}
+
+	SequenceWriter::~SequenceWriter()
+	{
+		try
+		{
+			Close();
+		}
+		catch(std::runtime_error &)
+		{
+		}
+	}
+
+	void SequenceWriter::Write(const std::vector<Record> & record)
+	{
+		std::vector<size_t> offset(1, 0);
+		for(size_t i = 0; i < record.size(); i++)
+		{
+			offset.push_back(offset.back() + FormattedSize(record[i]));
+			if(bgzf_)
+			{
+				fai_ << record[i].header << '\t' << record[i].length << '\t' << written_ + offset[i] + record[i].header.size() + 2 << '\t';
+				fai_ << LINE_LENGTH << '\t' << LINE_LENGTH + 1 << '\n';
+			}
+		}
+
+		std::string buffer(offset.back(), 0);
+		#pragma omp parallel for schedule(dynamic)
+		for(int i = 0; i < static_cast<int>(record.size()); i++)
+		{
+			Format(record[i], &buffer[0] + offset[i]);
+		}
+
+		Output(buffer);
+	}
+
+	void SequenceWriter::Output(const std::string & buffer)
+	{
+		written_ += buffer.size();
+		if(!bgzf_)
+		{
+			out_.write(buffer.data(), buffer.size());
+		}
+		else
+		{
+			pending_ += buffer;
+			Compress(false);
+		}
+	}
+
+	void SequenceWriter::Compress(bool flush)
+	{
+	#ifdef SIBELIA_USE_ZLIB
+		size_t blocks = (pending_.size() + (flush ? BGZF_BLOCK_SIZE - 1 : 0)) / BGZF_BLOCK_SIZE;
+		std::vector<std::string> block(blocks);
+		std::vector<char> success(blocks);
+		#pragma omp parallel for
+		for(int i = 0; i < static_cast<int>(blocks); i++)
+		{
+			size_t start = i * BGZF_BLOCK_SIZE;
+			success[i] = CompressBlock(pending_.data() + start, std::min(BGZF_BLOCK_SIZE, pending_.size() - start), block[i]);
+		}
+
+		boost::uint64_t uncompressed = written_ - pending_.size();
+		for(size_t i = 0; i < blocks; i++)
+		{
+			if(!success[i])
+			{
+				throw std::runtime_error(("Cannot compress " + fileName_).c_str());
+			}
+
+			out_.write(block[i].data(), block[i].size());
+			compressed_ += block[i].size();
+			uncompressed += std::min(BGZF_BLOCK_SIZE, pending_.size() - i * BGZF_BLOCK_SIZE);
+			gzi_.push_back(std::make_pair(compressed_, uncompressed));
+		}
+
+		pending_.erase(0, std::min(pending_.size(), blocks * BGZF_BLOCK_SIZE));
+	#endif
+	}
+
+	void SequenceWriter::Close()
+	{
+		if(closed_)
+		{
+			return;
+		}
+
+		closed_ = true;
+		if(bgzf_)
+		{
+			Compress(true);
+			out_.write(reinterpret_cast<const char*>(BGZF_EOF), sizeof(BGZF_EOF));
+			std::ofstream gzi((fileName_ + ".gzi").c_str(), std::ios::binary);
+			std::vector<char> entry((gzi_.size() * 2 + 1) * sizeof(boost::uint64_t));
+			PutLittleEndian(&entry[0], gzi_.size(), sizeof(boost::uint64_t));
+			for(size_t i = 0; i < gzi_.size(); i++)
+			{
+				PutLittleEndian(&entry[(i * 2 + 1) * sizeof(boost::uint64_t)], gzi_[i].first, sizeof(boost::uint64_t));
+				PutLittleEndian(&entry[(i * 2 + 2) * sizeof(boost::uint64_t)], gzi_[i].second, sizeof(boost::uint64_t));
+			}
+
+			gzi.write(&entry[0], entry.size());
+			fai_.close();
+			if(!gzi || !fai_)
+			{
+				throw std::runtime_error(("Cannot write the index of " + fileName_).c_str());
+			}
+		}
+
+		out_.close();
+		if(!out_)
+		{
+			throw std::runtime_error(("Cannot write file " + fileName_).c_str());
+		}
+	}
+}
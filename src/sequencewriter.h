@@ -0,0 +1,55 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#ifndef _SEQUENCE_WRITER_H_
+#define _SEQUENCE_WRITER_H_
+
+#include "common.h"
+
+namespace SyntenyFinder
+{
+	//Writes the reverse complement of [begin, end) to out, characters other than ACGTacgt are kept as is
+	void ReverseComplement(const char * begin, const char * end, char * out);
+
+	//Writes FASTA records with lines of LINE_LENGTH bases. The records passed in one call
+	//are formatted concurrently. A BGZF compressed file is accompanied by the .fai and
+	//.gzi indices, so a single record can be extracted without decompressing the file.
+	class SequenceWriter
+	{
+	public:
+		static const size_t LINE_LENGTH;
+		struct Record
+		{
+			std::string header;
+			//Sequence on the positive strand, it is reverse complemented if reverse is set
+			const char * sequence;
+			size_t length;
+			bool reverse;
+			Record(const std::string & header, const char * sequence, size_t length, bool reverse):
+				header(header), sequence(sequence), length(length), reverse(reverse) {}
+		};
+
+		SequenceWriter(const std::string & fileName, bool bgzf);
+		~SequenceWriter();
+		void Write(const std::vector<Record> & record);
+		void Close();
+	private:
+		DISALLOW_COPY_AND_ASSIGN(SequenceWriter);
+		std::string fileName_;
+		bool bgzf_;
+		bool closed_;
+		std::ofstream out_;
+		std::ofstream fai_;
+		boost::uint64_t written_;
+		boost::uint64_t compressed_;
+		std::string pending_;
+		std::vector<std::pair<boost::uint64_t, boost::uint64_t> > gzi_;
+		void Output(const std::string & buffer);
+		void Compress(bool flush);
+	};
+}
+
+#endif
@@ -87,11 +87,9 @@ namespace SyntenyFinder
 
 	void BlockFinder::SerializeCondensedGraph(size_t k, std::ostream & out, ProgressCallBack f)
 	{
-		IndexedSequence iseq(rawSeq_, originalPos_, k, tempDir_);
 		out << "digraph G" << std::endl << "{" << std::endl;
 		out << "rankdir=LR" << std::endl;
-		std::vector<Edge> edge;
-		ListEdges(iseq.Sequence(), iseq.BifStorage(), k, edge);
+		const std::vector<Edge> & edge = GetEdges(k);
 		for(size_t i = 0; i < edge.size(); i++)
 		{
 			char buf[1 << 8];
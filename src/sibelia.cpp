@@ -84,6 +84,66 @@ int main(int argc, char * argv[])
 			cmd,
 			false);
 
+		TCLAP::SwitchArg bedGraphFlag("",
+			"bedgraph",
+			"Output coverage of the sequences by synteny blocks in bedGraph format",
+			cmd,
+			false);
+
+		TCLAP::SwitchArg bgzfFlag("",
+			"bgzf",
+			"Compress the sequences file with BGZF and index it with .fai and .gzi files",
+			cmd,
+			false);
+
+		TCLAP::SwitchArg mafFlag("",
+			"maf",
+			"Align synteny blocks with the built-in LAGAN and output the alignments in MAF format",
+			cmd,
+			false);
+
+		TCLAP::SwitchArg callVariantsFlag("",
+			"callvariants",
+			"Call variants of the assembly (the second file) against the reference (the first file) like C-Sibelia and output them in VCF",
+			cmd,
+			false);
+
+		TCLAP::SwitchArg unmappedFlag("",
+			"unmapped",
+			"With --callvariants, output unmapped insertions to a FASTA file instead of the VCF file",
+			cmd,
+			false);
+
+		TCLAP::ValueArg<std::string> alignCacheDir("",
+			"aligncache",
+			"Directory where alignments of synteny blocks are kept between runs, blocks found there aren't aligned again.",
+			false,
+			"",
+			"dir name",
+			cmd);
+
+		TCLAP::ValueArg<unsigned int> alignCacheSize("",
+			"aligncachesize",
+			"Maximum size of the alignment cache in megabytes, the least recently used alignments are removed. Default = 1024.",
+			false,
+			1024,
+			"integer",
+			cmd);
+
+		TCLAP::SwitchArg binaryCoordsFlag("",
+			"binarycoords",
+			"Also output coordinates of synteny blocks in a compact binary format",
+			cmd,
+			false);
+
+		TCLAP::ValueArg<unsigned int> d3MaxInstances("",
+			"d3maxinstances",
+			"Maximum number of block instances shown on the d3 diagram, the largest blocks are kept. Default = 0 (no limit).",
+			false,
+			0,
+			"integer",
+			cmd);
+
 		TCLAP::SwitchArg allStagesFlag("",
 			"allstages",
 			"Output coordinates of synteny blocks from all stages",
@@ -106,6 +166,38 @@ int main(int argc, char * argv[])
 			"dir name",
 			cmd);
 
+		TCLAP::ValueArg<std::string> checkpointDir("",
+			"checkpoint",
+			"Directory where simplified sequences are saved after each stage.",
+			false,
+			"",
+			"dir name",
+			cmd);
+
+		TCLAP::ValueArg<std::string> resumeDir("",
+			"resume-from",
+			"Directory with checkpoints of a previous run, completed stages are loaded instead of recomputed.",
+			false,
+			"",
+			"dir name",
+			cmd);
+
+		TCLAP::ValueArg<std::string> profileFile("",
+			"profile",
+			"File where time, memory and counters of each phase of the run are written in JSON.",
+			false,
+			"",
+			"file name",
+			cmd);
+
+		TCLAP::ValueArg<std::string> progressTarget("",
+			"progress-fd",
+			"File descriptor or file (e.g. a named pipe) where progress of the run is written as lines of JSON.",
+			false,
+			"",
+			"fd or file name",
+			cmd);
+
 		TCLAP::ValueArg<std::string> stageFile("k",
 			"stagefile",
 			"File that contains manually chosen simplifications parameters. See USAGE file for more information.",
@@ -183,6 +275,18 @@ int main(int argc, char * argv[])
 
 		cmd.xorAdd(parameters, stageFile);
 		cmd.parse(argc, argv);
+		typedef SyntenyFinder::Profiler Profiler;
+		if(profileFile.isSet())
+		{
+			Profiler::Enable();
+		}
+
+		std::auto_ptr<ProgressStream> progress;
+		if(progressTarget.isSet())
+		{
+			progress.reset(new ProgressStream(progressTarget.getValue()));
+		}
+
 		std::vector<std::pair<int, int> > stage;
 		if(parameters.isSet())
 		{
@@ -200,28 +304,25 @@ int main(int argc, char * argv[])
 		bool hierarchy = hierarchyPicture.isSet();
 		bool noPostProcessing = noPostProcessingFlag.isSet();
 		bool correctBoundaries = correctBoundariesFlag.isSet();
+		bool callVariants = callVariantsFlag.isSet();
 		if(correctBoundaries && (fileName.end() - fileName.begin()) != 2)
 		{
 			throw std::runtime_error("In correction mode only two FASTA files are acceptable");
 		}
 
-		std::vector<SyntenyFinder::FASTARecord> chrList;
-		for(std::vector<std::string>::const_iterator it = fileName.begin(); it != fileName.end(); it++)
+		if(callVariants && (fileName.end() - fileName.begin()) != 2)
 		{
-			SyntenyFinder::FASTAReader reader(*it);
-			if(!reader.IsOk())
-			{
-				throw std::runtime_error(("Cannot open file " + *it).c_str());
-			}
+			throw std::runtime_error("Variants are called only between two FASTA files: the reference and the assembly");
+		}
 
-			reader.GetSequences(chrList);
-			if(it == fileName.begin())
-			{
-				for(size_t i = 0; i < chrList.size(); i++)
-				{
-					referenceChrId.insert(chrList[i].GetId());
-				}
-			}
+		std::vector<size_t> recordCount;
+		std::vector<SyntenyFinder::FASTARecord> chrList;
+		Profiler::Scope reading("reading input");
+		SyntenyFinder::FASTAReader::ReadFiles(fileName.getValue(), chrList, recordCount);
+		reading.Stop();
+		for(size_t i = 0; i < recordCount.front(); i++)
+		{
+			referenceChrId.insert(chrList[i].GetId());
 		}
 		
 		for(size_t i = 0; i < chrList.size(); i++)
@@ -237,34 +338,63 @@ int main(int argc, char * argv[])
 		std::vector<std::vector<SyntenyFinder::BlockInstance> > history(stage.size() + 1);
 		std::string tempDir = tempFileDir.isSet() ? tempFileDir.getValue() : outFileDir.getValue();		
 		std::auto_ptr<SyntenyFinder::BlockFinder> finder(inRAM.isSet() ? new SyntenyFinder::BlockFinder(chrList) : new SyntenyFinder::BlockFinder(chrList, tempDir));
+		if(progress.get() != 0)
+		{
+			finder->SetProgressReport(boost::bind(&ProgressStream::Report, progress.get(), _1));
+		}
+
 		SyntenyFinder::Postprocessor processor(chrList, minBlockSize.getValue());
+		bool resume = resumeDir.isSet();
+		if(checkpointDir.isSet())
+		{
+			SyntenyFinder::CreateOutDirectory(checkpointDir.getValue());
+		}
 
 		for(size_t i = 0; i < stage.size(); i++)
 		{
+			Profiler::Scope stageScope("stage", i + 1);
 			trimK = std::min(trimK, stage[i].first);
 			if(hierarchy || allStages)
 			{
+				//The graph goes first, the blocks take the edges of the graph away
+				if(graphFile.isSet())
+				{
+					std::stringstream ss;
+					ss << outFileDir.getValue() << "/de_bruijn_graph" << i << ".dot";
+					std::ofstream graph(ss.str().c_str(), std::ios::out);
+					finder->SerializeCondensedGraph(stage[i].first, graph, PutProgressChr);
+				}
+
 				if(!noBlocks.isSet())
 				{
+					Profiler::Scope blocks("synteny blocks");
 					finder->GenerateSyntenyBlocks(stage[i].first, trimK, stage[i].first, history[i], sharedOnly.getValue());
+					blocks.Stop();
 					if(!noPostProcessing)
 					{
+						Profiler::Scope postprocessing("postprocessing");
 						processor.GlueStripes(history[i]);
 					}
 				}
-
-				if(graphFile.isSet())
-				{
-					std::stringstream ss;
-					ss << outFileDir.getValue() << "/de_bruijn_graph" << i << ".dot";
-					std::ofstream graph(ss.str().c_str(), std::ios::out);
-					finder->SerializeCondensedGraph(stage[i].first, graph, PutProgressChr);
-				}
 			}
 
+			std::stringstream checkpoint;
+			checkpoint << "/stage" << i + 1 << ".ckpt";
 			std::cout << "Simplification stage " << i + 1 << " of " << stage.size() << std::endl;
+			if(resume && finder->LoadCheckpoint(resumeDir.getValue() + checkpoint.str(), stage[i].first, stage[i].second, maxIterations.getValue()))
+			{
+				std::cout << "Loaded simplified sequences from " << resumeDir.getValue() + checkpoint.str() << std::endl;
+				continue;
+			}
+
+			resume = false;
 			std::cout << "Enumerating vertices of the graph, then performing bulge removal..." << std::endl;
 			finder->PerformGraphSimplifications(stage[i].first, stage[i].second, maxIterations.getValue(), PutProgressChr);			
+			if(checkpointDir.isSet())
+			{
+				Profiler::Scope saving("checkpoint");
+				finder->SaveCheckpoint(checkpointDir.getValue() + checkpoint.str());
+			}
 		}
 
 		std::cout << "Finding synteny blocks and generating the output..." << std::endl;
@@ -273,20 +403,51 @@ int main(int argc, char * argv[])
 		bool oldFormat = !GFFFormatFlag.isSet();
 		SyntenyFinder::OutputGenerator generator(chrList);
 		SyntenyFinder::CreateOutDirectory(outFileDir.getValue());
-		boost::function<void(const std::vector<SyntenyFinder::BlockInstance>&, const std::string&)> coordsWriter = 
+		boost::function<void(const SyntenyFinder::GroupedBlockList&, const std::string&)> coordsWriter = 
 			oldFormat ? boost::bind(&SyntenyFinder::OutputGenerator::ListBlocksIndices, boost::cref(generator), _1, _2)
 					  : boost::bind(&SyntenyFinder::OutputGenerator::ListBlocksIndicesGFF, boost::cref(generator), _1, _2);
 		const std::string defaultCoordsFile = outFileDir.getValue() + "/blocks_coords" + (oldFormat ? ".txt" : ".gff");
 		const std::string defaultPermutationsFile = outFileDir.getValue() + "/genomes_permutations.txt";
 		const std::string defaultCoverageReportFile = outFileDir.getValue() + "/coverage_report.txt";
+		const std::string defaultTreeFile = outFileDir.getValue() + "/blocks_tree.txt";
+		const std::string defaultBinaryCoordsFile = outFileDir.getValue() + "/blocks_coords.bin";
+		const std::string defaultBedGraphFile = outFileDir.getValue() + "/coverage.bedgraph";
 		const std::string defaultSequencesFile = outFileDir.getValue() + "/blocks_sequences.fasta";		
+		const std::string defaultAlignmentsFile = outFileDir.getValue() + "/blocks_alignments.maf";
+		const std::string defaultVariantsFile = outFileDir.getValue() + "/variant.vcf";
+		const std::string defaultUnmappedFile = outFileDir.getValue() + "/unmapped_insertions.fasta";
 		const std::string defaultCircosDir = outFileDir.getValue() + "/circos";
 		const std::string defaultCircosFile = defaultCircosDir + "/circos.conf";
 		const std::string defaultD3File = outFileDir.getValue() + "/d3_blocks_diagram.html";
 
+		if(graphFile.isSet())
+		{
+			Profiler::Scope graphScope("de_bruijn_graph");
+			std::stringstream ss;
+			ss << outFileDir.getValue() << "/de_bruijn_graph";
+			if(allStages)
+			{			
+				ss << stage.size();
+			}
+
+			ss << ".dot";						
+			std::ofstream graph(ss.str().c_str(), std::ios::out);
+			finder->SerializeCondensedGraph(lastK, graph, PutProgressChr);
+			
+		}
+
 		if(!noBlocks.isSet())
 		{
+			Profiler::Scope blocks("synteny blocks");
 			finder->GenerateSyntenyBlocks(lastK, trimK, minBlockSize.getValue(), history.back(), sharedOnly.getValue(), PutProgressChr);
+			blocks.Stop();
+		}
+
+		//Nothing uses the graph after this point
+		finder->ReleaseIndex();
+		if(!noBlocks.isSet())
+		{
+			Profiler::Scope postprocessing("postprocessing");
 			if(!noPostProcessing)
 			{
 				processor.GlueStripes(history.back());
@@ -297,51 +458,119 @@ int main(int argc, char * argv[])
 				processor.ImproveBlockBoundaries(history.back(), referenceChrId);
 			}
 
+			postprocessing.Stop();
+			Profiler::Scope output("output");
+
+			//Views grouped by blocks are built once per stage and shared by the writers,
+			//then the writers run concurrently
+			typedef std::vector<SyntenyFinder::BlockInstance> BlockList;
+			typedef SyntenyFinder::OutputGenerator Generator;
+			std::vector<SyntenyFinder::GroupedBlockList> grouped;
+			for(size_t i = allStages ? 0 : history.size() - 1; i < history.size(); i++)
+			{
+				grouped.push_back(SyntenyFinder::GroupedBlockList(history[i]));
+			}
+
+			//Stages linked into a tree, shared by the tree and the circos writers
+			boost::scoped_ptr<SyntenyFinder::BlockHierarchy> tree(hierarchy || allStages ? new SyntenyFinder::BlockHierarchy(history) : 0);
+			std::vector<BlockList> finalStage;
+			if(binaryCoordsFlag.isSet() && !allStages)
+			{
+				finalStage.push_back(history.back());
+			}
+
+			std::vector<boost::function<void()> > writer;
+			writer.push_back(Profiler::Wrap("d3_blocks_diagram", boost::bind(&Generator::GenerateD3Output, boost::cref(generator), boost::cref(history.back()), defaultD3File, d3MaxInstances.getValue())));
+			if(!hierarchy)
+			{
+				writer.push_back(Profiler::Wrap("circos", boost::bind(&Generator::GenerateCircosOutput, boost::cref(generator), boost::cref(grouped.back()), defaultCircosFile, defaultCircosDir)));
+			}
+			else
+			{
+				writer.push_back(Profiler::Wrap("circos", boost::bind(&Generator::GenerateHierarchyCircosOutput, boost::cref(generator), boost::cref(*tree), defaultCircosFile, defaultCircosDir)));
+			}
+
 			if(allStages)
 			{			
 				for(size_t i = 0; i < history.size(); i++)
 				{
-					std::stringstream file;
-					file << outFileDir.getValue() << "/blocks_coords" << i << (oldFormat ? ".txt" : ".gff");
-					coordsWriter(history[i], file.str());
+					std::stringstream name;
+					name << "blocks_coords" << i;
+					std::string file = outFileDir.getValue() + "/" + name.str() + (oldFormat ? ".txt" : ".gff");
+					writer.push_back(Profiler::Wrap(name.str(), boost::bind(coordsWriter, boost::cref(grouped[i]), file)));
 				}
 			}
 			else
 			{
-				coordsWriter(history.back(), defaultCoordsFile);
+				writer.push_back(Profiler::Wrap("blocks_coords", boost::bind(coordsWriter, boost::cref(grouped.back()), defaultCoordsFile)));
 			}
 
-			generator.ListChromosomesAsPermutations(history.back(), defaultPermutationsFile);
-			generator.GenerateReport(history.back(), defaultCoverageReportFile);				
-			if(sequencesFile.isSet())
+			if(tree.get() != 0)
 			{
-				generator.ListBlocksSequences(history.back(), defaultSequencesFile);
+				writer.push_back(Profiler::Wrap("blocks_tree", boost::bind(&Generator::OutputTree, boost::cref(generator), boost::cref(*tree), defaultTreeFile)));
 			}
 
-			generator.GenerateD3Output(history.back(), defaultD3File);
-			if(!hierarchy)
+			if(binaryCoordsFlag.isSet())
 			{
-				generator.GenerateCircosOutput(history.back(), defaultCircosFile, defaultCircosDir);
+				writer.push_back(Profiler::Wrap("blocks_coords.bin", boost::bind(&Generator::ListBlocksIndicesBinary, boost::cref(generator), boost::cref(allStages ? history : finalStage), defaultBinaryCoordsFile)));
 			}
-			else
+
+			writer.push_back(Profiler::Wrap("genomes_permutations", boost::bind(&Generator::ListChromosomesAsPermutations, boost::cref(generator), boost::cref(history.back()), defaultPermutationsFile)));
+			writer.push_back(Profiler::Wrap("coverage_report", boost::bind(&Generator::GenerateReport, boost::cref(generator), boost::cref(history.back()), defaultCoverageReportFile)));
+			if(bedGraphFlag.isSet())
+			{
+				writer.push_back(Profiler::Wrap("coverage.bedgraph", boost::bind(&Generator::GenerateBedGraph, boost::cref(generator), boost::cref(history.back()), defaultBedGraphFile)));
+			}
+
+			RunConcurrently(writer);
+			if(sequencesFile.isSet())
+			{
+				//Runs alone, it formats and compresses the blocks on all the threads itself
+				Profiler::Scope sequences("blocks_sequences");
+				generator.ListBlocksSequences(grouped.back(), defaultSequencesFile + (bgzfFlag.isSet() ? ".gz" : ""), bgzfFlag.isSet());
+			}
+
+			output.Stop();
+			if(mafFlag.isSet() || callVariants)
 			{
-				generator.GenerateHierarchyCircosOutput(history, defaultCircosFile, defaultCircosDir);
+				std::cout << "Aligning synteny blocks..." << std::endl;
+				Profiler::Scope aligning("alignments");
+				SyntenyFinder::VariantCaller variantCaller(chrList, referenceChrId, minBlockSize.getValue());
+				std::auto_ptr<SyntenyFinder::AlignmentCache> cache(alignCacheDir.isSet() ?
+					new SyntenyFinder::AlignmentCache(alignCacheDir.getValue(), static_cast<uint64_t>(alignCacheSize.getValue()) << 20) : 0);
+				generator.GenerateAlignments(grouped.back(), referenceChrId, minBlockSize.getValue(),
+					mafFlag.isSet() ? defaultAlignmentsFile : "", callVariants ? &variantCaller : 0, cache.get());
+				if(cache.get() != 0)
+				{
+					cache->Evict();
+					std::cout << "Reused " << cache->GetHits() << " of " << cache->GetHits() + cache->GetMisses() << " alignments from the cache" << std::endl;
+					Profiler::Count("cached alignments", cache->GetHits());
+				}
+
+				aligning.Stop();
+				if(callVariants)
+				{
+					std::cout << "Calling variants..." << std::endl;
+					Profiler::Scope variants("variants");
+					variantCaller.CallIndels(history);
+					generator.ListVariantsVCF(variantCaller, defaultVariantsFile, !unmappedFlag.isSet());
+					if(unmappedFlag.isSet())
+					{
+						generator.ListUnmappedInsertions(variantCaller, defaultUnmappedFile);
+					}
+				}
 			}
 		}
 
-		if(graphFile.isSet())
+		if(profileFile.isSet())
 		{
-			std::stringstream ss;
-			ss << outFileDir.getValue() << "/de_bruijn_graph";
-			if(allStages)
-			{			
-				ss << stage.size();
+			std::string command(argv[0]);
+			for(int i = 1; i < argc; i++)
+			{
+				command += std::string(" ") + argv[i];
 			}
 
-			ss << ".dot";						
-			std::ofstream graph(ss.str().c_str(), std::ios::out);
-			finder->SerializeCondensedGraph(lastK, graph, PutProgressChr);
-			
+			Profiler::WriteReport(profileFile.getValue(), command);
 		}
 
 		std::cout.setf(std::cout.fixed);
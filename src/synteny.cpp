@@ -229,26 +229,33 @@ namespace SyntenyFinder
 	void BlockFinder::GenerateSyntenyBlocks(size_t k, size_t trimK, size_t minSize, std::vector<BlockInstance> & block, bool sharedOnly, ProgressCallBack enumeration)
 	{
 		std::vector<Edge> edge;
+		TakeEdges(k, edge);
 		std::vector<Indicator> overlap(rawSeq_.size());
 		for(size_t i = 0; i < rawSeq_.size(); i++)
 		{
 			overlap[i].resize(originalSize_[i], POS_FREE);
 		}
 
-		{
-			IndexedSequence iseq(rawSeq_, originalPos_, k, tempDir_);
-			ListEdges(iseq.Sequence(), iseq.BifStorage(), k, edge);			
-		}
-		
 		block.clear();
 		int blockCount = 1;
+		Profiler::Scope grouping("grouping");
 		edge.erase(std::remove_if(edge.begin(), edge.end(), boost::bind(EdgeEmpty, _1, minSize)), edge.end());
 		std::vector<std::pair<size_t, size_t> > group;
 		GroupBy(edge, CompareEdgesNaturally, std::back_inserter(group));
 		EdgeGroupComparer groupComparer(&edge);
 		std::sort(group.begin(), group.end(), groupComparer);
+		Profiler::Count("groups", group.size());
+		grouping.Stop();
+		double startTime = GetWallClock();
+		size_t threshold = group.size() / PROGRESS_STRIDE + 1;
+		Report("synteny blocks", start, k, 0, group.size(), 0, startTime);
 		for(size_t g = 0; g < group.size(); g++)
 		{
+			if(g % threshold == 0 && g > 0)
+			{
+				Report("synteny blocks", run, k, g, group.size(), blockCount - 1, startTime);
+			}
+
 			std::vector<Edge>::iterator firstEdge = edge.begin() + group[g].first;
 			std::vector<Edge>::iterator lastEdge = edge.begin() + group[g].second;			 
 			std::sort(firstEdge, lastEdge, CompareEdgesByDirection);
@@ -260,7 +267,9 @@ namespace SyntenyFinder
 			std::vector<Edge> nowBlock;
 			std::vector<size_t> occur(rawSeq_.size(), 0);
 			ResolveOverlap(firstEdge, lastEdge, minSize, overlap, nowBlock);			
+			Profiler::Scope trimming("TrimBlocks");
 			while(TrimBlocks(nowBlock, trimK, minSize));
+			trimming.Stop();
 			for(size_t nowEdge = 0; nowEdge < nowBlock.size(); nowEdge++)
 			{
 				occur[nowBlock[nowEdge].GetChr()]++;				
@@ -283,5 +292,7 @@ namespace SyntenyFinder
 		}
 
 		std::sort(block.begin(), block.end(), CompareBlocksNaturally);
+		Profiler::Count("blocks", blockCount - 1);
+		Report("synteny blocks", end, k, group.size(), group.size(), blockCount - 1, startTime);
 	}
 }
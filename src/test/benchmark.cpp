@@ -0,0 +1,616 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#include <tclap/CmdLine.h>
+#include "../postprocessor.h"
+#include "../blockcoords.h"
+#include "../outputgenerator.h"
+#include "../util.h"
+#include "syntheticgenome.h"
+
+const std::string VERSION("3.0.6");
+
+#ifndef SIBELIA_EXAMPLES_DIR
+	#define SIBELIA_EXAMPLES_DIR "../examples/Sibelia"
+#endif
+
+namespace SyntenyFinder
+{
+	namespace
+	{
+		const size_t MAX_ITERATIONS = 4;
+		const size_t LIST_EDIT_STRIDE = 64;
+		const size_t LIST_EDIT_LENGTH = 8;
+		const size_t BIFURCATION_IDS = 1 << 16;
+		const size_t COORDS_INSTANCES = 1000000;
+		const size_t COORDS_MAX_LENGTH = 5000;
+		const size_t COORDS_QUERIES = 100000;
+		const size_t COORDS_QUERY_LENGTH = 1000;
+		const std::string COORDS_FILE_NAME = "sibelia_bench_coords.bin";
+		const char ERASED_CHAR = '$';
+		const std::string EXAMPLE_NAME[] = {"Helicobacter_pylori", "Staphylococcus_aureus"};
+		typedef boost::function<double(uint64_t&)> BenchmarkFunction;
+
+		struct Result
+		{
+			std::string name;
+			std::string unit;
+			uint64_t items;
+			std::vector<double> seconds;
+		};
+
+		size_t TotalSize(const std::vector<FASTARecord> & chrList)
+		{
+			size_t ret = 0;
+			for(size_t i = 0; i < chrList.size(); i++)
+			{
+				ret += chrList[i].GetSequence().size();
+			}
+
+			return ret;
+		}
+
+		//The last report of bulge removal has the time and the vertices of the whole phase
+		void BulgeRemovalPass(const BlockFinder::Progress & progress, double & seconds, uint64_t & vertices)
+		{
+			if(progress.phase == "bulge removal" && progress.state == BlockFinder::end)
+			{
+				seconds = progress.seconds;
+				vertices = progress.done;
+			}
+		}
+
+		//Runs the whole pipeline except output, as Sibelia does it with the default options
+		double Pipeline(const std::vector<FASTARecord> & chrList, const std::vector<std::pair<int, int> > & stage, size_t minBlockSize, uint64_t seed, uint64_t & items)
+		{
+			srand(static_cast<unsigned int>(seed));
+			double start = GetWallClock();
+			int trimK = INT_MAX;
+			BlockFinder finder(chrList);
+			for(size_t i = 0; i < stage.size(); i++)
+			{
+				trimK = std::min(trimK, stage[i].first);
+				finder.PerformGraphSimplifications(stage[i].first, stage[i].second, MAX_ITERATIONS);
+			}
+
+			trimK = std::min(trimK, static_cast<int>(minBlockSize));
+			size_t lastK = std::min(stage.size() > 0 ? stage.back().first : INT_MAX, static_cast<int>(minBlockSize));
+			std::vector<BlockInstance> block;
+			finder.GenerateSyntenyBlocks(lastK, trimK, minBlockSize, block);
+			Postprocessor processor(chrList, minBlockSize);
+			processor.GlueStripes(block);
+			items = TotalSize(chrList);
+			return GetWallClock() - start;
+		}
+	}
+
+	//Each benchmark prepares its data, measures the wall clock time of the part it
+	//is named after and reports the number of items processed in that part
+	class Benchmark
+	{
+	public:
+		Benchmark(const std::vector<FASTARecord> & genome, uint64_t seed, size_t k, size_t minBranchSize, size_t minBlockSize);
+		~Benchmark();
+		double UnrolledListPushBack(uint64_t & items);
+		double UnrolledListIterate(uint64_t & items);
+		double UnrolledListInsertErase(uint64_t & items);
+		double SlidingWindowMove(uint64_t & items);
+		double BifurcationStorageUpdate(uint64_t & items);
+		double VertexEnumeration(uint64_t & items);
+		double RemoveBulges(uint64_t & items);
+		double GenerateSyntenyBlocks(uint64_t & items);
+		double GlueStripes(uint64_t & items);
+		double BlockCoordsOpen(uint64_t & items);
+		double BlockCoordsFindOverlapping(uint64_t & items);
+	private:
+		DISALLOW_COPY_AND_ASSIGN(Benchmark);
+		const std::vector<FASTARecord> * genome_;
+		std::vector<std::string> record_;
+		std::vector<std::vector<Pos> > original_;
+		uint64_t seed_;
+		size_t k_;
+		size_t minBranchSize_;
+		size_t minBlockSize_;
+		uint64_t sink_;
+		std::vector<BlockInstance> block_;
+		bool coordsWritten_;
+		void FillList(DNASequence::Sequence & list) const;
+		void FindBlocks(std::vector<BlockInstance> & block);
+		void WriteCoords();
+	};
+
+	Benchmark::Benchmark(const std::vector<FASTARecord> & genome, uint64_t seed, size_t k, size_t minBranchSize, size_t minBlockSize):
+		genome_(&genome), seed_(seed), k_(k), minBranchSize_(minBranchSize), minBlockSize_(minBlockSize), sink_(0), coordsWritten_(false)
+	{
+		for(size_t i = 0; i < genome.size(); i++)
+		{
+			record_.push_back(genome[i].GetSequence());
+			original_.push_back(std::vector<Pos>(record_.back().size()));
+			std::generate(original_.back().begin(), original_.back().end(), Counter<Pos>());
+		}
+	}
+
+	Benchmark::~Benchmark()
+	{
+		if(coordsWritten_)
+		{
+			std::remove(COORDS_FILE_NAME.c_str());
+		}
+	}
+
+	void Benchmark::FillList(DNASequence::Sequence & list) const
+	{
+		for(size_t i = 0; i < record_.size(); i++)
+		{
+			for(size_t j = 0; j < record_[i].size(); j++)
+			{
+				list.push_back(DNASequence::DNACharacter(record_[i][j]));
+			}
+		}
+	}
+
+	double Benchmark::UnrolledListPushBack(uint64_t & items)
+	{
+		DNASequence::DNACharacter erased(ERASED_CHAR);
+		DNASequence::Sequence list(erased);
+		double start = GetWallClock();
+		FillList(list);
+		double ret = GetWallClock() - start;
+		items = list.size();
+		return ret;
+	}
+
+	double Benchmark::UnrolledListIterate(uint64_t & items)
+	{
+		DNASequence::DNACharacter erased(ERASED_CHAR);
+		DNASequence::Sequence list(erased);
+		FillList(list);
+		uint64_t gc = 0;
+		items = 0;
+		double start = GetWallClock();
+		for(DNASequence::Sequence::iterator it = list.begin(); it != list.end(); ++it, ++items)
+		{
+			gc += (*it).actual == 'G' || (*it).actual == 'C' ? 1 : 0;
+		}
+
+		double ret = GetWallClock() - start;
+		sink_ += gc;
+		return ret;
+	}
+
+	//Replaces short pieces along the list, like bulge removal does with the sequence
+	double Benchmark::UnrolledListInsertErase(uint64_t & items)
+	{
+		DNASequence::DNACharacter erased(ERASED_CHAR);
+		DNASequence::Sequence list(erased);
+		FillList(list);
+		std::string piece(LIST_EDIT_LENGTH, 'A');
+		items = 0;
+		double start = GetWallClock();
+		for(DNASequence::Sequence::iterator it = list.begin(); it != list.end(); )
+		{
+			for(size_t i = 0; i < LIST_EDIT_STRIDE && it != list.end(); i++)
+			{
+				++it;
+			}
+
+			DNASequence::Sequence::iterator jt = it;
+			for(size_t i = 0; i < LIST_EDIT_LENGTH && jt != list.end(); i++)
+			{
+				++jt;
+			}
+
+			if(jt == list.end())
+			{
+				break;
+			}
+
+			if(items++ % 2 == 0)
+			{
+				it = list.erase(it, jt);
+			}
+			else
+			{
+				it = list.insert(it, piece.begin(), piece.end());
+				it = AdvanceForward(it, LIST_EDIT_LENGTH);
+			}
+		}
+
+		return GetWallClock() - start;
+	}
+
+	double Benchmark::SlidingWindowMove(uint64_t & items)
+	{
+		DNASequence sequence(record_, original_);
+		uint64_t hash = 0;
+		items = 0;
+		double start = GetWallClock();
+		for(size_t strand = 0; strand < 2; strand++)
+		{
+			DNASequence::Direction dir = static_cast<DNASequence::Direction>(strand);
+			for(size_t chr = 0; chr < sequence.ChrNumber(); chr++)
+			{
+				if(record_[chr].size() >= k_)
+				{
+					SlidingWindow<StrandIterator> window(sequence.Begin(dir, chr), sequence.End(dir, chr), k_);
+					for(; window.Valid(); window.Move(), ++items)
+					{
+						hash ^= window.GetValue();
+					}
+				}
+			}
+		}
+
+		double ret = GetWallClock() - start;
+		sink_ += hash;
+		return ret;
+	}
+
+	//Marks every position with a bifurcation, looks all of them up, then erases them
+	double Benchmark::BifurcationStorageUpdate(uint64_t & items)
+	{
+		DNASequence sequence(record_, original_);
+		BifurcationStorage bifStorage(BIFURCATION_IDS);
+		uint64_t found = 0;
+		items = 0;
+		double start = GetWallClock();
+		for(size_t pass = 0; pass < 3; pass++)
+		{
+			for(size_t strand = 0; strand < 2; strand++)
+			{
+				DNASequence::Direction dir = static_cast<DNASequence::Direction>(strand);
+				for(size_t chr = 0; chr < sequence.ChrNumber(); chr++)
+				{
+					size_t pos = 0;
+					StrandIterator end = sequence.End(dir, chr);
+					for(StrandIterator it = sequence.Begin(dir, chr); it != end; ++it, ++pos)
+					{
+						if(pass == 0)
+						{
+							bifStorage.AddPoint(it, (pos * 2 + strand) % BIFURCATION_IDS);
+							items++;
+						}
+						else if(pass == 1)
+						{
+							found += bifStorage.GetBifurcation(it) != BifurcationStorage::NO_BIFURCATION ? 1 : 0;
+						}
+						else
+						{
+							bifStorage.ErasePoint(it);
+						}
+					}
+				}
+			}
+		}
+
+		double ret = GetWallClock() - start;
+		sink_ += found;
+		return ret;
+	}
+
+	double Benchmark::VertexEnumeration(uint64_t & items)
+	{
+		srand(static_cast<unsigned int>(seed_));
+		std::vector<std::string> record(record_);
+		for(size_t i = 0; i < record.size(); i++)
+		{
+			for(size_t j = 0; j < record[i].size(); j++)
+			{
+				record[i][j] = IsDefiniteBase(record[i][j]) ? record[i][j] : DEFINITE_BASE[rand() % DEFINITE_BASE.size()];
+			}
+		}
+
+		double start = GetWallClock();
+		sink_ += IndexedSequence::EnumerateVertices(record, k_);
+		double ret = GetWallClock() - start;
+		items = TotalSize(*genome_);
+		return ret;
+	}
+
+	//One pass of bulge removal over all vertices of the graph, the index is not measured
+	double Benchmark::RemoveBulges(uint64_t & items)
+	{
+		srand(static_cast<unsigned int>(seed_));
+		double ret = 0;
+		BlockFinder finder(*genome_);
+		finder.SetProgressReport(boost::bind(BulgeRemovalPass, _1, boost::ref(ret), boost::ref(items)));
+		sink_ += finder.PerformGraphSimplifications(k_, minBranchSize_, 1);
+		return ret;
+	}
+
+	//Blocks of the graph simplified at the stage with the vertex size and the branch size
+	double Benchmark::GenerateSyntenyBlocks(uint64_t & items)
+	{
+		srand(static_cast<unsigned int>(seed_));
+		BlockFinder finder(*genome_);
+		finder.PerformGraphSimplifications(k_, minBranchSize_, MAX_ITERATIONS);
+		std::vector<BlockInstance> block;
+		double start = GetWallClock();
+		finder.GenerateSyntenyBlocks(k_, k_, minBlockSize_, block);
+		double ret = GetWallClock() - start;
+		items = block.size();
+		return ret;
+	}
+
+	void Benchmark::FindBlocks(std::vector<BlockInstance> & block)
+	{
+		srand(static_cast<unsigned int>(seed_));
+		BlockFinder finder(*genome_);
+		finder.PerformGraphSimplifications(k_, minBranchSize_, MAX_ITERATIONS);
+		finder.GenerateSyntenyBlocks(k_, k_, minBlockSize_, block);
+	}
+
+	double Benchmark::GlueStripes(uint64_t & items)
+	{
+		if(block_.empty())
+		{
+			FindBlocks(block_);
+		}
+
+		std::vector<BlockInstance> block(block_);
+		Postprocessor processor(*genome_, minBlockSize_);
+		double start = GetWallClock();
+		processor.GlueStripes(block);
+		double ret = GetWallClock() - start;
+		items = block_.size();
+		return ret;
+	}
+
+	//Random instances of the synthetic genome written as --binarycoords does it
+	void Benchmark::WriteCoords()
+	{
+		srand(static_cast<unsigned int>(seed_));
+		std::vector<std::vector<BlockInstance> > history(1);
+		for(size_t i = 0; i < COORDS_INSTANCES; i++)
+		{
+			const FASTARecord & chr = (*genome_)[rand() % genome_->size()];
+			size_t length = std::min(rand() % COORDS_MAX_LENGTH + 1, chr.GetSequence().size());
+			size_t start = rand() % (chr.GetSequence().size() - length + 1);
+			int id = static_cast<int>(i / 2 + 1) * (rand() % 2 == 0 ? 1 : -1);
+			history[0].push_back(BlockInstance(id, &chr, start, start + length));
+		}
+
+		OutputGenerator(*genome_).ListBlocksIndicesBinary(history, COORDS_FILE_NAME);
+		coordsWritten_ = true;
+	}
+
+	//Opening includes the validation of the header and of the indices of the sequences
+	double Benchmark::BlockCoordsOpen(uint64_t & items)
+	{
+		if(!coordsWritten_)
+		{
+			WriteCoords();
+		}
+
+		double start = GetWallClock();
+		BlockCoordsFile file(COORDS_FILE_NAME);
+		double ret = GetWallClock() - start;
+		items = file.GetInstanceCount();
+		return ret;
+	}
+
+	//Windows of a fixed length at random places, the pages of the file are not evicted
+	//before the run, so it shows the search itself
+	double Benchmark::BlockCoordsFindOverlapping(uint64_t & items)
+	{
+		if(!coordsWritten_)
+		{
+			WriteCoords();
+		}
+
+		srand(static_cast<unsigned int>(seed_));
+		BlockCoordsFile file(COORDS_FILE_NAME);
+		std::vector<size_t> found;
+		double start = GetWallClock();
+		for(size_t i = 0; i < COORDS_QUERIES; i++)
+		{
+			size_t chr = rand() % file.GetChrCount();
+			uint64_t pos = rand() % file.GetChrLength(chr);
+			found.clear();
+			file.FindOverlapping(chr, pos, pos + COORDS_QUERY_LENGTH, std::back_inserter(found));
+			sink_ += found.size();
+		}
+
+		double ret = GetWallClock() - start;
+		items = COORDS_QUERIES;
+		return ret;
+	}
+
+	namespace
+	{
+		bool Selected(const std::string & name, const std::string & filter)
+		{
+			return name.find(filter) != std::string::npos;
+		}
+
+		void Measure(const std::string & name, const std::string & unit, BenchmarkFunction run, size_t repetitions, const std::string & filter, std::vector<Result> & result)
+		{
+			if(!Selected(name, filter))
+			{
+				return;
+			}
+
+			std::cerr << "Running " << name << "..." << std::endl;
+			Result now;
+			now.name = name;
+			now.unit = unit;
+			for(size_t i = 0; i < repetitions; i++)
+			{
+				now.seconds.push_back(run(now.items));
+			}
+
+			result.push_back(now);
+		}
+
+		void WriteResults(std::ostream & out, const SyntheticGenomeParameters & parameters, size_t totalSize, size_t k, size_t minBranchSize, size_t minBlockSize, const std::vector<Result> & result)
+		{
+			out.setf(std::ios::fixed);
+			out.precision(6);
+			out << "{" << std::endl;
+			out << "\t\"version\": \"" << VERSION << "\"," << std::endl;
+			out << "\t\"synthetic\": {\"seed\": " << parameters.seed << ", \"genomes\": " << parameters.genomes << ", \"length\": " << parameters.length
+				<< ", \"repeatFamilies\": " << parameters.repeatFamilies << ", \"repeatCopies\": " << parameters.repeatCopies << ", \"repeatLength\": " << parameters.repeatLength
+				<< ", \"repeatDivergence\": " << parameters.repeatDivergence << ", \"inversions\": " << parameters.inversions << ", \"translocations\": " << parameters.translocations
+				<< ", \"maxEventLength\": " << parameters.maxEventLength << ", \"indels\": " << parameters.indels << ", \"maxIndelLength\": " << parameters.maxIndelLength
+				<< ", \"mutationRate\": " << parameters.mutationRate << ", \"nRuns\": " << parameters.nRuns << ", \"maxNRunLength\": " << parameters.maxNRunLength
+				<< ", \"totalBases\": " << totalSize << "}," << std::endl;
+			out << "\t\"stage\": {\"k\": " << k << ", \"minBranchSize\": " << minBranchSize << ", \"minBlockSize\": " << minBlockSize << "}," << std::endl;
+			out << "\t\"benchmarks\": [";
+			for(size_t i = 0; i < result.size(); i++)
+			{
+				std::vector<double> seconds(result[i].seconds);
+				std::sort(seconds.begin(), seconds.end());
+				double median = seconds.size() % 2 == 1 ? seconds[seconds.size() / 2] : (seconds[seconds.size() / 2 - 1] + seconds[seconds.size() / 2]) / 2;
+				double mean = std::accumulate(seconds.begin(), seconds.end(), 0.0) / seconds.size();
+				out << (i > 0 ? "," : "") << std::endl << "\t\t{\"name\": \"" << result[i].name << "\", \"unit\": \"" << result[i].unit << "\", \"items\": " << result[i].items
+					<< ", \"repetitions\": " << seconds.size() << ", \"minSeconds\": " << seconds.front() << ", \"medianSeconds\": " << median << ", \"meanSeconds\": " << mean
+					<< ", \"itemsPerSecond\": " << (median > 0 ? result[i].items / median : 0) << "}";
+			}
+
+			out << std::endl << "\t]" << std::endl << "}" << std::endl;
+		}
+	}
+}
+
+int main(int argc, char * argv[])
+{
+	using namespace SyntenyFinder;
+	try
+	{
+		SyntheticGenomeParameters parameters;
+		TCLAP::CmdLine cmd("Benchmarks of Sibelia on synthetic genomes and the bundled examples", ' ', VERSION);
+		TCLAP::ValueArg<unsigned int> seed("", "seed", "Seed of the synthetic genomes.", false, static_cast<unsigned int>(parameters.seed), "integer", cmd);
+		TCLAP::ValueArg<unsigned int> genomes("", "genomes", "Number of synthetic genomes.", false, parameters.genomes, "integer", cmd);
+		TCLAP::ValueArg<unsigned int> length("", "length", "Length of the common ancestor without repeats.", false, parameters.length, "integer", cmd);
+		TCLAP::ValueArg<unsigned int> repeatFamilies("", "families", "Number of repeat families.", false, parameters.repeatFamilies, "integer", cmd);
+		TCLAP::ValueArg<unsigned int> repeatCopies("", "copies", "Copy number of each repeat family.", false, parameters.repeatCopies, "integer", cmd);
+		TCLAP::ValueArg<unsigned int> repeatLength("", "repeatlength", "Length of a repeat.", false, parameters.repeatLength, "integer", cmd);
+		TCLAP::ValueArg<unsigned int> repeatDivergence("", "divergence", "Substitutions per 1000 bases between copies of a repeat.", false, parameters.repeatDivergence, "integer", cmd);
+		TCLAP::ValueArg<unsigned int> inversions("", "inversions", "Inversions per genome.", false, parameters.inversions, "integer", cmd);
+		TCLAP::ValueArg<unsigned int> translocations("", "translocations", "Translocations per genome.", false, parameters.translocations, "integer", cmd);
+		TCLAP::ValueArg<unsigned int> maxEventLength("", "eventlength", "Maximum length of an inverted or translocated segment.", false, parameters.maxEventLength, "integer", cmd);
+		TCLAP::ValueArg<unsigned int> indels("", "indels", "Short insertions and deletions per genome.", false, parameters.indels, "integer", cmd);
+		TCLAP::ValueArg<unsigned int> maxIndelLength("", "indellength", "Maximum length of an insertion or a deletion.", false, parameters.maxIndelLength, "integer", cmd);
+		TCLAP::ValueArg<unsigned int> mutationRate("", "mutationrate", "Substitutions per 1000 bases of a genome.", false, parameters.mutationRate, "integer", cmd);
+		TCLAP::ValueArg<unsigned int> nRuns("", "nruns", "Runs of N per genome.", false, parameters.nRuns, "integer", cmd);
+		TCLAP::ValueArg<unsigned int> maxNRunLength("", "nrunlength", "Maximum length of a run of N.", false, parameters.maxNRunLength, "integer", cmd);
+		TCLAP::ValueArg<unsigned int> vertexSize("k", "vertexsize", "Vertex size of the graph in the microbenchmarks, default = 30.", false, 30, "integer", cmd);
+		TCLAP::ValueArg<unsigned int> minBranchSize("", "minbranchsize", "Minimum branch size in the microbenchmarks, default = 150.", false, 150, "integer", cmd);
+		TCLAP::ValueArg<unsigned int> minBlockSize("m", "minblocksize", "Minimum size of a synteny block in the microbenchmarks, default = 500.", false, 500, "integer", cmd);
+		TCLAP::ValueArg<unsigned int> repetitions("n", "repetitions", "Number of runs of each benchmark, default = 3.", false, 3, "integer", cmd);
+		TCLAP::ValueArg<std::string> filter("f", "filter", "Run only the benchmarks whose names contain this string.", false, "", "string", cmd);
+		TCLAP::ValueArg<std::string> examplesDir("", "examples", "Directory with the examples of Sibelia.", false, SIBELIA_EXAMPLES_DIR, "dir name", cmd);
+		TCLAP::ValueArg<std::string> generateFile("", "generate", "Only write the synthetic genomes to this FASTA file.", false, "", "file name", cmd);
+		TCLAP::ValueArg<std::string> outFile("o", "outfile", "File where the results are written in JSON, default is the standard output.", false, "", "file name", cmd);
+		cmd.parse(argc, argv);
+
+		parameters.seed = seed.getValue();
+		parameters.genomes = genomes.getValue();
+		parameters.length = length.getValue();
+		parameters.repeatFamilies = repeatFamilies.getValue();
+		parameters.repeatCopies = repeatCopies.getValue();
+		parameters.repeatLength = repeatLength.getValue();
+		parameters.repeatDivergence = repeatDivergence.getValue();
+		parameters.inversions = inversions.getValue();
+		parameters.translocations = translocations.getValue();
+		parameters.maxEventLength = maxEventLength.getValue();
+		parameters.indels = indels.getValue();
+		parameters.maxIndelLength = maxIndelLength.getValue();
+		parameters.mutationRate = mutationRate.getValue();
+		parameters.nRuns = nRuns.getValue();
+		parameters.maxNRunLength = maxNRunLength.getValue();
+		if(vertexSize.getValue() < 2 || repetitions.getValue() < 1)
+		{
+			throw std::runtime_error("Vertex size must be at least 2 and there must be at least one repetition");
+		}
+
+		std::vector<FASTARecord> genome;
+		SyntheticGenomeGenerator(parameters).Generate(genome);
+		if(generateFile.isSet())
+		{
+			SyntheticGenomeGenerator::WriteFASTA(generateFile.getValue(), genome);
+			return 0;
+		}
+
+		size_t n = repetitions.getValue();
+		std::vector<Result> result;
+		Benchmark bench(genome, parameters.seed, vertexSize.getValue(), minBranchSize.getValue(), minBlockSize.getValue());
+		Measure("unrolled_list/push_back", "elements", boost::bind(&Benchmark::UnrolledListPushBack, &bench, _1), n, filter.getValue(), result);
+		Measure("unrolled_list/iterate", "elements", boost::bind(&Benchmark::UnrolledListIterate, &bench, _1), n, filter.getValue(), result);
+		Measure("unrolled_list/insert_erase", "edits", boost::bind(&Benchmark::UnrolledListInsertErase, &bench, _1), n, filter.getValue(), result);
+		Measure("SlidingWindow/move", "windows", boost::bind(&Benchmark::SlidingWindowMove, &bench, _1), n, filter.getValue(), result);
+		Measure("BifurcationStorage/add_find_erase", "points", boost::bind(&Benchmark::BifurcationStorageUpdate, &bench, _1), n, filter.getValue(), result);
+		Measure("vertex_enumeration/in_ram", "bases", boost::bind(&Benchmark::VertexEnumeration, &bench, _1), n, filter.getValue(), result);
+		Measure("RemoveBulges/one_pass", "vertices", boost::bind(&Benchmark::RemoveBulges, &bench, _1), n, filter.getValue(), result);
+		Measure("GenerateSyntenyBlocks", "instances", boost::bind(&Benchmark::GenerateSyntenyBlocks, &bench, _1), n, filter.getValue(), result);
+		Measure("GlueStripes", "instances", boost::bind(&Benchmark::GlueStripes, &bench, _1), n, filter.getValue(), result);
+		Measure("BlockCoordsFile/open", "instances", boost::bind(&Benchmark::BlockCoordsOpen, &bench, _1), n, filter.getValue(), result);
+		Measure("BlockCoordsFile/find_overlapping", "queries", boost::bind(&Benchmark::BlockCoordsFindOverlapping, &bench, _1), n, filter.getValue(), result);
+		Measure("pipeline/synthetic", "bases", boost::bind(Pipeline, boost::cref(genome), LooseStageFile(), 5000, parameters.seed, _1), n, filter.getValue(), result);
+
+		//The examples are run as in their README files
+		std::vector<std::vector<FASTARecord> > example(sizeof(EXAMPLE_NAME) / sizeof(EXAMPLE_NAME[0]));
+		for(size_t i = 0; i < example.size(); i++)
+		{
+			std::string name = "pipeline/" + EXAMPLE_NAME[i];
+			if(Selected(name, filter.getValue()))
+			{
+				std::vector<FileStatus> file;
+				try
+				{
+					ListFiles(examplesDir.getValue() + "/" + EXAMPLE_NAME[i], ".fasta", file);
+				}
+				catch(std::runtime_error &)
+				{
+				}
+
+				if(file.empty())
+				{
+					std::cerr << "Skipping " << name << ", no FASTA files found" << std::endl;
+					continue;
+				}
+
+				std::vector<size_t> recordCount;
+				std::vector<std::string> fileName;
+				for(size_t j = 0; j < file.size(); j++)
+				{
+					fileName.push_back(file[j].path);
+				}
+
+				std::sort(fileName.begin(), fileName.end());
+				FASTAReader::ReadFiles(fileName, example[i], recordCount);
+				Measure(name, "bases", boost::bind(Pipeline, boost::cref(example[i]), LooseStageFile(), 5000, parameters.seed, _1), n, filter.getValue(), result);
+			}
+		}
+
+		if(outFile.isSet())
+		{
+			std::ofstream out(outFile.getValue().c_str());
+			if(!out)
+			{
+				throw std::runtime_error(("Cannot open file " + outFile.getValue()).c_str());
+			}
+
+			WriteResults(out, parameters, TotalSize(genome), vertexSize.getValue(), minBranchSize.getValue(), minBlockSize.getValue(), result);
+		}
+		else
+		{
+			WriteResults(std::cout, parameters, TotalSize(genome), vertexSize.getValue(), minBranchSize.getValue(), minBlockSize.getValue(), result);
+		}
+	}
+	catch (TCLAP::ArgException & e)
+	{
+		std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+		return 1;
+	}
+	catch (std::runtime_error & e)
+	{
+		std::cerr << "error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,257 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#include <set>
+#include <vector>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include "../blockcoords.h"
+
+namespace
+{
+	using SyntenyFinder::BlockCoordsFile;
+	typedef boost::uint64_t uint64;
+	const size_t QUERIES = 100000;
+	const size_t HEADER_OFFSET = sizeof(SyntenyFinder::BlockCoords::MAGIC);
+
+	struct Chr
+	{
+		uint64 length;
+		std::string description;
+	};
+
+	//Block id, sequence, strand, 0-based half-open start and end
+	typedef std::pair<std::pair<boost::uint32_t, boost::uint32_t>, std::pair<int, std::pair<uint64, uint64> > > Instance;
+
+	Instance MakeInstance(boost::uint32_t blockId, boost::uint32_t chrId, int strand, uint64 start, uint64 end)
+	{
+		return std::make_pair(std::make_pair(blockId, chrId), std::make_pair(strand, std::make_pair(start, end)));
+	}
+
+	bool Check(bool condition, const std::string & message)
+	{
+		if(!condition)
+		{
+			std::cerr << message << std::endl;
+		}
+
+		return condition;
+	}
+
+	//Reads blocks_coords.txt, coordinates there are 1-based and inclusive, the instances
+	//on the negative strand are written from the end to the start
+	bool ReadText(const std::string & fileName, std::vector<Chr> & chr, std::multiset<Instance> & instance)
+	{
+		std::ifstream in(fileName.c_str());
+		std::string line;
+		std::getline(in, line);
+		while(std::getline(in, line) && line[0] != '-')
+		{
+			std::stringstream ss(line);
+			size_t id;
+			Chr now;
+			ss >> id >> now.length;
+			ss.get();
+			std::getline(ss, now.description);
+			chr.push_back(now);
+		}
+
+		boost::uint32_t blockId = 0;
+		while(std::getline(in, line))
+		{
+			if(line.compare(0, 7, "Block #") == 0)
+			{
+				blockId = static_cast<boost::uint32_t>(atoi(line.c_str() + 7));
+			}
+			else if(!line.empty() && isdigit(line[0]))
+			{
+				std::stringstream ss(line);
+				boost::uint32_t chrId;
+				char strand;
+				uint64 start;
+				uint64 end;
+				ss >> chrId >> strand >> start >> end;
+				if(strand == '-')
+				{
+					std::swap(start, end);
+				}
+
+				instance.insert(MakeInstance(blockId, chrId - 1, strand == '+' ? 1 : -1, start - 1, end));
+			}
+		}
+
+		return Check(!chr.empty() && !instance.empty(), "Cannot read " + fileName);
+	}
+
+	bool CompareWithText(const BlockCoordsFile & file, const std::vector<Chr> & chr, const std::multiset<Instance> & text)
+	{
+		if(!Check(file.GetChrCount() == chr.size() && file.GetStageCount() == 1, "Wrong header"))
+		{
+			return false;
+		}
+
+		for(size_t i = 0; i < chr.size(); i++)
+		{
+			if(!Check(file.GetChrLength(i) == chr[i].length && file.GetChrDescription(i) == chr[i].description, "Wrong sequence"))
+			{
+				return false;
+			}
+		}
+
+		std::multiset<Instance> binary;
+		for(size_t i = 0; i < file.GetInstanceCount(); i++)
+		{
+			BlockCoordsFile::Instance now = file.GetInstance(i);
+			binary.insert(MakeInstance(now.blockId, now.chrId, now.strand, now.start, now.end));
+		}
+
+		return Check(binary == text, "Instances differ from the text file");
+	}
+
+	bool CompareWithScan(const BlockCoordsFile & file)
+	{
+		for(size_t chr = 0; chr < file.GetChrCount(); chr++)
+		{
+			std::pair<size_t, size_t> range = file.GetChrRange(chr);
+			for(size_t i = range.first; i < range.second; i++)
+			{
+				if(!Check(file.GetChrId()[i] == chr && (i == range.first || file.GetStart()[i - 1] <= file.GetStart()[i]), "Instances are not sorted"))
+				{
+					return false;
+				}
+			}
+		}
+
+		for(size_t q = 0; q < QUERIES; q++)
+		{
+			size_t chr = rand() % file.GetChrCount();
+			uint64 length = file.GetChrLength(chr) + 2;
+			uint64 start = (static_cast<uint64>(rand()) * RAND_MAX + rand()) % length;
+			uint64 end = start + (static_cast<uint64>(rand()) * RAND_MAX + rand()) % (q % 2 == 0 ? 1000 : length);
+			std::vector<size_t> expected;
+			std::pair<size_t, size_t> range = file.GetChrRange(chr);
+			for(size_t i = range.first; i < range.second; i++)
+			{
+				if(file.GetStart()[i] < end && file.GetEnd()[i] > start)
+				{
+					expected.push_back(i);
+				}
+			}
+
+			std::vector<size_t> actual;
+			file.FindOverlapping(chr, start, end, std::back_inserter(actual));
+			if(!Check(actual == expected, "FindOverlapping differs from the scan"))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void WriteFile(const std::string & fileName, const std::string & data)
+	{
+		std::ofstream out(fileName.c_str(), std::ios::binary);
+		out.write(data.data(), data.size());
+	}
+
+	void SetWord(std::string & data, size_t offset, uint64 value)
+	{
+		std::copy(reinterpret_cast<const char*>(&value), reinterpret_cast<const char*>(&value) + sizeof(value), data.begin() + offset);
+	}
+
+	bool Rejected(const std::string & fileName, const std::string & data, const std::string & what)
+	{
+		WriteFile(fileName, data);
+		try
+		{
+			BlockCoordsFile file(fileName);
+		}
+		catch(std::runtime_error &)
+		{
+			return true;
+		}
+
+		return Check(false, "Accepted a file with " + what);
+	}
+
+	//Damaged copies of a valid file must be rejected by the constructor
+	bool DamagedFiles(const std::string & fileName, const std::string & dir)
+	{
+		std::ifstream in(fileName.c_str(), std::ios::binary);
+		std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		std::string damagedName = dir + "/damaged.bin";
+		BlockCoordsFile file(fileName);
+		size_t instances = file.GetInstanceCount();
+		size_t chrs = file.GetChrCount();
+		size_t chrIndex = HEADER_OFFSET + (SyntenyFinder::BlockCoords::HEADER_FIELDS + chrs) * sizeof(uint64);
+		size_t nameIndex = chrIndex + (chrs + 1) * sizeof(uint64);
+		bool ret = true;
+		for(size_t size = 0; size < data.size(); size += 1 + size / 4)
+		{
+			ret = Rejected(damagedName, data.substr(0, size), "truncated data") && ret;
+		}
+
+		const uint64 HUGE_COUNT[] = {uint64(1) << 63, ~uint64(0), ~uint64(0) / 3, ~uint64(0) / 37 + 1};
+		for(size_t i = 0; i < sizeof(HUGE_COUNT) / sizeof(HUGE_COUNT[0]); i++)
+		{
+			std::string damaged = data;
+			SetWord(damaged, HEADER_OFFSET + sizeof(uint64), HUGE_COUNT[i]);
+			ret = Rejected(damagedName, damaged, "a huge number of instances") && ret;
+			damaged = data;
+			SetWord(damaged, HEADER_OFFSET + 2 * sizeof(uint64), HUGE_COUNT[i]);
+			ret = Rejected(damagedName, damaged, "a huge number of sequences") && ret;
+		}
+
+		std::string damaged = data;
+		SetWord(damaged, chrIndex + sizeof(uint64), instances + 1);
+		ret = Rejected(damagedName, damaged, "a decreasing sequence index") && ret;
+		damaged = data;
+		SetWord(damaged, chrIndex + chrs * sizeof(uint64), instances - 1);
+		ret = Rejected(damagedName, damaged, "a short sequence index") && ret;
+		damaged = data;
+		SetWord(damaged, nameIndex, 1);
+		ret = Rejected(damagedName, damaged, "a wrong names index") && ret;
+		damaged = data;
+		SetWord(damaged, nameIndex + chrs * sizeof(uint64), ~uint64(0));
+		ret = Rejected(damagedName, damaged, "names out of the file") && ret;
+		return ret;
+	}
+}
+
+//Checks blocks_coords.bin written with --binarycoords against blocks_coords.txt of the same run
+int main(int argc, char * argv[])
+{
+	if(argc != 2)
+	{
+		std::cerr << "Usage: BlockCoordsTest <Sibelia output directory>" << std::endl;
+		return 1;
+	}
+
+	srand(0);
+	std::string dir = argv[1];
+	std::vector<Chr> chr;
+	std::multiset<Instance> text;
+	try
+	{
+		BlockCoordsFile file(dir + "/blocks_coords.bin");
+		if(!ReadText(dir + "/blocks_coords.txt", chr, text) || !CompareWithText(file, chr, text) || !CompareWithScan(file) ||
+			!DamagedFiles(dir + "/blocks_coords.bin", dir))
+		{
+			return 1;
+		}
+	}
+	catch(std::runtime_error & e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	std::cout << "OK" << std::endl;
+	return 0;
+}
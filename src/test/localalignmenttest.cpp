@@ -0,0 +1,166 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#include "../localalignment.h"
+
+namespace
+{
+	const int MATCH = 25;
+	const int MISMATCH = -75;
+	const int GAP = -75;
+	const std::string ALPHABET = "ACGTN";
+
+	char RandomChar(size_t alphabetSize)
+	{
+		return ALPHABET[rand() % alphabetSize];
+	}
+
+	std::string RandomSequence(size_t length, size_t alphabetSize)
+	{
+		std::string ret;
+		for(size_t i = 0; i < length; i++)
+		{
+			ret.push_back(RandomChar(alphabetSize));
+		}
+
+		return ret;
+	}
+
+	//Copy of the sequence with substitutions and short indels, surrounded by random flanks
+	std::string Mutate(const std::string & sequence, size_t rate, size_t alphabetSize)
+	{
+		std::string ret = RandomSequence(rand() % 64, alphabetSize);
+		for(size_t i = 0; i < sequence.size(); i++)
+		{
+			size_t dice = rand() % 1000;
+			if(dice < rate)
+			{
+				ret.push_back(RandomChar(alphabetSize));
+			}
+			else if(dice < rate + rate / 4)
+			{
+				ret += RandomSequence(rand() % 4 + 1, alphabetSize);
+			}
+			else if(dice >= rate + rate / 2)
+			{
+				ret.push_back(sequence[i]);
+			}
+		}
+
+		return ret + RandomSequence(rand() % 64, alphabetSize);
+	}
+
+	void RandomPair(size_t maxLength, std::string & sequence1, std::string & sequence2)
+	{
+		size_t alphabetSize = rand() % 2 == 0 ? 4 : ALPHABET.size() - rand() % 3;
+		sequence1 = RandomSequence(rand() % (maxLength + 1), alphabetSize);
+		switch(rand() % 4)
+		{
+		case 0:
+			sequence2 = RandomSequence(rand() % (maxLength + 1), alphabetSize);
+			break;
+		case 1:
+			sequence2 = sequence1;
+			break;
+		default:
+			sequence2 = Mutate(sequence1, rand() % 300, alphabetSize);
+		}
+	}
+
+	bool Check(const std::string & sequence1, const std::string & sequence2)
+	{
+		std::pair<size_t, size_t> expected[2];
+		std::pair<size_t, size_t> actual[2];
+		SyntenyFinder::SeqanLocalAlignment(sequence1, sequence2, MATCH, MISMATCH, GAP, expected[0], expected[1]);
+		SyntenyFinder::StripedLocalAlignment(sequence1, sequence2, MATCH, MISMATCH, GAP, actual[0], actual[1]);
+		if(expected[0] != actual[0] || expected[1] != actual[1])
+		{
+			std::cerr << "Mismatch on " << sequence1 << " " << sequence2 << std::endl;
+			std::cerr << "Expected: " << expected[0].first << " " << expected[0].second << " " << expected[1].first << " " << expected[1].second << std::endl;
+			std::cerr << "Actual: " << actual[0].first << " " << actual[0].second << " " << actual[1].first << " " << actual[1].second << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+
+	bool EquivalenceTest()
+	{
+		const char * fixed[][2] =
+		{
+			{"", ""}, {"", "ACGT"}, {"ACGT", ""}, {"A", "A"}, {"A", "C"}, {"AAAA", "CCCC"},
+			{"ACGTACGT", "ACGTACGT"}, {"ACGTTACGT", "ACGTACGT"}, {"NNNN", "NNNN"}, {"ACACACAC", "CACACACA"}
+		};
+
+		for(size_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++)
+		{
+			if(!Check(fixed[i][0], fixed[i][1]))
+			{
+				return false;
+			}
+		}
+
+		std::string sequence1;
+		std::string sequence2;
+		for(size_t i = 0; i < 3000; i++)
+		{
+			RandomPair(i < 2980 ? 100 : 2048, sequence1, sequence2);
+			if(!Check(sequence1, sequence2))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void Benchmark()
+	{
+		std::vector<std::pair<std::string, std::string> > pair(20);
+		for(size_t i = 0; i < pair.size(); i++)
+		{
+			pair[i].first = RandomSequence(2048, 4);
+			pair[i].second = Mutate(pair[i].first, 20, 4);
+		}
+
+		std::pair<size_t, size_t> coord[2];
+		clock_t start = clock();
+		for(size_t i = 0; i < pair.size(); i++)
+		{
+			SyntenyFinder::SeqanLocalAlignment(pair[i].first, pair[i].second, MATCH, MISMATCH, GAP, coord[0], coord[1]);
+		}
+
+		double seqanTime = double(clock() - start) / CLOCKS_PER_SEC;
+		start = clock();
+		for(size_t i = 0; i < pair.size(); i++)
+		{
+			SyntenyFinder::StripedLocalAlignment(pair[i].first, pair[i].second, MATCH, MISMATCH, GAP, coord[0], coord[1]);
+		}
+
+		double stripedTime = double(clock() - start) / CLOCKS_PER_SEC;
+		std::cout << "Aligned " << pair.size() << " pairs of 2048 bp" << std::endl;
+		std::cout << "seqan:   " << seqanTime << " s" << std::endl;
+		std::cout << "striped: " << stripedTime << " s" << std::endl;
+	}
+}
+
+int main(int argc, char * argv[])
+{
+	srand(0);
+	if(argc > 1 && std::string(argv[1]) == "--benchmark")
+	{
+		Benchmark();
+		return 0;
+	}
+
+	if(!EquivalenceTest())
+	{
+		return 1;
+	}
+
+	std::cout << "OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,283 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#include "../postprocessor.h"
+
+namespace
+{
+	using SyntenyFinder::Abs;
+	using SyntenyFinder::BlockInstance;
+	using SyntenyFinder::FASTARecord;
+	const size_t MAX_CHR = 3;
+	const size_t MAX_WORD = 6;
+	const size_t MAX_PIECES = 12;
+	const int MAX_RANDOM_ID = 8;
+	const size_t MAX_LENGTH = 50;
+
+	struct Stripe
+	{
+		int firstBlock;
+		int secondBlock;
+		Stripe() {}
+		Stripe(int firstBlock, int secondBlock): firstBlock(firstBlock), secondBlock(secondBlock) {}
+		bool operator < (const Stripe & toCompare) const
+		{
+			return firstBlock < toCompare.firstBlock;
+		}
+	};
+
+	//The algorithm GlueStripes used before it became incremental: the stripes are
+	//rebuilt and rescanned after every glue
+	void RescanGlueStripes(const std::vector<FASTARecord> & chr, std::vector<BlockInstance> & block)
+	{
+		std::vector<std::vector<BlockInstance> > perm(chr.size());
+		for(size_t i = 0; i < block.size(); i++)
+		{
+			perm[block[i].GetChrId()].push_back(block[i]);
+		}
+
+		for(size_t i = 0; i < perm.size(); i++)
+		{
+			std::sort(perm[i].begin(), perm[i].end(), SyntenyFinder::compareByStart);
+		}
+
+		int sentinel = INT_MAX >> 1;
+		bool glue = false;
+		do
+		{
+			std::vector<Stripe> stripe;
+			for(size_t chr = 0; chr < perm.size(); chr++)
+			{
+				for(size_t i = 0; i < perm[chr].size(); i++)
+				{
+					int bid = perm[chr][i].GetSignedBlockId();
+					if(bid > 0)
+					{
+						int nextBid = i < perm[chr].size() - 1 ? perm[chr][i + 1].GetSignedBlockId() : sentinel;
+						stripe.push_back(Stripe(bid, nextBid));
+					}
+					else
+					{
+						int prevBid = i > 0 ? perm[chr][i - 1].GetSignedBlockId() : -sentinel;
+						stripe.push_back(Stripe(-bid, -prevBid));
+					}
+				}
+			}
+
+			size_t now = 0;
+			size_t next = 0;
+			std::sort(stripe.begin(), stripe.end());
+			for(; now < stripe.size(); now = next)
+			{
+				glue = true;
+				for(; next < stripe.size() && stripe[next].firstBlock == stripe[now].firstBlock; next++)
+				{
+					if(stripe[next].secondBlock != stripe[now].secondBlock || stripe[next].secondBlock == sentinel || Abs(stripe[next].secondBlock) == stripe[next].firstBlock)
+					{
+						glue = false;
+					}
+				}
+
+				if(glue)
+				{
+					typedef std::vector<Stripe>::iterator It;
+					std::pair<It, It> range = std::equal_range(stripe.begin(), stripe.end(), Stripe(Abs(stripe[now].secondBlock), 0));
+					if(range.second - range.first != next - now)
+					{
+						glue = false;
+					}
+					else
+					{
+						break;
+					}
+				}
+			}
+
+			if(glue)
+			{
+				int glueBid = stripe[now].firstBlock;
+				for(size_t chr = 0; chr < perm.size(); chr++)
+				{
+					for(size_t i = 0; i < perm[chr].size(); i++)
+					{
+						int bid = perm[chr][i].GetBlockId();
+						if(bid == glueBid)
+						{
+							bid = perm[chr][i].GetSignedBlockId();
+							if(bid > 0)
+							{
+								BlockInstance & a = perm[chr][i];
+								BlockInstance & b = perm[chr][i + 1];
+								a = BlockInstance(a.GetSignedBlockId(), &a.GetChrInstance(), a.GetStart(), b.GetEnd());
+								perm[chr].erase(perm[chr].begin() + i + 1);
+							}
+							else
+							{
+								BlockInstance & a = perm[chr][--i];
+								BlockInstance & b = perm[chr][i + 1];
+								a = BlockInstance(b.GetSignedBlockId(), &a.GetChrInstance(), a.GetStart(), b.GetEnd());
+								perm[chr].erase(perm[chr].begin() + i + 1);
+							}
+						}
+					}
+				}
+			}
+		}
+		while(glue);
+
+		block.clear();
+		std::vector<int> oldId;
+		for(size_t chr = 0; chr < perm.size(); chr++)
+		{
+			for(size_t i = 0; i < perm[chr].size(); i++)
+			{
+				block.push_back(perm[chr][i]);
+				oldId.push_back(perm[chr][i].GetBlockId());
+			}
+		}
+
+		std::sort(oldId.begin(), oldId.end());
+		oldId.erase(std::unique(oldId.begin(), oldId.end()), oldId.end());
+		for(std::vector<BlockInstance>::iterator it = block.begin(); it != block.end(); ++it)
+		{
+			int sign = it->GetSignedBlockId() > 0 ? +1 : -1;
+			size_t newId = std::lower_bound(oldId.begin(), oldId.end(), it->GetBlockId()) - oldId.begin() + 1;
+			*it = BlockInstance(static_cast<int>(newId) * sign, &it->GetChrInstance(), it->GetStart(), it->GetEnd());
+		}
+	}
+
+	std::vector<int> RandomWord(int firstId)
+	{
+		std::vector<int> ret(rand() % MAX_WORD + 1);
+		for(size_t i = 0; i < ret.size(); i++)
+		{
+			ret[i] = (firstId + static_cast<int>(i)) * (rand() % 2 == 0 ? 1 : -1);
+		}
+
+		return ret;
+	}
+
+	//Sequences made of copies of a few words of blocks, some of them reversed, and of
+	//random blocks between them, so that stripes are common but not everywhere
+	void RandomLayout(std::vector<FASTARecord> & chr, std::vector<BlockInstance> & block)
+	{
+		std::vector<std::vector<int> > word;
+		int nextId = MAX_RANDOM_ID + 1;
+		for(size_t i = rand() % 3 + 1; i > 0; i--)
+		{
+			word.push_back(RandomWord(nextId));
+			nextId += static_cast<int>(word.back().size());
+		}
+
+		std::vector<std::vector<int> > order(rand() % MAX_CHR + 1);
+		for(size_t i = 0; i < order.size(); i++)
+		{
+			for(size_t piece = rand() % MAX_PIECES; piece > 0; piece--)
+			{
+				if(rand() % 3 == 0)
+				{
+					order[i].push_back((rand() % MAX_RANDOM_ID + 1) * (rand() % 2 == 0 ? 1 : -1));
+				}
+				else
+				{
+					std::vector<int> now = word[rand() % word.size()];
+					if(rand() % 2 == 0)
+					{
+						std::reverse(now.begin(), now.end());
+						std::transform(now.begin(), now.end(), now.begin(), std::negate<int>());
+					}
+
+					order[i].insert(order[i].end(), now.begin(), now.end());
+				}
+			}
+		}
+
+		chr.clear();
+		for(size_t i = 0; i < order.size(); i++)
+		{
+			chr.push_back(FASTARecord(std::string(order[i].size() * MAX_LENGTH * 2, 'A'), "chr", i));
+		}
+
+		block.clear();
+		for(size_t i = 0; i < order.size(); i++)
+		{
+			size_t start = rand() % MAX_LENGTH;
+			for(size_t j = 0; j < order[i].size(); j++)
+			{
+				size_t end = start + rand() % MAX_LENGTH + 1;
+				block.push_back(BlockInstance(order[i][j], &chr[i], start, end));
+				start = end + rand() % MAX_LENGTH;
+			}
+		}
+
+		for(size_t i = block.size(); i > 1; i--)
+		{
+			std::swap(block[i - 1], block[rand() % i]);
+		}
+	}
+
+	bool Same(const BlockInstance & a, const BlockInstance & b)
+	{
+		return a.GetSignedBlockId() == b.GetSignedBlockId() && a.GetChrId() == b.GetChrId() && a.GetStart() == b.GetStart() && a.GetEnd() == b.GetEnd();
+	}
+
+	void Print(const char * title, const std::vector<BlockInstance> & block)
+	{
+		std::cerr << title << ":";
+		for(size_t i = 0; i < block.size(); i++)
+		{
+			std::cerr << " " << block[i].GetSignedBlockId() << "@" << block[i].GetChrId() << ":" << block[i].GetStart() << "-" << block[i].GetEnd();
+		}
+
+		std::cerr << std::endl;
+	}
+
+	bool EquivalenceTest()
+	{
+		size_t glued = 0;
+		std::vector<FASTARecord> chr;
+		std::vector<BlockInstance> input;
+		for(size_t i = 0; i < 20000; i++)
+		{
+			RandomLayout(chr, input);
+			std::vector<BlockInstance> expected(input);
+			std::vector<BlockInstance> actual(input);
+			RescanGlueStripes(chr, expected);
+			SyntenyFinder::Postprocessor processor(chr, 0);
+			processor.GlueStripes(actual);
+			if(expected.size() != actual.size() || !std::equal(expected.begin(), expected.end(), actual.begin(), Same))
+			{
+				Print("Input", input);
+				Print("Expected", expected);
+				Print("Actual", actual);
+				return false;
+			}
+
+			glued += input.size() - expected.size();
+		}
+
+		//Makes sure the layouts exercise gluing at all
+		if(glued == 0)
+		{
+			std::cerr << "No stripes were glued" << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+}
+
+int main()
+{
+	srand(0);
+	if(!EquivalenceTest())
+	{
+		return 1;
+	}
+
+	std::cout << "OK" << std::endl;
+	return 0;
+}
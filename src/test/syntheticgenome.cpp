@@ -0,0 +1,185 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#include "syntheticgenome.h"
+
+namespace SyntenyFinder
+{
+	namespace
+	{
+		const std::string BASE = "ACGT";
+		const std::string COMPLEMENT = "TGCA";
+		const size_t LINE_LENGTH = 80;
+
+		char Complement(char ch)
+		{
+			size_t pos = BASE.find(ch);
+			return pos == std::string::npos ? ch : COMPLEMENT[pos];
+		}
+	}
+
+	SyntheticGenomeParameters::SyntheticGenomeParameters(): seed(1), genomes(3), length(500000), repeatFamilies(10), repeatCopies(5),
+		repeatLength(1000), repeatDivergence(10), inversions(5), translocations(5), maxEventLength(20000), indels(200), maxIndelLength(10),
+		mutationRate(5), nRuns(3), maxNRunLength(100)
+	{
+	}
+
+	SyntheticGenomeGenerator::SyntheticGenomeGenerator(const SyntheticGenomeParameters & parameters): parameters_(parameters), state_(parameters.seed)
+	{
+	}
+
+	//SplitMix64, unlike rand() it gives the same numbers everywhere
+	uint64_t SyntheticGenomeGenerator::Random()
+	{
+		uint64_t ret = (state_ += 0x9E3779B97F4A7C15ULL);
+		ret = (ret ^ (ret >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		ret = (ret ^ (ret >> 27)) * 0x94D049BB133111EBULL;
+		return ret ^ (ret >> 31);
+	}
+
+	size_t SyntheticGenomeGenerator::Random(size_t bound)
+	{
+		return bound == 0 ? 0 : static_cast<size_t>(Random() % bound);
+	}
+
+	char SyntheticGenomeGenerator::RandomBase()
+	{
+		return BASE[Random(BASE.size())];
+	}
+
+	std::string SyntheticGenomeGenerator::RandomSequence(size_t length)
+	{
+		std::string ret(length, 'A');
+		for(size_t i = 0; i < length; i++)
+		{
+			ret[i] = RandomBase();
+		}
+
+		return ret;
+	}
+
+	void SyntheticGenomeGenerator::Mutate(std::string & sequence, size_t rate)
+	{
+		for(size_t i = 0; i < sequence.size(); i++)
+		{
+			if(Random(1000) < rate)
+			{
+				sequence[i] = BASE[(BASE.find(sequence[i]) + 1 + Random(BASE.size() - 1)) % BASE.size()];
+			}
+		}
+	}
+
+	void SyntheticGenomeGenerator::Invert(std::string & sequence)
+	{
+		size_t length = 1 + Random(std::min(parameters_.maxEventLength, sequence.size() / 2));
+		size_t start = Random(sequence.size() - length + 1);
+		std::string::iterator begin = sequence.begin() + start;
+		std::reverse(begin, begin + length);
+		std::transform(begin, begin + length, begin, Complement);
+	}
+
+	void SyntheticGenomeGenerator::Translocate(std::string & sequence)
+	{
+		size_t length = 1 + Random(std::min(parameters_.maxEventLength, sequence.size() / 2));
+		size_t start = Random(sequence.size() - length + 1);
+		std::string segment = sequence.substr(start, length);
+		sequence.erase(start, length);
+		sequence.insert(Random(sequence.size() + 1), segment);
+	}
+
+	void SyntheticGenomeGenerator::Indel(std::string & sequence)
+	{
+		size_t length = 1 + Random(std::min(parameters_.maxIndelLength, sequence.size() / 2));
+		if(Random(2) == 0)
+		{
+			sequence.erase(Random(sequence.size() - length + 1), length);
+		}
+		else
+		{
+			sequence.insert(Random(sequence.size() + 1), RandomSequence(length));
+		}
+	}
+
+	void SyntheticGenomeGenerator::AddNRun(std::string & sequence)
+	{
+		size_t length = 1 + Random(std::min(parameters_.maxNRunLength, sequence.size() / 2));
+		sequence.replace(Random(sequence.size() - length + 1), length, length, 'N');
+	}
+
+	void SyntheticGenomeGenerator::Generate(std::vector<FASTARecord> & genome)
+	{
+		state_ = parameters_.seed;
+		std::string ancestor = RandomSequence(parameters_.length);
+		for(size_t family = 0; family < parameters_.repeatFamilies; family++)
+		{
+			std::string unit = RandomSequence(parameters_.repeatLength);
+			for(size_t copy = 0; copy < parameters_.repeatCopies; copy++)
+			{
+				std::string now = unit;
+				Mutate(now, parameters_.repeatDivergence);
+				ancestor.insert(Random(ancestor.size() + 1), now);
+			}
+		}
+
+		genome.clear();
+		for(size_t i = 0; i < parameters_.genomes; i++)
+		{
+			std::string now = ancestor;
+			if(i > 0 && now.size() > 1)
+			{
+				for(size_t j = 0; j < parameters_.inversions; j++)
+				{
+					Invert(now);
+				}
+
+				for(size_t j = 0; j < parameters_.translocations; j++)
+				{
+					Translocate(now);
+				}
+
+				for(size_t j = 0; j < parameters_.indels; j++)
+				{
+					Indel(now);
+				}
+
+				Mutate(now, parameters_.mutationRate);
+			}
+
+			for(size_t j = 0; j < parameters_.nRuns && now.size() > 1; j++)
+			{
+				AddNRun(now);
+			}
+
+			std::stringstream description;
+			description << "synthetic_" << i + 1 << " seed=" << parameters_.seed;
+			genome.push_back(FASTARecord(now, description.str(), i));
+		}
+	}
+
+	void SyntheticGenomeGenerator::WriteFASTA(const std::string & fileName, const std::vector<FASTARecord> & genome)
+	{
+		std::ofstream out(fileName.c_str());
+		if(!out)
+		{
+			throw std::runtime_error(("Cannot open file " + fileName).c_str());
+		}
+
+		for(size_t i = 0; i < genome.size(); i++)
+		{
+			const std::string & sequence = genome[i].GetSequence();
+			out << ">" << genome[i].GetDescription() << std::endl;
+			for(size_t j = 0; j < sequence.size(); j += LINE_LENGTH)
+			{
+				out << sequence.substr(j, LINE_LENGTH) << std::endl;
+			}
+		}
+
+		if(!out)
+		{
+			throw std::runtime_error(("Error while writing to " + fileName).c_str());
+		}
+	}
+}
@@ -0,0 +1,61 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#ifndef _SYNTHETIC_GENOME_H_
+#define _SYNTHETIC_GENOME_H_
+
+#include "../fasta.h"
+
+namespace SyntenyFinder
+{
+	//Genomes evolved from a common random ancestor. The ancestor gets copies of repeat
+	//families, then every genome except the first one gets rearrangements, indels and
+	//substitutions of its own. All genomes get runs of N. Counts are per genome, rates
+	//are per thousand bases
+	struct SyntheticGenomeParameters
+	{
+		SyntheticGenomeParameters();
+		uint64_t seed;
+		size_t genomes;
+		size_t length;
+		size_t repeatFamilies;
+		size_t repeatCopies;
+		size_t repeatLength;
+		size_t repeatDivergence;
+		size_t inversions;
+		size_t translocations;
+		size_t maxEventLength;
+		size_t indels;
+		size_t maxIndelLength;
+		size_t mutationRate;
+		size_t nRuns;
+		size_t maxNRunLength;
+	};
+
+	//The same parameters always give the same genomes, on any platform
+	class SyntheticGenomeGenerator
+	{
+	public:
+		explicit SyntheticGenomeGenerator(const SyntheticGenomeParameters & parameters);
+		void Generate(std::vector<FASTARecord> & genome);
+		static void WriteFASTA(const std::string & fileName, const std::vector<FASTARecord> & genome);
+	private:
+		DISALLOW_COPY_AND_ASSIGN(SyntheticGenomeGenerator);
+		SyntheticGenomeParameters parameters_;
+		uint64_t state_;
+		uint64_t Random();
+		size_t Random(size_t bound);
+		char RandomBase();
+		std::string RandomSequence(size_t length);
+		void Mutate(std::string & sequence, size_t rate);
+		void Invert(std::string & sequence);
+		void Translocate(std::string & sequence);
+		void Indel(std::string & sequence);
+		void AddNRun(std::string & sequence);
+	};
+}
+
+#endif
@@ -110,6 +110,88 @@ void PutProgressChr(size_t progress, SyntenyFinder::BlockFinder::State state)
 	}
 }
 
+//Runs independent tasks on the OpenMP threads, the first error is rethrown after all of them finish
+void RunConcurrently(const std::vector<boost::function<void()> > & task)
+{
+	std::string error;
+	#pragma omp parallel for schedule(dynamic)
+	for(int i = 0; i < static_cast<int>(task.size()); i++)
+	{
+		try
+		{
+			task[i]();
+		}
+		catch(std::exception & e)
+		{
+			#pragma omp critical
+			{
+				if(error.empty())
+				{
+					error = e.what();
+				}
+			}
+		}
+		catch(...)
+		{
+			#pragma omp critical
+			{
+				if(error.empty())
+				{
+					error = "unknown error";
+				}
+			}
+		}
+	}
+
+	if(!error.empty())
+	{
+		throw std::runtime_error(error.c_str());
+	}
+}
+
+ProgressStream::ProgressStream(const std::string & target): start_(SyntenyFinder::GetWallClock())
+{
+	bool descriptor = !target.empty() && target.find_first_not_of("0123456789") == std::string::npos;
+#ifdef _WIN32
+	handle_ = descriptor ? _fdopen(atoi(target.c_str()), "w") : fopen(target.c_str(), "w");
+#else
+	signal(SIGPIPE, SIG_IGN);
+	handle_ = descriptor ? fdopen(atoi(target.c_str()), "w") : fopen(target.c_str(), "w");
+#endif
+	if(handle_ == 0)
+	{
+		throw std::runtime_error(("Cannot open progress stream " + target).c_str());
+	}
+}
+
+ProgressStream::~ProgressStream()
+{
+	if(handle_ != 0)
+	{
+		fclose(handle_);
+	}
+}
+
+void ProgressStream::Report(const SyntenyFinder::BlockFinder::Progress & progress)
+{
+	if(handle_ == 0)
+	{
+		return;
+	}
+
+	const char * stateName[] = {"start", "run", "end"};
+	std::stringstream ss;
+	ss.setf(std::ios::fixed);
+	ss.precision(3);
+	ss << "{\"time\": " << SyntenyFinder::GetWallClock() - start_ << ", \"phase\": \"" << progress.phase << "\", \"state\": \"" << stateName[progress.state]
+		<< "\", \"k\": " << progress.k << ", \"done\": " << progress.done << ", \"total\": " << progress.total << ", \"found\": " << progress.found
+		<< ", \"seconds\": " << progress.seconds << ", \"throughput\": " << (progress.seconds > 0 ? progress.done / progress.seconds : 0) << "}\n";
+	if(fputs(ss.str().c_str(), handle_) < 0 || fflush(handle_) != 0)
+	{
+		fclose(handle_);
+		handle_ = 0;
+	}
+}
 
 void SignalHandler(int sig)
 {
@@ -16,5 +16,21 @@ std::vector<std::pair<int, int> > FineStageFile();
 std::vector<std::pair<int, int> > LooseStageFile();
 std::vector<std::pair<int, int> > ReadStageFile(const std::string & fileName);
 void PutProgressChr(size_t progress, SyntenyFinder::BlockFinder::State state);
+void RunConcurrently(const std::vector<boost::function<void()> > & task);
+
+//Writes the progress reported by BlockFinder as lines of JSON to a file descriptor,
+//if the target is a number, or to a file, e.g. a named pipe. If the reader goes
+//away the reports stop, but the run goes on
+class ProgressStream
+{
+public:
+	explicit ProgressStream(const std::string & target);
+	~ProgressStream();
+	void Report(const SyntenyFinder::BlockFinder::Progress & progress);
+private:
+	DISALLOW_COPY_AND_ASSIGN(ProgressStream);
+	FILE * handle_;
+	double start_;
+};
 
 #endif
@@ -0,0 +1,287 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#include "variantcaller.h"
+#include "sequencewriter.h"
+
+namespace SyntenyFinder
+{
+	namespace
+	{
+		struct Segment
+		{
+			size_t start;
+			size_t end;
+			bool match;
+			Segment(size_t start, size_t end, bool match): start(start), end(end), match(match) {}
+		};
+
+		std::string NoGaps(const std::string & row, size_t start, size_t end)
+		{
+			std::string ret;
+			for(size_t i = start; i < end; i++)
+			{
+				if(row[i] != '-')
+				{
+					ret.push_back(row[i]);
+				}
+			}
+
+			return ret;
+		}
+
+		std::string Complementary(const std::string & str)
+		{
+			std::string ret(str);
+			ReverseComplement(str.data(), str.data() + str.size(), &ret[0]);
+			return ret;
+		}
+
+		class VariantOrder
+		{
+		public:
+			VariantOrder(const std::vector<FASTARecord> & chrList): chrList_(chrList) {}
+			bool operator()(const VariantCaller::Variant & a, const VariantCaller::Variant & b) const
+			{
+				const std::string & chrA = chrList_[a.chr].GetDescription();
+				const std::string & chrB = chrList_[b.chr].GetDescription();
+				return chrA != chrB ? chrA < chrB : a.pos < b.pos;
+			}
+
+		private:
+			const std::vector<FASTARecord> & chrList_;
+		};
+	}
+
+	const size_t VariantCaller::MINIMUM_CONTEXT_SIZE = 30;
+
+	VariantCaller::VariantCaller(const std::vector<FASTARecord> & chrList, const std::set<size_t> & referenceChrId, size_t minBlockSize):
+		chrList_(chrList), referenceChrId_(referenceChrId), minBlockSize_(minBlockSize)
+	{
+	}
+
+	bool VariantCaller::IsReference(const BlockInstance & instance) const
+	{
+		return referenceChrId_.count(instance.GetChrId()) > 0;
+	}
+
+	bool VariantCaller::IsUnique(const BlockList & instance) const
+	{
+		return instance.size() == 2 && IsReference(instance[0]) != IsReference(instance[1]) &&
+			instance[0].GetLength() >= minBlockSize_ && instance[1].GetLength() >= minBlockSize_;
+	}
+
+	VariantCaller::Variant VariantCaller::MakeVariant(size_t chr, long pos, const std::string & referenceAllele, const std::string & assemblyAllele) const
+	{
+		Variant ret;
+		ret.chr = chr;
+		ret.pos = pos;
+		ret.contig = ret.contigPos = 0;
+		ret.referenceAllele = referenceAllele;
+		ret.assemblyAllele = assemblyAllele;
+		return ret;
+	}
+
+	void VariantCaller::AddAlignment(const BlockAligner::Block & block, const BlockAligner::Alignment & alignment)
+	{
+		if(!block.pairwise || alignment.row[0].empty())
+		{
+			return;
+		}
+
+		//Runs of matches shorter than the context are merged into the surrounding mismatches
+		const BlockInstance & reference = block.instance[0];
+		const std::string & referenceRow = alignment.row[alignment.order[0] == 0 ? 0 : 1];
+		const std::string & assemblyRow = alignment.row[alignment.order[0] == 0 ? 1 : 0];
+		std::vector<Segment> segment;
+		size_t runStart = 0;
+		bool lastMatch = referenceRow[0] == assemblyRow[0];
+		for(size_t now = 1; now < referenceRow.size(); now++)
+		{
+			bool nowMatch = referenceRow[now] == assemblyRow[now];
+			if(nowMatch != lastMatch)
+			{
+				if(!lastMatch || now - runStart >= MINIMUM_CONTEXT_SIZE || runStart == 0)
+				{
+					segment.push_back(Segment(runStart, now, lastMatch));
+					runStart = now;
+				}
+				else if(!segment.empty())
+				{
+					runStart = segment.back().start;
+					segment.pop_back();
+				}
+
+				lastMatch = nowMatch;
+			}
+		}
+
+		segment.push_back(Segment(runStart, referenceRow.size(), lastMatch));
+		bool positive = reference.GetDirection() == DNASequence::positive;
+		long direction = positive ? +1 : -1;
+		long position = static_cast<long>(reference.GetConventionalStart());
+		for(size_t i = 0, column = 0; i < segment.size(); i++)
+		{
+			for(; column < segment[i].start; column++)
+			{
+				position += referenceRow[column] != '-' ? direction : 0;
+			}
+
+			if(!segment[i].match)
+			{
+				//An indel is reported with the preceding base, like VCF requires
+				size_t start = segment[i].start;
+				size_t end = segment[i].end;
+				bool snp = end - start == 1 && referenceRow[start] != '-' && assemblyRow[start] != '-';
+				size_t shift = start == 0 || snp ? 0 : 1;
+				std::string referenceAllele = NoGaps(referenceRow, start - shift, end);
+				std::string assemblyAllele = NoGaps(assemblyRow, start - shift, end);
+				if(!positive)
+				{
+					referenceAllele = Complementary(referenceAllele);
+					assemblyAllele = Complementary(assemblyAllele);
+				}
+
+				variant_.push_back(MakeVariant(reference.GetChrId(), position - static_cast<long>(shift), referenceAllele, assemblyAllele));
+			}
+		}
+	}
+
+	void VariantCaller::SharedBlocks(const BlockList & blockList, BlockList & shared, std::vector<IndexPair> & group) const
+	{
+		std::vector<IndexPair> all;
+		shared = blockList;
+		GroupBy(shared, compareById, std::back_inserter(all));
+		for(size_t i = 0; i < all.size(); i++)
+		{
+			size_t inReference = 0;
+			for(size_t j = all[i].first; j < all[i].second; j++)
+			{
+				inReference += IsReference(shared[j]) ? 1 : 0;
+			}
+
+			if(inReference > 0 && inReference < all[i].second - all[i].first)
+			{
+				group.push_back(all[i]);
+			}
+		}
+	}
+
+	void VariantCaller::CallIndels(const std::vector<BlockList> & history)
+	{
+		//Only blocks present both in the reference and in the assembly cover the sequences
+		std::vector<std::vector<IndexPair> > covered(chrList_.size());
+		for(size_t i = 0; i < history.size(); i++)
+		{
+			BlockList shared;
+			std::vector<IndexPair> group;
+			SharedBlocks(history[i], shared, group);
+			for(size_t j = 0; j < group.size(); j++)
+			{
+				for(size_t k = group[j].first; k < group[j].second; k++)
+				{
+					covered[shared[k].GetChrId()].push_back(IndexPair(shared[k].GetStart(), shared[k].GetEnd()));
+				}
+			}
+		}
+
+		BlockList last;
+		std::vector<IndexPair> lastGroup;
+		if(!history.empty())
+		{
+			SharedBlocks(history.back(), last, lastGroup);
+		}
+
+		for(size_t chr = 0; chr < chrList_.size(); chr++)
+		{
+			const std::string & sequence = chrList_[chr].GetSequence();
+			std::sort(covered[chr].begin(), covered[chr].end());
+			covered[chr].push_back(IndexPair(sequence.size(), sequence.size()));
+			for(size_t i = 0, start = 0; i < covered[chr].size(); start = std::max(start, covered[chr][i++].second))
+			{
+				size_t end = covered[chr][i].first;
+				if(end <= start || end - start <= minBlockSize_)
+				{
+					continue;
+				}
+
+				std::string allele = sequence.substr(start, end - start);
+				if(referenceChrId_.count(chr) > 0)
+				{
+					std::string common = start > 0 ? sequence.substr(start - 1, 1) : "";
+					variant_.push_back(MakeVariant(chr, static_cast<long>(start), common + allele, common.empty() ? "." : common));
+					continue;
+				}
+
+				//An insertion right after a unique block is placed after its reference instance.
+				//If several blocks cover the preceding base, the one with the largest id is taken
+				size_t prevGroup = lastGroup.size();
+				for(size_t j = 0; j < lastGroup.size() && start > 0; j++)
+				{
+					for(size_t k = lastGroup[j].first; k < lastGroup[j].second; k++)
+					{
+						if(last[k].GetChrId() == chr && last[k].GetStart() < start && last[k].GetEnd() >= start)
+						{
+							prevGroup = j;
+						}
+					}
+				}
+
+				if(prevGroup < lastGroup.size())
+				{
+					BlockList instance(last.begin() + lastGroup[prevGroup].first, last.begin() + lastGroup[prevGroup].second);
+					if(IsUnique(instance))
+					{
+						const BlockInstance & reference = IsReference(instance[0]) ? instance[0] : instance[1];
+						const BlockInstance & assembly = IsReference(instance[0]) ? instance[1] : instance[0];
+						size_t pos = reference.GetDirection() == assembly.GetDirection() ? reference.GetEnd() : reference.GetStart();
+						if(pos > 0)
+						{
+							std::string common = reference.GetChrInstance().GetSequence().substr(pos - 1, 1);
+							variant_.push_back(MakeVariant(reference.GetChrId(), static_cast<long>(pos), common, common + allele));
+							continue;
+						}
+					}
+				}
+
+				Variant insertion = MakeVariant(0, 0, ".", allele);
+				insertion.contig = chr;
+				insertion.contigPos = start;
+				insertion_.push_back(insertion);
+			}
+		}
+
+		std::stable_sort(variant_.begin(), variant_.end(), VariantOrder(chrList_));
+	}
+
+	const std::vector<VariantCaller::Variant> & VariantCaller::GetVariants() const
+	{
+		return variant_;
+	}
+
+	const std::vector<VariantCaller::Variant> & VariantCaller::GetUnmappedInsertions() const
+	{
+		return insertion_;
+	}
+
+	std::string VariantCaller::StripChrId(const std::string & description)
+	{
+		std::vector<std::string> part;
+		for(size_t start = 0; ; )
+		{
+			size_t end = description.find('|', start);
+			part.push_back(description.substr(start, end == std::string::npos ? std::string::npos : end - start));
+			if(end == std::string::npos)
+			{
+				break;
+			}
+
+			start = end + 1;
+		}
+
+		return part.size() == 5 ? part[3].substr(0, part[3].find('.')) : description;
+	}
+}
@@ -0,0 +1,58 @@
+//****************************************************************************
+//* Copyright (c) 2012 Saint-Petersburg Academic University
+//* All Rights Reserved
+//* See file LICENSE for details.
+//****************************************************************************
+
+#ifndef _VARIANT_CALLER_H_
+#define _VARIANT_CALLER_H_
+
+#include "blockaligner.h"
+
+namespace SyntenyFinder
+{
+	//Calls variants of an assembly against a reference like C-Sibelia does. Small variants
+	//come from the alignments of the pairwise blocks, long regions not covered by the blocks
+	//of any stage are deletions (in the reference) or insertions (in the assembly)
+	class VariantCaller
+	{
+	public:
+		//Alleles are "." where C-Sibelia has none. Unmapped insertions have no reference
+		//position, they are located by the contig and the position in it instead
+		struct Variant
+		{
+			size_t chr;
+			long pos;
+			size_t contig;
+			size_t contigPos;
+			std::string referenceAllele;
+			std::string assemblyAllele;
+		};
+
+		VariantCaller(const std::vector<FASTARecord> & chrList, const std::set<size_t> & referenceChrId, size_t minBlockSize);
+		//Consumer for BlockAligner, blocks must be passed in the order of their ids
+		void AddAlignment(const BlockAligner::Block & block, const BlockAligner::Alignment & alignment);
+		//Must be called after all alignments are added, the last stage of the history is the final one
+		void CallIndels(const std::vector<std::vector<BlockInstance> > & history);
+		//Sorted by the reference chromosome and position
+		const std::vector<Variant> & GetVariants() const;
+		const std::vector<Variant> & GetUnmappedInsertions() const;
+		//Id of a chromosome used in VCF, the accession for NCBI style "gi|...|ref|NC_xxx.1|"
+		static std::string StripChrId(const std::string & description);
+	private:
+		DISALLOW_COPY_AND_ASSIGN(VariantCaller);
+		static const size_t MINIMUM_CONTEXT_SIZE;
+		typedef std::vector<BlockInstance> BlockList;
+		const std::vector<FASTARecord> & chrList_;
+		const std::set<size_t> & referenceChrId_;
+		size_t minBlockSize_;
+		std::vector<Variant> variant_;
+		std::vector<Variant> insertion_;
+		bool IsReference(const BlockInstance & instance) const;
+		bool IsUnique(const BlockList & instance) const;
+		Variant MakeVariant(size_t chr, long pos, const std::string & referenceAllele, const std::string & assemblyAllele) const;
+		void SharedBlocks(const BlockList & blockList, BlockList & shared, std::vector<IndexPair> & group) const;
+	};
+}
+
+#endif
@@ -98,6 +98,7 @@ namespace SyntenyFinder
 
 		FilePtr CreateFileWithSA(const std::string & superGenome, const std::string & tempDir)
 		{
+			Profiler::Scope scope("divsufsort");
 			FilePtr posFile(new TempFile(tempDir));
 			std::vector<saidx_t> pos(superGenome.size());
 			divsufsort(reinterpret_cast<const sauchar_t*>(superGenome.c_str()), &pos[0], static_cast<saidx_t>(pos.size()));
@@ -124,6 +125,7 @@ namespace SyntenyFinder
 		{
 			FilePtr lcpFile(new TempFile(tempDir));
 			FilePtr posFile = CreateFileWithSA(superGenome, tempDir);
+			Profiler::Scope scope("lcp");
 			{
 				std::vector<saidx_t> phi(superGenome.size(), 0);
 				FindPhi(phi, posFile);
@@ -157,19 +159,20 @@ namespace SyntenyFinder
 		}		
 	}
 
-	size_t IndexedSequence::EnumerateBifurcationsSArray(const std::vector<std::string> & data, const std::string & tempDir, std::vector<BifurcationInstance> & positiveBif, std::vector<BifurcationInstance> & negativeBif)
+	size_t IndexedSequence::EnumerateBifurcationsSArray(const std::vector<std::string> & data, size_t k, const std::string & tempDir, std::vector<BifurcationInstance> & positiveBif, std::vector<BifurcationInstance> & negativeBif)
 	{
 		positiveBif.clear();
 		negativeBif.clear();
 		Size bifurcationCount = 0;
 		std::vector<size_t> cumSize;
 		std::string superGenome(1, SEPARATION_CHAR);
+		Profiler::Scope build("super-genome");
 		for(size_t chr = 0; chr < data.size(); chr++)
 		{
 			cumSize.push_back(superGenome.size());
 			superGenome += data[chr];
 			superGenome += SEPARATION_CHAR;
-			Flank(superGenome, superGenome.size() - 1 - data[chr].size(), superGenome.size() - 1, k_, SEPARATION_CHAR);
+			Flank(superGenome, superGenome.size() - 1 - data[chr].size(), superGenome.size() - 1, k, SEPARATION_CHAR);
 		}
 
 		for(size_t chr = 0; chr < data.size(); chr++)
@@ -179,13 +182,15 @@ namespace SyntenyFinder
 			std::string::const_reverse_iterator it2 = data[chr].rend();
 			superGenome.insert(superGenome.end(), CFancyIterator(it1, DNASequence::Translate, ' '), CFancyIterator(it2, DNASequence::Translate, ' '));
 			superGenome += SEPARATION_CHAR;
-			Flank(superGenome, superGenome.size() - 1 - data[chr].size(), superGenome.size() - 1, k_, SEPARATION_CHAR);
+			Flank(superGenome, superGenome.size() - 1 - data[chr].size(), superGenome.size() - 1, k, SEPARATION_CHAR);
 		}
 		
+		build.Stop();
 		std::vector<saidx_t> pos;
 		std::vector<saidx_t> lcp;
 		CreateOutDirectory(tempDir);
 		FilePtr posFile = CalculateLCP(superGenome, lcp, tempDir);
+		Profiler::Scope scan("bifurcation scan");
 		CharSet prev;
 		CharSet next;
 		std::vector<BifurcationInstance> * ret[] = {&positiveBif, &negativeBif};
@@ -217,12 +222,12 @@ namespace SyntenyFinder
 					prev.Add(superGenome[pos[match] - 1]);
 				}
 
-				if(pos[match] + k_ < superGenome.size())
+				if(pos[match] + k < superGenome.size())
 				{
-					next.Add(superGenome[pos[match] + k_]);
+					next.Add(superGenome[pos[match] + k]);
 				}
 			}
-			while(++match + start < superGenome.size() && lcp[match + start] >= static_cast<size_t>(k_));
+			while(++match + start < superGenome.size() && lcp[match + start] >= static_cast<size_t>(k));
 
 			if(Bifurcation(prev) || Bifurcation(next))
 			{
@@ -235,9 +240,9 @@ namespace SyntenyFinder
 					DNASequence::Direction strand = chr < data.size() ? DNASequence::positive : DNASequence::negative;
 					size_t pos = suffix - cumSize[chr];
 					chr = chr < data.size() ? chr : chr - data.size();
-					if(pos + k_ <= data[chr].size())
+					if(pos + k <= data[chr].size())
 					{
-						terminal = terminal || superGenome[suffix - 1] == SEPARATION_CHAR || superGenome[suffix + k_] == SEPARATION_CHAR;
+						terminal = terminal || superGenome[suffix - 1] == SEPARATION_CHAR || superGenome[suffix + k] == SEPARATION_CHAR;
 						candidate.push_back(std::make_pair(strand, BifurcationInstance(bifurcationCount, static_cast<Size>(chr), static_cast<Size>(pos))));
 					}
 				}
@@ -257,22 +262,24 @@ namespace SyntenyFinder
 				
 		std::sort(positiveBif.begin(), positiveBif.end());
 		std::sort(negativeBif.begin(), negativeBif.end());
+		Profiler::Count("bifurcations", bifurcationCount);
 		return bifurcationCount;
 	}
 
-	size_t IndexedSequence::EnumerateBifurcationsSArrayInRAM(const std::vector<std::string> & data, std::vector<BifurcationInstance> & positiveBif, std::vector<BifurcationInstance> & negativeBif)
+	size_t IndexedSequence::EnumerateBifurcationsSArrayInRAM(const std::vector<std::string> & data, size_t k, std::vector<BifurcationInstance> & positiveBif, std::vector<BifurcationInstance> & negativeBif)
 	{
 		positiveBif.clear();
 		negativeBif.clear();
 		Size bifurcationCount = 0;
 		std::vector<size_t> cumSize;
 		std::string superGenome(1, SEPARATION_CHAR);
+		Profiler::Scope build("super-genome");
 		for(size_t chr = 0; chr < data.size(); chr++)
 		{
 			cumSize.push_back(superGenome.size());
 			superGenome += data[chr];
 			superGenome += SEPARATION_CHAR;
-			Flank(superGenome, superGenome.size() - 1 - data[chr].size(), superGenome.size() - 1, k_, SEPARATION_CHAR);
+			Flank(superGenome, superGenome.size() - 1 - data[chr].size(), superGenome.size() - 1, k, SEPARATION_CHAR);
 		}
 
 		for(size_t chr = 0; chr < data.size(); chr++)
@@ -282,12 +289,14 @@ namespace SyntenyFinder
 			std::string::const_reverse_iterator it2 = data[chr].rend();
 			superGenome.insert(superGenome.end(), CFancyIterator(it1, DNASequence::Translate, ' '), CFancyIterator(it2, DNASequence::Translate, ' '));
 			superGenome += SEPARATION_CHAR;
-			Flank(superGenome, superGenome.size() - 1 - data[chr].size(), superGenome.size() - 1, k_, SEPARATION_CHAR);
+			Flank(superGenome, superGenome.size() - 1 - data[chr].size(), superGenome.size() - 1, k, SEPARATION_CHAR);
 		}
 
+		build.Stop();
 		std::vector<Size> lcp;
 		std::vector<saidx_t> order(superGenome.size());
 		{
+			Profiler::Scope sorting("divsufsort");
 			std::vector<saidx_t> pos(superGenome.size());
 			divsufsort(reinterpret_cast<const sauchar_t*>(superGenome.c_str()), &order[0], static_cast<saidx_t>(order.size()));
 			for(size_t i = 0; i < order.size(); i++)
@@ -295,9 +304,12 @@ namespace SyntenyFinder
 				pos[order[i]] = static_cast<saidx_t>(i);
 			}
 
+			sorting.Stop();
+			Profiler::Scope height("lcp");
 			GetHeight(superGenome, order, pos, lcp);	
 		}
 
+		Profiler::Scope scan("bifurcation scan");
 		CharSet prev;
 		CharSet next;
 		std::vector<BifurcationInstance> * ret[] = {&positiveBif, &negativeBif};
@@ -320,12 +332,12 @@ namespace SyntenyFinder
 					prev.Add(superGenome[order[end] - 1]);
 				}
 
-				if(order[end] + k_ < superGenome.size())
+				if(order[end] + k < superGenome.size())
 				{
-					next.Add(superGenome[order[end] + k_]);
+					next.Add(superGenome[order[end] + k]);
 				}
 			}
-			while(++end < superGenome.size() && lcp[end] >= k_);
+			while(++end < superGenome.size() && lcp[end] >= k);
 
 			if(Bifurcation(prev) || Bifurcation(next))
 			{
@@ -338,9 +350,9 @@ namespace SyntenyFinder
 					DNASequence::Direction strand = chr < data.size() ? DNASequence::positive : DNASequence::negative;
 					size_t pos = suffix - cumSize[chr];
 					chr = chr < data.size() ? chr : chr - data.size();
-					if(pos + k_ <= data[chr].size())
+					if(pos + k <= data[chr].size())
 					{
-						terminal = terminal || superGenome[suffix - 1] == SEPARATION_CHAR || superGenome[suffix + k_] == SEPARATION_CHAR;
+						terminal = terminal || superGenome[suffix - 1] == SEPARATION_CHAR || superGenome[suffix + k] == SEPARATION_CHAR;
 						candidate.push_back(std::make_pair(strand, BifurcationInstance(bifurcationCount, static_cast<Size>(chr), static_cast<Size>(pos))));
 					}
 				}
@@ -360,6 +372,13 @@ namespace SyntenyFinder
 		
 		std::sort(positiveBif.begin(), positiveBif.end());
 		std::sort(negativeBif.begin(), negativeBif.end());
+		Profiler::Count("bifurcations", bifurcationCount);
 		return bifurcationCount;
 	}
+
+	size_t IndexedSequence::EnumerateVertices(const std::vector<std::string> & record, size_t k)
+	{
+		std::vector<BifurcationInstance> bifurcation[2];
+		return EnumerateBifurcationsSArrayInRAM(record, k, bifurcation[0], bifurcation[1]);
+	}
 }
\ No newline at end of file